@@ -0,0 +1,183 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "benchmark/benchmark.h"
+#include "uci/engine.hpp"
+#include "corpus.hpp"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief When the last callback was entered, and how many have run
+ *
+ */
+std::atomic<int64_t> entered_at{0};
+std::atomic<uint64_t> callbacks_run{0};
+
+/**
+ * @brief Keeps the decoded values alive so the work is not optimised away
+ *
+ */
+int64_t total_time = 0;
+
+void enter_callback()
+{
+    entered_at.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    callbacks_run.fetch_add(1, std::memory_order_release);
+}
+
+void typed_go(chesspp::SearchLimits const &limits)
+{
+    total_time += limits.wtime + limits.btime;
+    enter_callback();
+}
+
+void string_go(std::vector<chesspp::Argument> arguments)
+{
+    // What an engine has to do without typed decoding
+    for (chesspp::Argument const &argument : arguments)
+    {
+        if (argument.value == "wtime" or argument.value == "btime")
+        {
+            total_time += std::stoll(argument.parameters[0]);
+        }
+    }
+    enter_callback();
+}
+
+/**
+ * @brief Measures the time from writing a `go` line into the engine's input
+ *        to its callback being entered
+ *
+ */
+void run_go_latency(benchmark::State &state, bool typed)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        state.SkipWithError("Could not create a pipe");
+        return;
+    }
+
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::Engine engine(fds[0], output);
+    if (typed)
+    {
+        engine.register_go_callback(typed_go);
+    }
+    else
+    {
+        engine.register_command("go", string_go);
+    }
+    std::thread engine_thread(&chesspp::Engine::start, &engine);
+
+    std::string const line =
+        "go wtime 298765 btime 301234 winc 2000 binc 2000 movestogo 38 searchmoves e2e4 d2d4 g1f3\n";
+    for (auto _ : state)
+    {
+        uint64_t const before = callbacks_run.load(std::memory_order_relaxed);
+        Clock::time_point const start = Clock::now();
+        if (write(fds[1], line.data(), line.size()) != static_cast<ssize_t>(line.size()))
+        {
+            state.SkipWithError("Could not write to the pipe");
+            break;
+        }
+        while (callbacks_run.load(std::memory_order_acquire) == before)
+        {
+        }
+        Clock::time_point const entered(Clock::duration(entered_at.load(std::memory_order_relaxed)));
+        state.SetIterationTime(std::chrono::duration<double>(entered - start).count());
+    }
+
+    close(fds[1]);
+    engine_thread.join();
+    close(fds[0]);
+    benchmark::DoNotOptimize(total_time);
+}
+
+void go_latency_typed(benchmark::State &state)
+{
+    run_go_latency(state, true);
+}
+BENCHMARK(go_latency_typed)->UseManualTime()->Unit(benchmark::kMicrosecond);
+
+void go_latency_strings(benchmark::State &state)
+{
+    run_go_latency(state, false);
+}
+BENCHMARK(go_latency_strings)->UseManualTime()->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Feeds everything the GUI sent in the corpus to an engine and runs
+ *        it until `quit`, with a callback on every command. Measures line-in
+ *        to callback throughput through the whole pipeline: reading,
+ *        tokenising, parsing, the queue and dispatch.
+ *
+ */
+void corpus_replay(benchmark::State &state)
+{
+    bench::Corpus const &corpus = bench::corpus();
+    if (not corpus.loaded)
+    {
+        state.SkipWithError("Could not load the corpus");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        int fds[2];
+        if (pipe(fds) != 0)
+        {
+            state.SkipWithError("Could not create a pipe");
+            return;
+        }
+
+        chesspp::StringSink sink;
+        chesspp::OutputWriter output(sink);
+        chesspp::Engine engine(fds[0], output);
+        size_t run = 0;
+        for (char const *name : {"uci", "setoption", "isready", "ucinewgame", "position", "go",
+                                 "stop", "ponderhit", "quit"})
+        {
+            engine.register_command(name, [&run](chesspp::ArgumentSpan) { run++; });
+        }
+
+        // The corpus is larger than a pipe's buffer, so write it from another
+        // thread while the engine reads
+        std::thread writer([&corpus, fd = fds[1]]() {
+            std::string const &text = corpus.to_engine_text;
+            for (size_t written = 0; written < text.size();)
+            {
+                ssize_t const count = write(fd, text.data() + written, text.size() - written);
+                if (count <= 0)
+                {
+                    break;
+                }
+                written += static_cast<size_t>(count);
+            }
+            close(fd);
+        });
+        engine.start();
+        writer.join();
+        close(fds[0]);
+
+        if (run != corpus.to_engine.size())
+        {
+            state.SkipWithError("Not every command reached its callback");
+            return;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * corpus.to_engine.size());
+    state.SetBytesProcessed(state.iterations() * corpus.to_engine_text.size());
+}
+BENCHMARK(corpus_replay)->Unit(benchmark::kMicrosecond);
+} // namespace
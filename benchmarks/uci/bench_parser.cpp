@@ -0,0 +1,126 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "uci/parser.hpp"
+#include "corpus.hpp"
+
+namespace
+{
+/**
+ * @brief The moves of a real game (Kasparov - Topalov, Wijk aan Zee 1999).
+ *        Long move lists are built by repeating it.
+ *
+ */
+std::vector<std::string> const game = {
+    "e2e4", "d7d6", "d2d4", "g8f6", "b1c3", "g7g6", "c1e3", "f8g7", "d1d2",
+    "c7c6", "f2f3", "b7b5", "g1e2", "b8d7", "e3h6", "g7h6", "d2h6", "c8b7",
+    "a2a3", "e7e5", "e1c1", "d8e7", "c1b1", "a7a6", "e2c1", "e8c8", "c1b3",
+    "e5d4", "d1d4", "c6c5", "d4d1", "d7b6", "g2g3", "c8b8", "b3a5", "b7a8",
+    "f1h3", "d6d5", "h6f4", "b8a7", "h1e1", "d5d4", "c3d5", "b6d5", "e4d5",
+    "e7d6", "d1d4", "c5d4", "e1e7", "a7b6", "f4d4", "b6a5", "b2b4", "a5a4",
+    "d4c3", "d6d5", "e7a7", "a8b7", "a7b7", "d5c4", "c3f6", "a4a3", "f6a6",
+    "a3b4", "c2c3", "b4c3", "a6a1", "c3d2", "a1b2", "d2d1", "h3f1", "d8d2",
+    "b7d7", "d2d7", "f1c4", "b5c4", "b2h8", "d7d3", "h8a8", "c4c3", "a8a4",
+    "d1e1", "f3f4", "f7f5", "b1c1", "d3d2", "a4a7"};
+
+/**
+ * @brief Builds a `position startpos moves ...` line with the given number of
+ *        moves, separated by `separator`.
+ *
+ */
+std::string position_line(size_t num_moves, std::string const &separator)
+{
+    std::string line = "position" + separator + "startpos" + separator + "moves";
+    for (size_t i = 0; i < num_moves; i++)
+    {
+        line += separator + game[i % game.size()];
+    }
+    return line + "\n";
+}
+
+void run_tokeniser(benchmark::State &state, chesspp::TokeniserPath path,
+                   std::string const &separator)
+{
+    if (not chesspp::Parser::supports_tokeniser_path(path))
+    {
+        state.SkipWithError("Tokeniser path not supported by this CPU");
+        return;
+    }
+
+    std::string const line = position_line(state.range(0), separator);
+    std::vector<std::string_view> tokens;
+    for (auto _ : state)
+    {
+        chesspp::Parser::tokenise(line, tokens, path);
+        benchmark::DoNotOptimize(tokens.data());
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+} // namespace
+
+BENCHMARK_CAPTURE(run_tokeniser, scalar, chesspp::TokeniserPath::scalar, " ")
+    ->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK_CAPTURE(run_tokeniser, sse2, chesspp::TokeniserPath::sse2, " ")
+    ->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK_CAPTURE(run_tokeniser, avx2, chesspp::TokeniserPath::avx2, " ")
+    ->Arg(10)->Arg(100)->Arg(1000);
+
+// GUIs are allowed to send arbitrary whitespace between tokens
+BENCHMARK_CAPTURE(run_tokeniser, scalar_padded, chesspp::TokeniserPath::scalar, " \t  ")
+    ->Arg(1000);
+BENCHMARK_CAPTURE(run_tokeniser, sse2_padded, chesspp::TokeniserPath::sse2, " \t  ")
+    ->Arg(1000);
+BENCHMARK_CAPTURE(run_tokeniser, avx2_padded, chesspp::TokeniserPath::avx2, " \t  ")
+    ->Arg(1000);
+
+static void run_tokeniser_strings(benchmark::State &state)
+{
+    std::string const line = position_line(state.range(0), " ");
+    for (auto _ : state)
+    {
+        std::vector<std::string> tokens = chesspp::Parser::tokenise(line);
+        benchmark::DoNotOptimize(tokens.data());
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+BENCHMARK(run_tokeniser_strings)->Arg(10)->Arg(100)->Arg(1000);
+
+/**
+ * @brief Tokenises every line of the recorded corpus, in both directions
+ *
+ */
+static void run_tokeniser_corpus(benchmark::State &state)
+{
+    bench::Corpus const &corpus = bench::corpus();
+    if (not corpus.loaded)
+    {
+        state.SkipWithError("Could not load the corpus");
+        return;
+    }
+
+    size_t bytes = 0;
+    for (std::vector<std::string> const *direction : {&corpus.to_engine, &corpus.to_gui})
+    {
+        for (std::string const &line : *direction)
+        {
+            bytes += line.size() + 1;
+        }
+    }
+
+    std::vector<std::string_view> tokens;
+    for (auto _ : state)
+    {
+        for (std::vector<std::string> const *direction : {&corpus.to_engine, &corpus.to_gui})
+        {
+            for (std::string const &line : *direction)
+            {
+                chesspp::Parser::tokenise(line, tokens);
+                benchmark::DoNotOptimize(tokens.data());
+            }
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(run_tokeniser_corpus)->Unit(benchmark::kMicrosecond);
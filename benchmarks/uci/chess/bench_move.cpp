@@ -0,0 +1,85 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "uci/chess/board.hpp"
+#include "uci/chess/move.hpp"
+
+namespace
+{
+/**
+ * @brief A million random moves in long algebraic notation, every 16th one a
+ *        promotion
+ *
+ */
+std::vector<std::string> const &random_moves()
+{
+    static std::vector<std::string> const moves = [] {
+        std::mt19937 random(1999);
+        std::vector<std::string> moves;
+        for (int i = 0; i < 1 << 20; i++)
+        {
+            chesspp::Move const move(
+                static_cast<chesspp::Square>(random() % 64),
+                static_cast<chesspp::Square>(random() % 64),
+                i % 16 == 0 ? chesspp::Promotion::queen : chesspp::Promotion::none);
+            moves.push_back(move.to_uci());
+        }
+        return moves;
+    }();
+    return moves;
+}
+
+void move_decode(benchmark::State &state)
+{
+    std::vector<std::string> const &moves = random_moves();
+    for (auto _ : state)
+    {
+        uint32_t checksum = 0;
+        for (std::string const &text : moves)
+        {
+            chesspp::Move move;
+            chesspp::Move::from_uci(text, move);
+            checksum += move.raw();
+        }
+        benchmark::DoNotOptimize(checksum);
+    }
+    state.SetItemsProcessed(state.iterations() * moves.size());
+}
+BENCHMARK(move_decode)->Unit(benchmark::kMillisecond);
+
+void move_encode(benchmark::State &state)
+{
+    std::vector<chesspp::Move> moves;
+    for (std::string const &text : random_moves())
+    {
+        chesspp::Move::from_uci(text, moves.emplace_back());
+    }
+
+    char text[chesspp::Move::max_uci_length];
+    for (auto _ : state)
+    {
+        for (chesspp::Move const move : moves)
+        {
+            benchmark::DoNotOptimize(move.to_uci(text));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * moves.size());
+}
+BENCHMARK(move_encode)->Unit(benchmark::kMillisecond);
+
+void fen_parse(benchmark::State &state)
+{
+    chesspp::Board board;
+    for (auto _ : state)
+    {
+        chesspp::parse_fen("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4", board);
+        benchmark::DoNotOptimize(board);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(fen_parse);
+} // namespace
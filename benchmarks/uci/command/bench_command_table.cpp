@@ -0,0 +1,119 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "uci/command/command_table.hpp"
+#include "uci/command/grammar.hpp"
+
+namespace
+{
+/**
+ * @brief The names looked up, in the mix a game produces: mostly `position`
+ *        and `go`, plus the occasional other command and an unknown token
+ *
+ */
+std::vector<std::string> const lookups = {
+    "position", "go", "isready", "position", "go", "stop", "ponderhit", "joho",
+    "position", "go", "setoption", "ucinewgame", "position", "go", "quit", "debug"};
+
+/**
+ * @brief The standard commands an engine accepts followed by `num_custom`
+ *        custom commands
+ *
+ */
+std::vector<chesspp::Command> make_commands(int64_t num_custom)
+{
+    std::vector<chesspp::Command> commands = {
+        chesspp::grammar::uci.to_command(),
+        chesspp::grammar::debug.to_command(),
+        chesspp::grammar::isready.to_command(),
+        chesspp::grammar::setoption.to_command(),
+        chesspp::grammar::register_.to_command(),
+        chesspp::grammar::ucinewgame.to_command(),
+        chesspp::grammar::position.to_command(),
+        chesspp::grammar::go.to_command(),
+        chesspp::grammar::stop.to_command(),
+        chesspp::grammar::ponderhit.to_command(),
+        chesspp::grammar::quit.to_command(),
+    };
+    for (int64_t i = 0; i < num_custom; i++)
+    {
+        commands.emplace_back("custom" + std::to_string(i), std::vector<chesspp::ArgumentDefinition>());
+    }
+    return commands;
+}
+
+/**
+ * @brief Finds each name in `lookups` in a CommandTable
+ *
+ */
+void command_table_find(benchmark::State &state)
+{
+    chesspp::CommandTable table;
+    for (chesspp::Command &command : make_commands(state.range(0)))
+    {
+        table.add(command);
+    }
+
+    for (auto _ : state)
+    {
+        for (std::string const &name : lookups)
+        {
+            benchmark::DoNotOptimize(table.find(name));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * lookups.size());
+}
+BENCHMARK(command_table_find)->Arg(0)->Arg(16)->Arg(256)->Arg(4096);
+
+/**
+ * @brief Finds a custom command in a CommandTable, which takes the overflow
+ *        path
+ *
+ */
+void command_table_find_custom(benchmark::State &state)
+{
+    chesspp::CommandTable table;
+    for (chesspp::Command &command : make_commands(state.range(0)))
+    {
+        table.add(command);
+    }
+    std::string const name = "custom" + std::to_string(state.range(0) / 2);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(table.find(name));
+    }
+}
+BENCHMARK(command_table_find_custom)->Arg(16)->Arg(256)->Arg(4096);
+
+/**
+ * @brief Finds each name in `lookups` by scanning a vector of commands, the
+ *        way commands used to be found
+ *
+ */
+void linear_scan_find(benchmark::State &state)
+{
+    std::vector<chesspp::Command> const commands = make_commands(state.range(0));
+
+    for (auto _ : state)
+    {
+        for (std::string const &name : lookups)
+        {
+            chesspp::Command const *found = nullptr;
+            for (chesspp::Command const &command : commands)
+            {
+                if (command.get_name() == name)
+                {
+                    found = &command;
+                    break;
+                }
+            }
+            benchmark::DoNotOptimize(found);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * lookups.size());
+}
+BENCHMARK(linear_scan_find)->Arg(0)->Arg(16)->Arg(256)->Arg(4096);
+} // namespace
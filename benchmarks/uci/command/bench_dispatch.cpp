@@ -0,0 +1,84 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "uci/command/grammar.hpp"
+#include "uci/parser.hpp"
+
+namespace
+{
+/**
+ * @brief A `position` line with 40 moves and a `go` line with a full clock
+ *
+ */
+std::string const position_line =
+    "startpos moves e2e4 d7d6 d2d4 g8f6 b1c3 g7g6 c1e3 f8g7 d1d2 c7c6 f2f3 b7b5 "
+    "g1e2 b8d7 e3h6 g7h6 d2h6 c8b7 a2a3 e7e5 e1c1 d8e7 c1b1 a7a6 e2c1 e8c8 "
+    "c1b3 e5d4 d1d4 c6c5 d4d1 d7b6 g2g3 c8b8 b3a5 b7a8 f1h3 d6d5 h6f4 b8a7";
+std::string const go_line = "wtime 298765 btime 301234 winc 2000 binc 2000 movestogo 38";
+
+size_t legacy_sum = 0;
+
+void legacy_callback(std::vector<chesspp::Argument> arguments)
+{
+    legacy_sum += arguments.size();
+}
+
+/**
+ * @brief Dispatches a parsed line to a callback over and over. `legacy`
+ *        callbacks take owning copies of the arguments.
+ *
+ */
+void run_dispatch(
+    benchmark::State &state, chesspp::Command command, std::string const &line, bool legacy)
+{
+    size_t sum = 0;
+    if (legacy)
+    {
+        command.attach_callback(legacy_callback);
+    }
+    else
+    {
+        command.attach_callback([&sum](chesspp::ArgumentSpan arguments) {
+            sum += arguments.size();
+        });
+    }
+
+    std::vector<std::string_view> tokens;
+    std::vector<chesspp::ArgumentView> arguments;
+    chesspp::Parser::tokenise(line, tokens);
+    command.parse_arguments(tokens, arguments);
+
+    for (auto _ : state)
+    {
+        command.run(arguments);
+    }
+    benchmark::DoNotOptimize(sum);
+    benchmark::DoNotOptimize(legacy_sum);
+}
+
+void dispatch_position_span(benchmark::State &state)
+{
+    run_dispatch(state, chesspp::grammar::position.to_command(), position_line, false);
+}
+BENCHMARK(dispatch_position_span);
+
+void dispatch_position_vector_copy(benchmark::State &state)
+{
+    run_dispatch(state, chesspp::grammar::position.to_command(), position_line, true);
+}
+BENCHMARK(dispatch_position_vector_copy);
+
+void dispatch_go_span(benchmark::State &state)
+{
+    run_dispatch(state, chesspp::grammar::go.to_command(), go_line, false);
+}
+BENCHMARK(dispatch_go_span);
+
+void dispatch_go_vector_copy(benchmark::State &state)
+{
+    run_dispatch(state, chesspp::grammar::go.to_command(), go_line, true);
+}
+BENCHMARK(dispatch_go_vector_copy);
+} // namespace
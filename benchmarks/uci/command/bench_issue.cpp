@@ -0,0 +1,122 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "uci/command/grammar.hpp"
+#include "uci/io/output_writer.hpp"
+#include "uci/parser.hpp"
+#include "../corpus.hpp"
+
+namespace
+{
+/**
+ * @brief Counts what it is given and throws it away, so only the cost of
+ *        checking and formatting is measured
+ *
+ */
+class NullSink : public chesspp::OutputSink
+{
+public:
+    size_t bytes = 0;
+
+    void write(std::string_view data) override
+    {
+        bytes += data.size();
+    }
+};
+
+/**
+ * @brief Issues one line from the corpus over and over
+ *
+ */
+void run_issue(benchmark::State &state, chesspp::Command const &command, std::string const &line)
+{
+    if (line.empty())
+    {
+        state.SkipWithError("Line not found in the corpus");
+        return;
+    }
+    std::vector<std::string> arguments = chesspp::Parser::tokenise(line);
+    arguments.erase(arguments.begin());
+
+    NullSink sink;
+    chesspp::OutputWriter output(sink);
+    for (auto _ : state)
+    {
+        command.issue(arguments, output);
+    }
+    output.flush();
+    benchmark::DoNotOptimize(sink.bytes);
+    state.SetBytesProcessed(state.iterations() * (line.size() + 1));
+}
+
+void issue_bestmove(benchmark::State &state)
+{
+    run_issue(state, chesspp::grammar::bestmove.to_command(), bench::find_line("bestmove"));
+}
+BENCHMARK(issue_bestmove);
+
+void issue_info(benchmark::State &state)
+{
+    run_issue(state, chesspp::grammar::info.to_command(), bench::find_line("info depth 20"));
+}
+BENCHMARK(issue_info);
+
+/**
+ * @brief Issues everything the engine sent in the corpus
+ *
+ */
+void issue_corpus(benchmark::State &state)
+{
+    bench::Corpus const &corpus = bench::corpus();
+    if (not corpus.loaded)
+    {
+        state.SkipWithError("Could not load the corpus");
+        return;
+    }
+
+    std::vector<chesspp::Command> const commands = {
+        chesspp::grammar::id.to_command(),
+        chesspp::grammar::uciok.to_command(),
+        chesspp::grammar::readyok.to_command(),
+        chesspp::grammar::bestmove.to_command(),
+        chesspp::grammar::info.to_command(),
+        chesspp::grammar::option.to_command(),
+    };
+
+    // Split each line into its command and arguments up front, as an engine
+    // would have them
+    std::vector<chesspp::Command const *> line_commands;
+    std::vector<std::vector<std::string>> line_arguments;
+    size_t bytes = 0;
+    for (std::string const &line : corpus.to_gui)
+    {
+        std::vector<std::string> tokens = chesspp::Parser::tokenise(line);
+        for (chesspp::Command const &command : commands)
+        {
+            if (command.get_name() == tokens[0])
+            {
+                line_commands.push_back(&command);
+                line_arguments.emplace_back(tokens.begin() + 1, tokens.end());
+                bytes += line.size() + 1;
+            }
+        }
+    }
+
+    NullSink sink;
+    chesspp::OutputWriter output(sink);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < line_commands.size(); i++)
+        {
+            line_commands[i]->issue(line_arguments[i], output);
+        }
+    }
+    output.flush();
+    benchmark::DoNotOptimize(sink.bytes);
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.SetItemsProcessed(state.iterations() * line_commands.size());
+}
+BENCHMARK(issue_corpus)->Unit(benchmark::kMicrosecond);
+} // namespace
@@ -0,0 +1,258 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "uci/command/command_table.hpp"
+#include "uci/command/grammar.hpp"
+#include "uci/parser.hpp"
+#include "../corpus.hpp"
+
+namespace
+{
+/**
+ * @brief Every standard command, to look up the commands in the corpus
+ *
+ */
+chesspp::CommandTable make_standard_commands()
+{
+    chesspp::CommandTable commands;
+    for (chesspp::Command command : {
+             chesspp::grammar::uci.to_command(),
+             chesspp::grammar::debug.to_command(),
+             chesspp::grammar::isready.to_command(),
+             chesspp::grammar::setoption.to_command(),
+             chesspp::grammar::register_.to_command(),
+             chesspp::grammar::ucinewgame.to_command(),
+             chesspp::grammar::position.to_command(),
+             chesspp::grammar::go.to_command(),
+             chesspp::grammar::stop.to_command(),
+             chesspp::grammar::ponderhit.to_command(),
+             chesspp::grammar::quit.to_command(),
+             chesspp::grammar::id.to_command(),
+             chesspp::grammar::uciok.to_command(),
+             chesspp::grammar::readyok.to_command(),
+             chesspp::grammar::bestmove.to_command(),
+             chesspp::grammar::copyprotection.to_command(),
+             chesspp::grammar::registration.to_command(),
+             chesspp::grammar::info.to_command(),
+             chesspp::grammar::option.to_command(),
+         })
+    {
+        commands.add(std::move(command));
+    }
+    return commands;
+}
+
+/**
+ * @brief Get the argument tokens of a line from the corpus, ie. every token
+ *        after the command name
+ *
+ */
+bool corpus_arguments(
+    benchmark::State &state,
+    std::string const &line,
+    std::vector<std::string_view> &tokens)
+{
+    if (line.empty())
+    {
+        state.SkipWithError("Line not found in the corpus");
+        return false;
+    }
+    chesspp::Parser::tokenise(line, tokens);
+    tokens.erase(tokens.begin());
+    return true;
+}
+
+/**
+ * @brief Parses the arguments of a line into views with a runtime Command
+ *
+ */
+void run_parse_views(benchmark::State &state, chesspp::Command const &command, std::string const &line)
+{
+    std::vector<std::string_view> tokens;
+    if (not corpus_arguments(state, line, tokens))
+    {
+        return;
+    }
+
+    std::vector<chesspp::ArgumentView> arguments;
+    for (auto _ : state)
+    {
+        command.parse_arguments(tokens, arguments);
+        benchmark::DoNotOptimize(arguments.data());
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+
+/**
+ * @brief Parses the arguments of a line into views with a StaticCommand
+ *
+ */
+template <auto const &Grammar>
+void run_parse_static(benchmark::State &state, std::string const &line)
+{
+    std::vector<std::string_view> tokens;
+    if (not corpus_arguments(state, line, tokens))
+    {
+        return;
+    }
+
+    std::vector<chesspp::ArgumentView> arguments;
+    for (auto _ : state)
+    {
+        chesspp::StaticCommand<Grammar>::parse_arguments(tokens, arguments);
+        benchmark::DoNotOptimize(arguments.data());
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+
+/**
+ * @brief Parses the arguments of a line from strings into owning Arguments
+ *
+ */
+void run_parse_strings(benchmark::State &state, chesspp::Command const &command, std::string const &line)
+{
+    std::vector<std::string_view> tokens;
+    if (not corpus_arguments(state, line, tokens))
+    {
+        return;
+    }
+
+    std::vector<std::string> const strings(tokens.begin(), tokens.end());
+    for (auto _ : state)
+    {
+        std::vector<chesspp::Argument> arguments = command.parse_arguments(strings);
+        benchmark::DoNotOptimize(arguments.data());
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+
+/**
+ * @brief The lines parsed: a `go` with a full clock, a full `info` line and
+ *        the longest `position`
+ *
+ */
+std::string const &go_line()
+{
+    return bench::find_line("go wtime");
+}
+
+std::string const &info_line()
+{
+    return bench::find_line("info depth 20");
+}
+
+std::string const &position_line()
+{
+    std::string const *longest = &bench::find_line("position");
+    for (std::string const &line : bench::corpus().to_engine)
+    {
+        if (line.compare(0, 8, "position") == 0 and line.size() > longest->size())
+        {
+            longest = &line;
+        }
+    }
+    return *longest;
+}
+
+void parse_arguments_go_views(benchmark::State &state)
+{
+    run_parse_views(state, chesspp::grammar::go.to_command(), go_line());
+}
+BENCHMARK(parse_arguments_go_views);
+
+void parse_arguments_go_static(benchmark::State &state)
+{
+    run_parse_static<chesspp::grammar::go>(state, go_line());
+}
+BENCHMARK(parse_arguments_go_static);
+
+void parse_arguments_go_strings(benchmark::State &state)
+{
+    run_parse_strings(state, chesspp::grammar::go.to_command(), go_line());
+}
+BENCHMARK(parse_arguments_go_strings);
+
+void parse_arguments_info_views(benchmark::State &state)
+{
+    run_parse_views(state, chesspp::grammar::info.to_command(), info_line());
+}
+BENCHMARK(parse_arguments_info_views);
+
+void parse_arguments_info_static(benchmark::State &state)
+{
+    run_parse_static<chesspp::grammar::info>(state, info_line());
+}
+BENCHMARK(parse_arguments_info_static);
+
+void parse_arguments_info_strings(benchmark::State &state)
+{
+    run_parse_strings(state, chesspp::grammar::info.to_command(), info_line());
+}
+BENCHMARK(parse_arguments_info_strings);
+
+void parse_arguments_position_views(benchmark::State &state)
+{
+    run_parse_views(state, chesspp::grammar::position.to_command(), position_line());
+}
+BENCHMARK(parse_arguments_position_views);
+
+void parse_arguments_position_static(benchmark::State &state)
+{
+    run_parse_static<chesspp::grammar::position>(state, position_line());
+}
+BENCHMARK(parse_arguments_position_static);
+
+void parse_arguments_position_strings(benchmark::State &state)
+{
+    run_parse_strings(state, chesspp::grammar::position.to_command(), position_line());
+}
+BENCHMARK(parse_arguments_position_strings);
+
+/**
+ * @brief Tokenises, looks up and parses every line of the corpus, in both
+ *        directions
+ *
+ */
+void parse_corpus(benchmark::State &state)
+{
+    bench::Corpus const &corpus = bench::corpus();
+    if (not corpus.loaded)
+    {
+        state.SkipWithError("Could not load the corpus");
+        return;
+    }
+
+    chesspp::CommandTable const commands = make_standard_commands();
+    std::vector<std::string_view> tokens;
+    std::vector<chesspp::ArgumentView> arguments;
+    size_t bytes = 0;
+    size_t lines = 0;
+    for (std::vector<std::string> const *direction : {&corpus.to_engine, &corpus.to_gui})
+    {
+        for (std::string const &line : *direction)
+        {
+            bytes += line.size() + 1;
+            lines++;
+        }
+    }
+
+    for (auto _ : state)
+    {
+        for (std::vector<std::string> const *direction : {&corpus.to_engine, &corpus.to_gui})
+        {
+            for (std::string const &line : *direction)
+            {
+                chesspp::Parser::tokenise(line, tokens);
+                chesspp::Command const *command = commands.find(tokens[0]);
+                benchmark::DoNotOptimize(
+                    command->try_parse_arguments(chesspp::TokenSpan(tokens).subspan(1), arguments));
+            }
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.SetItemsProcessed(state.iterations() * lines);
+}
+BENCHMARK(parse_corpus)->Unit(benchmark::kMicrosecond);
+} // namespace
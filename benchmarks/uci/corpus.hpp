@@ -0,0 +1,101 @@
+/**
+ * @file corpus.hpp
+ * @brief Loads the recorded GUI to engine traffic the benchmarks replay
+ *
+ */
+
+#ifndef BENCHMARKS_UCI_CORPUS_H
+#define BENCHMARKS_UCI_CORPUS_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+/**
+ * @brief One recorded session, split by direction. Lines have no prefix and
+ *        no newline.
+ *
+ * The file has one line per command, prefixed with "> " if the GUI sent it
+ * to the engine and "< " if the engine sent it to the GUI.
+ */
+struct Corpus
+{
+    /**
+     * @brief The lines the GUI sent, in order
+     *
+     */
+    std::vector<std::string> to_engine;
+
+    /**
+     * @brief The lines the engine sent, in order
+     *
+     */
+    std::vector<std::string> to_gui;
+
+    /**
+     * @brief `to_engine` joined into the text the engine read, one line each
+     *
+     */
+    std::string to_engine_text;
+
+    /**
+     * @brief Whether the file could be read
+     *
+     */
+    bool loaded = false;
+};
+
+/**
+ * @brief Get the corpus at CHESSPP_BENCH_CORPUS, loaded on first use
+ *
+ */
+inline Corpus const &corpus()
+{
+    static Corpus const instance = []() {
+        Corpus corpus;
+        std::ifstream file(CHESSPP_BENCH_CORPUS);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.compare(0, 2, "> ") == 0)
+            {
+                corpus.to_engine.push_back(line.substr(2));
+                corpus.to_engine_text += corpus.to_engine.back() + "\n";
+            }
+            else if (line.compare(0, 2, "< ") == 0)
+            {
+                corpus.to_gui.push_back(line.substr(2));
+            }
+        }
+        corpus.loaded = not corpus.to_engine.empty();
+        return corpus;
+    }();
+    return instance;
+}
+
+/**
+ * @brief Get the first line sent in either direction that starts with
+ *        `prefix` and is at least `min_size` long, or an empty string
+ *
+ */
+inline std::string const &find_line(std::string const &prefix, size_t min_size = 0)
+{
+    static std::string const none;
+    for (std::vector<std::string> const *lines : {&corpus().to_engine, &corpus().to_gui})
+    {
+        for (std::string const &line : *lines)
+        {
+            if (line.compare(0, prefix.size(), prefix) == 0 and line.size() >= min_size)
+            {
+                return line;
+            }
+        }
+    }
+    return none;
+}
+
+} // namespace bench
+
+#endif
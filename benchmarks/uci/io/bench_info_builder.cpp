@@ -0,0 +1,71 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "uci/command/grammar.hpp"
+#include "uci/io/info_builder.hpp"
+
+namespace
+{
+/**
+ * @brief Throws away everything written to it
+ *
+ */
+class NullSink : public chesspp::OutputSink
+{
+public:
+    void write(std::string_view data) override
+    {
+        benchmark::DoNotOptimize(data.data());
+    }
+};
+
+std::vector<std::string> const pv = {
+    "e2e4", "e7e5", "g1f3", "b8c6", "f1b5", "a7a6", "b5a4", "g8f6", "e1g1", "f8e7"};
+} // namespace
+
+static void info_issue(benchmark::State &state)
+{
+    NullSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::Command const info = chesspp::grammar::info.to_command();
+
+    int depth = 0;
+    for (auto _ : state)
+    {
+        // What an engine has to do today: stringify every number and have the
+        // command re-validate the line.
+        std::vector<std::string> arguments = {
+            "depth", std::to_string(depth), "seldepth", std::to_string(depth + 8),
+            "score", "cp", std::to_string(depth - 20),
+            "nodes", std::to_string(1234567ull * depth), "nps", std::to_string(2500000),
+            "time", std::to_string(40 * depth), "pv"};
+        arguments.insert(arguments.end(), pv.begin(), pv.end());
+        info.issue(arguments, output);
+        depth = (depth + 1) % 64;
+    }
+}
+BENCHMARK(info_issue);
+
+static void info_builder(benchmark::State &state)
+{
+    NullSink sink;
+    chesspp::OutputWriter output(sink);
+
+    int depth = 0;
+    for (auto _ : state)
+    {
+        chesspp::info(output)
+            .depth(depth)
+            .seldepth(depth + 8)
+            .score_cp(depth - 20)
+            .nodes(1234567ull * depth)
+            .nps(2500000)
+            .time(40 * depth)
+            .pv(pv)
+            .send();
+        depth = (depth + 1) % 64;
+    }
+}
+BENCHMARK(info_builder);
@@ -0,0 +1,234 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <unistd.h>
+
+#include "benchmark/benchmark.h"
+#include "uci/io/line_reader.hpp"
+#include "uci/io/output_writer.hpp"
+#include "uci/io/shared_ring.hpp"
+#include "uci/io/transport.hpp"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief A typical line from a search in progress
+ *
+ */
+constexpr std::string_view info_line =
+    "info depth 24 seldepth 31 multipv 1 score cp 34 nodes 48213377 nps 2410668 hashfull 512 "
+    "tbhits 0 time 20000 pv e2e4 e7e5 g1f3 b8c6 f1b5 a7a6 b5a4 g8f6 e1g1 f8e7\n";
+
+/**
+ * @brief Both directions between the interface and the engine, over pipes
+ *        or a SharedChannel
+ *
+ */
+class Link
+{
+private:
+    int to_engine[2] = {-1, -1};
+    int to_interface[2] = {-1, -1};
+    chesspp::SharedChannel channel;
+    std::unique_ptr<chesspp::InputSource> engine_source;
+    std::unique_ptr<chesspp::InputSource> interface_source;
+    std::unique_ptr<chesspp::OutputSink> engine_sink;
+    std::unique_ptr<chesspp::OutputSink> interface_sink;
+
+public:
+    explicit Link(bool shared)
+    {
+        if (shared)
+        {
+            channel.create();
+            engine_source = std::make_unique<chesspp::RingSource>(channel.to_engine());
+            interface_source = std::make_unique<chesspp::RingSource>(channel.to_interface());
+            engine_sink = std::make_unique<chesspp::RingSink>(channel.to_interface());
+            interface_sink = std::make_unique<chesspp::RingSink>(channel.to_engine());
+        }
+        else if (pipe(to_engine) == 0 and pipe(to_interface) == 0)
+        {
+            engine_source = std::make_unique<chesspp::FdSource>(to_engine[0]);
+            interface_source = std::make_unique<chesspp::FdSource>(to_interface[0]);
+            engine_sink = std::make_unique<chesspp::FdSink>(to_interface[1]);
+            interface_sink = std::make_unique<chesspp::FdSink>(to_engine[1]);
+        }
+    }
+
+    ~Link()
+    {
+        for (int const fd : {to_engine[0], to_engine[1], to_interface[0], to_interface[1]})
+        {
+            if (fd != -1)
+            {
+                close(fd);
+            }
+        }
+    }
+
+    bool is_open() const
+    {
+        return engine_source != nullptr;
+    }
+
+    /**
+     * @brief Ends the engine's output, so the interface reads the end of
+     *        the input
+     *
+     */
+    void close_engine_output()
+    {
+        if (channel.is_open())
+        {
+            channel.to_interface().close();
+        }
+        else
+        {
+            close(to_interface[1]);
+            to_interface[1] = -1;
+        }
+    }
+
+    chesspp::InputSource &engine_input()
+    {
+        return *engine_source;
+    }
+
+    chesspp::InputSource &interface_input()
+    {
+        return *interface_source;
+    }
+
+    chesspp::OutputSink &engine_output()
+    {
+        return *engine_sink;
+    }
+
+    chesspp::OutputSink &interface_output()
+    {
+        return *interface_sink;
+    }
+};
+
+/**
+ * @brief Streams info lines from an engine thread to the interface through
+ *        an OutputWriter, the way a search reports, and counts the lines
+ *        the interface reads
+ *
+ */
+void run_info_stream(benchmark::State &state, bool shared)
+{
+    int64_t const lines = 100000;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Link link(shared);
+        if (not link.is_open())
+        {
+            state.SkipWithError("Could not create the link");
+            return;
+        }
+        state.ResumeTiming();
+
+        std::thread engine([&link, lines]() {
+            chesspp::OutputWriter output(link.engine_output());
+            for (int64_t i = 0; i < lines; i++)
+            {
+                chesspp::OutputWriter::Line line = output.begin_line("info");
+                line.append(info_line.substr(4, info_line.size() - 5));
+                line.finish();
+            }
+            output.flush();
+            link.close_engine_output();
+        });
+
+        chesspp::LineReader reader(link.interface_input());
+        std::string_view line;
+        int64_t read = 0;
+        while (reader.next_line(line))
+        {
+            read++;
+        }
+        engine.join();
+        if (read != lines)
+        {
+            state.SkipWithError("Lines went missing");
+            return;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * lines);
+    state.SetBytesProcessed(state.iterations() * lines * static_cast<int64_t>(info_line.size()));
+}
+
+void info_stream_pipe(benchmark::State &state)
+{
+    run_info_stream(state, false);
+}
+BENCHMARK(info_stream_pipe)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+void info_stream_shared_memory(benchmark::State &state)
+{
+    run_info_stream(state, true);
+}
+BENCHMARK(info_stream_shared_memory)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Measures the time from the interface sending `isready` to it
+ *        reading `readyok`, with the engine asleep waiting for input
+ *        in between. Half of it is one wake-up.
+ *
+ */
+void run_round_trip(benchmark::State &state, bool shared)
+{
+    Link link(shared);
+    if (not link.is_open())
+    {
+        state.SkipWithError("Could not create the link");
+        return;
+    }
+
+    std::thread engine([&link]() {
+        chesspp::LineReader reader(link.engine_input());
+        std::string_view line;
+        while (reader.next_line(line) and line == "isready")
+        {
+            link.engine_output().write("readyok\n");
+        }
+        link.close_engine_output();
+    });
+
+    chesspp::LineReader reader(link.interface_input());
+    std::string_view line;
+    for (auto _ : state)
+    {
+        Clock::time_point const start = Clock::now();
+        link.interface_output().write("isready\n");
+        if (not reader.next_line(line))
+        {
+            state.SkipWithError("The engine stopped answering");
+            break;
+        }
+        state.SetIterationTime(std::chrono::duration<double>(Clock::now() - start).count());
+    }
+
+    link.interface_output().write("quit\n");
+    engine.join();
+}
+
+void round_trip_pipe(benchmark::State &state)
+{
+    run_round_trip(state, false);
+}
+BENCHMARK(round_trip_pipe)->UseManualTime()->Unit(benchmark::kMicrosecond);
+
+void round_trip_shared_memory(benchmark::State &state)
+{
+    run_round_trip(state, true);
+}
+BENCHMARK(round_trip_shared_memory)->UseManualTime()->Unit(benchmark::kMicrosecond);
+} // namespace
@@ -1,11 +1,138 @@
 #ifndef CHESSPP_ARGUMENT_H
 #define CHESSPP_ARGUMENT_H
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace chesspp
 {
+/**
+ * @brief A non-owning, contiguous range of tokens. Used to refer to the
+ *        parameters of an argument without copying them out of the token list
+ *        they were parsed from.
+ *
+ */
+struct TokenSpan
+{
+    /**
+     * @brief Pointer to the first token in the range.
+     *
+     */
+    std::string_view const *first = nullptr;
+
+    /**
+     * @brief The number of tokens in the range.
+     *
+     */
+    std::size_t count = 0;
+
+    TokenSpan() = default;
+
+    TokenSpan(std::string_view const *first, std::size_t count)
+        : first(first), count(count)
+    {
+    }
+
+    /**
+     * @brief Construct a span over every token in a vector
+     *
+     */
+    TokenSpan(std::vector<std::string_view> const &tokens)
+        : first(tokens.data()), count(tokens.size())
+    {
+    }
+
+    /**
+     * @brief Get the tokens from `offset` to the end of the span
+     *
+     */
+    TokenSpan subspan(std::size_t offset) const
+    {
+        return offset < count ? TokenSpan(first + offset, count - offset)
+                              : TokenSpan(end(), 0);
+    }
+
+    std::string_view const *begin() const { return first; }
+    std::string_view const *end() const { return first + count; }
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    std::string_view const &operator[](std::size_t index) const
+    {
+        return first[index];
+    }
+};
+
+/**
+ * @brief A non-owning view of an argument that was received by the UCI engine.
+ *        The value and parameters point into the line and token storage the
+ *        argument was parsed from, so they are only valid for as long as those
+ *        are.
+ *
+ */
+struct ArgumentView
+{
+    /**
+     * @brief The value of the argument (eg. "on" for  the debug command)
+     *
+     */
+    std::string_view value;
+
+    /**
+     * @brief The argument's parameters if it has any.
+     *
+     */
+    TokenSpan parameters;
+};
+
+/**
+ * @brief A non-owning, contiguous range of argument views. This is how
+ *        callbacks receive the arguments of a command, without copying them.
+ *
+ */
+struct ArgumentSpan
+{
+    /**
+     * @brief Pointer to the first argument in the range.
+     *
+     */
+    ArgumentView const *first = nullptr;
+
+    /**
+     * @brief The number of arguments in the range.
+     *
+     */
+    std::size_t count = 0;
+
+    ArgumentSpan() = default;
+
+    ArgumentSpan(ArgumentView const *first, std::size_t count)
+        : first(first), count(count)
+    {
+    }
+
+    /**
+     * @brief Construct a span over every argument in a vector
+     *
+     */
+    ArgumentSpan(std::vector<ArgumentView> const &arguments)
+        : first(arguments.data()), count(arguments.size())
+    {
+    }
+
+    ArgumentView const *begin() const { return first; }
+    ArgumentView const *end() const { return first + count; }
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    ArgumentView const &operator[](std::size_t index) const
+    {
+        return first[index];
+    }
+};
+
 /**
  * @brief Stores value of an actual argument that was received by the UCI engine
  *
@@ -25,11 +152,21 @@ struct Argument
      */
     std::vector<std::string> parameters;
 
-    Argument(std::string &value, std::vector<std::string> &parameters)
+    Argument(std::string const &value, std::vector<std::string> const &parameters)
         : value(value), parameters(parameters)
     {
     }
+
+    /**
+     * @brief Construct an owning copy of an argument view
+     *
+     */
+    explicit Argument(ArgumentView const &view)
+        : value(view.value),
+          parameters(view.parameters.begin(), view.parameters.end())
+    {
+    }
 };
 } // namespace chesspp
 
-#endif
\ No newline at end of file
+#endif
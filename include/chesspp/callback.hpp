@@ -0,0 +1,25 @@
+/**
+ * @file callback.hpp
+ * @brief The type of the callbacks run for received commands
+ *
+ */
+
+#ifndef CHESSPP_CALLBACK_H
+#define CHESSPP_CALLBACK_H
+
+#include "chesspp/argument.hpp"
+#include "chesspp/inplace_function.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief A callback for a command. Any callable that takes the arguments as
+ *        an ArgumentSpan, including lambdas with captured state of up to four
+ *        pointers in size. The span is only valid during the call.
+ *
+ */
+using CommandCallback = InplaceFunction<void(ArgumentSpan)>;
+
+} // namespace chesspp
+
+#endif
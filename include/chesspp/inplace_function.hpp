@@ -0,0 +1,216 @@
+/**
+ * @file inplace_function.hpp
+ * @brief A type-erased callable stored in a fixed size buffer
+ *
+ */
+
+#ifndef CHESSPP_INPLACE_FUNCTION_H
+#define CHESSPP_INPLACE_FUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace chesspp
+{
+template <typename Signature, size_t Capacity = 4 * sizeof(void *)>
+class InplaceFunction;
+
+/**
+ * @brief Like std::function, but the callable is always stored inside the
+ *        object, so constructing, copying and calling it never allocates.
+ *        Callables that don't fit are a compile error rather than a hidden
+ *        heap allocation.
+ *
+ * Calling goes through a single function pointer, the same cost as calling a
+ * plain function pointer.
+ *
+ * @tparam R The return type
+ * @tparam Args The argument types
+ * @tparam Capacity The most bytes a stored callable may take up
+ */
+template <typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity>
+{
+private:
+    enum class Operation
+    {
+        copy,
+        move,
+        destroy
+    };
+
+    /**
+     * @brief Holds the callable
+     *
+     */
+    alignas(std::max_align_t) mutable unsigned char storage[Capacity];
+
+    /**
+     * @brief Calls the stored callable, `nullptr` if there is none
+     *
+     */
+    R (*invoker)(void *callable, Args... args) = nullptr;
+
+    /**
+     * @brief Copies, moves or destroys the stored callable
+     *
+     */
+    void (*manager)(Operation operation, void *destination, void *source) = nullptr;
+
+    template <typename Callable>
+    static R invoke(void *callable, Args... args)
+    {
+        return (*static_cast<Callable *>(callable))(std::forward<Args>(args)...);
+    }
+
+    template <typename Callable>
+    static void manage(Operation operation, void *destination, void *source)
+    {
+        Callable *const callable = static_cast<Callable *>(source);
+        switch (operation)
+        {
+        case Operation::copy:
+            new (destination) Callable(*callable);
+            break;
+        case Operation::move:
+            new (destination) Callable(std::move(*callable));
+            callable->~Callable();
+            break;
+        case Operation::destroy:
+            callable->~Callable();
+            break;
+        }
+    }
+
+    void copy_from(InplaceFunction const &other)
+    {
+        if (other.manager != nullptr)
+        {
+            other.manager(Operation::copy, storage, other.storage);
+        }
+        invoker = other.invoker;
+        manager = other.manager;
+    }
+
+    void move_from(InplaceFunction &other)
+    {
+        if (other.manager != nullptr)
+        {
+            other.manager(Operation::move, storage, other.storage);
+        }
+        invoker = other.invoker;
+        manager = other.manager;
+        other.invoker = nullptr;
+        other.manager = nullptr;
+    }
+
+public:
+    InplaceFunction() = default;
+
+    InplaceFunction(std::nullptr_t)
+    {
+    }
+
+    /**
+     * @brief Stores a copy of a callable
+     *
+     */
+    template <
+        typename Callable,
+        typename Stored = std::decay_t<Callable>,
+        typename = std::enable_if_t<
+            not std::is_same_v<Stored, InplaceFunction> and
+            std::is_invocable_r_v<R, Stored &, Args...>>>
+    InplaceFunction(Callable &&callable)
+    {
+        static_assert(sizeof(Stored) <= Capacity, "The callable is too large for this InplaceFunction");
+        static_assert(alignof(Stored) <= alignof(std::max_align_t), "The callable is over-aligned");
+        static_assert(std::is_copy_constructible_v<Stored>, "The callable must be copyable");
+
+        // A function reference decays to a pointer, but can't be null
+        if constexpr (std::is_pointer_v<std::remove_reference_t<Callable>> or
+                      std::is_member_pointer_v<std::remove_reference_t<Callable>>)
+        {
+            if (callable == nullptr)
+            {
+                return;
+            }
+        }
+        new (storage) Stored(std::forward<Callable>(callable));
+        invoker = &invoke<Stored>;
+        manager = &manage<Stored>;
+    }
+
+    InplaceFunction(InplaceFunction const &other)
+    {
+        copy_from(other);
+    }
+
+    InplaceFunction(InplaceFunction &&other)
+    {
+        move_from(other);
+    }
+
+    InplaceFunction &operator=(InplaceFunction const &other)
+    {
+        if (this != &other)
+        {
+            reset();
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    InplaceFunction &operator=(InplaceFunction &&other)
+    {
+        if (this != &other)
+        {
+            reset();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    ~InplaceFunction()
+    {
+        reset();
+    }
+
+    /**
+     * @brief Destroys the stored callable, if any
+     *
+     */
+    void reset()
+    {
+        if (manager != nullptr)
+        {
+            manager(Operation::destroy, nullptr, storage);
+        }
+        invoker = nullptr;
+        manager = nullptr;
+    }
+
+    /**
+     * @brief Check whether a callable is stored
+     *
+     */
+    explicit operator bool() const
+    {
+        return invoker != nullptr;
+    }
+
+    /**
+     * @brief Calls the stored callable. There must be one.
+     *
+     */
+    R operator()(Args... args) const
+    {
+        return invoker(storage, std::forward<Args>(args)...);
+    }
+};
+
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,223 @@
+/**
+ * @file stats.hpp
+ * @brief Snapshots of the latency and throughput statistics the library keeps
+ *        when built with CHESSPP_INSTRUMENTATION
+ *
+ */
+
+#ifndef CHESSPP_STATS_H
+#define CHESSPP_STATS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace chesspp
+{
+/**
+ * @brief The bucket layout shared by live histograms and their snapshots.
+ *
+ * Buckets are log-linear: values below `sub_buckets` get a bucket each, and
+ * every power of two above that is split into `sub_buckets` equal buckets, so
+ * the relative error of a bucket is at most 1 / sub_buckets (12.5%) over the
+ * whole range of uint64_t.
+ */
+namespace histogram
+{
+/**
+ * @brief log2 of the number of buckets per power of two
+ *
+ */
+inline constexpr unsigned sub_bucket_bits = 3;
+
+inline constexpr uint64_t sub_buckets = uint64_t(1) << sub_bucket_bits;
+
+inline constexpr size_t num_buckets = (64 - sub_bucket_bits + 1) * sub_buckets;
+
+/**
+ * @brief Get the index of the highest set bit of a non-zero value
+ *
+ */
+constexpr unsigned log2(uint64_t value)
+{
+    unsigned result = 0;
+    while (value >>= 1)
+    {
+        result++;
+    }
+    return result;
+}
+
+/**
+ * @brief Get the bucket a value falls in
+ *
+ */
+constexpr size_t bucket(uint64_t value)
+{
+    if (value < sub_buckets)
+    {
+        return static_cast<size_t>(value);
+    }
+    unsigned const exponent = log2(value);
+    uint64_t const sub_bucket = (value >> (exponent - sub_bucket_bits)) & (sub_buckets - 1);
+    return (exponent - sub_bucket_bits + 1) * sub_buckets + sub_bucket;
+}
+
+/**
+ * @brief Get the smallest value that falls in a bucket
+ *
+ */
+constexpr uint64_t lower_bound(size_t index)
+{
+    if (index < sub_buckets)
+    {
+        return index;
+    }
+    unsigned const exponent = static_cast<unsigned>(index / sub_buckets) + sub_bucket_bits - 1;
+    uint64_t const sub_bucket = index % sub_buckets;
+    return (uint64_t(1) << exponent) | sub_bucket << (exponent - sub_bucket_bits);
+}
+
+/**
+ * @brief Get the largest value that falls in a bucket
+ *
+ */
+constexpr uint64_t upper_bound(size_t index)
+{
+    return index + 1 == num_buckets ? UINT64_MAX : lower_bound(index + 1) - 1;
+}
+} // namespace histogram
+
+/**
+ * @brief A copy of a latency histogram. Values are in nanoseconds.
+ *
+ */
+struct HistogramSnapshot
+{
+    /**
+     * @brief The number of values in each bucket, see chesspp::histogram
+     *
+     */
+    std::array<uint64_t, histogram::num_buckets> counts = {};
+
+    /**
+     * @brief The number of values recorded
+     *
+     */
+    uint64_t count = 0;
+
+    /**
+     * @brief The sum of the values recorded
+     *
+     */
+    uint64_t sum = 0;
+
+    /**
+     * @brief The largest value recorded
+     *
+     */
+    uint64_t max = 0;
+
+    /**
+     * @brief Get the mean of the values, 0 if there are none
+     *
+     */
+    uint64_t mean() const
+    {
+        return count == 0 ? 0 : sum / count;
+    }
+
+    /**
+     * @brief Get an upper bound for a quantile of the values, within the
+     *        relative error of a bucket. 0 if there are none.
+     *
+     * @param quantile Between 0 and 1, eg. 0.99 for the 99th percentile
+     */
+    uint64_t percentile(double quantile) const
+    {
+        if (count == 0)
+        {
+            return 0;
+        }
+        uint64_t const rank = static_cast<uint64_t>(quantile * static_cast<double>(count - 1));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < histogram::num_buckets; i++)
+        {
+            seen += counts[i];
+            if (seen > rank)
+            {
+                return histogram::upper_bound(i) < max ? histogram::upper_bound(i) : max;
+            }
+        }
+        return max;
+    }
+};
+
+/**
+ * @brief The number of times a command was sent or received
+ *
+ */
+struct CommandCount
+{
+    std::string_view name;
+    uint64_t count = 0;
+};
+
+/**
+ * @brief A copy of everything the library measures. Every field is zero (and
+ *        the command lists empty) unless the library was built with
+ *        CHESSPP_INSTRUMENTATION.
+ *
+ */
+struct StatsSnapshot
+{
+    /**
+     * @brief From a line arriving to it being tokenised, parsed and queued
+     *
+     */
+    HistogramSnapshot parse;
+
+    /**
+     * @brief From a line arriving to its callback being entered
+     *
+     */
+    HistogramSnapshot dispatch;
+
+    /**
+     * @brief From a command being written to it being handed to the output
+     *        (eg. written to stdout)
+     *
+     */
+    HistogramSnapshot write;
+
+    /**
+     * @brief Bytes read from the interface
+     *
+     */
+    uint64_t bytes_in = 0;
+
+    /**
+     * @brief Bytes handed to the output
+     *
+     */
+    uint64_t bytes_out = 0;
+
+    /**
+     * @brief Commands received, by name, for those received at least once.
+     *        Commands that are not standard are counted as "other".
+     *
+     */
+    std::vector<CommandCount> commands_in;
+
+    /**
+     * @brief Commands written, by name, for those written at least once
+     *
+     */
+    std::vector<CommandCount> commands_out;
+};
+
+} // namespace chesspp
+
+#endif
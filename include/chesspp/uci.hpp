@@ -0,0 +1,149 @@
+/**
+ * @file uci.hpp
+ * @brief The public entry point of Chess++
+ *
+ */
+
+#ifndef CHESSPP_UCI_H
+#define CHESSPP_UCI_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chesspp/argument.hpp"
+#include "chesspp/callback.hpp"
+#include "chesspp/stats.hpp"
+
+namespace chesspp
+{
+class Engine;
+class OutputWriter;
+class Transport;
+
+/**
+ * @brief Speaks the Universal Chess Interface for a chess engine: runs the
+ *        registered callbacks for the commands the interface sends and
+ *        checks the commands the engine sends back.
+ *
+ * Commands are looked up by name in a perfect hash table, so dispatch costs
+ * the same however many commands are registered.
+ */
+class UCI
+{
+private:
+    std::unique_ptr<Engine> engine;
+
+    /**
+     * @brief The file the session is being recorded to, if any
+     *
+     */
+    struct Recording;
+    std::unique_ptr<Recording> recording;
+
+public:
+    /**
+     * @brief Construct a new UCI object
+     *
+     * @param input_fd The descriptor to read commands from. Standard input by
+     *        default. Output goes to standard output.
+     */
+    explicit UCI(int input_fd = 0);
+
+    /**
+     * @brief Construct a new UCI object that writes to `output`
+     *
+     * @param input_fd The descriptor to read commands from
+     * @param output Where commands to the interface are written. Must
+     *        outlive the UCI object.
+     */
+    UCI(int input_fd, OutputWriter &output);
+
+    /**
+     * @brief Construct a new UCI object that talks over a transport, eg. the
+     *        one open_transport() picks from the command line
+     *
+     * @param transport Where commands are read from and written to. Must
+     *        outlive the UCI object.
+     */
+    explicit UCI(Transport &transport);
+
+    ~UCI();
+
+    UCI(UCI const &) = delete;
+    UCI &operator=(UCI const &) = delete;
+
+    /**
+     * @brief Attach a callback to a command the interface can send
+     *
+     * @param name The name of the command (eg. "debug")
+     * @param callback The callable to run when the command is received. It is
+     *        passed the arguments as a span that is only valid during the call.
+     * @return true If the callback was attached
+     * @return false If there is no command by that name
+     */
+    bool register_command(std::string_view name, CommandCallback callback);
+
+    /**
+     * @brief Attach a callback that takes owning copies of the arguments to a
+     *        command the interface can send
+     *
+     * @return true If the callback was attached
+     * @return false If there is no command by that name
+     */
+    bool register_command(std::string_view name, void (*callback)(std::vector<Argument>));
+
+    /**
+     * @brief Sends a standard UCI command (eg. "bestmove") to the interface
+     *        after checking its arguments against the command's grammar
+     *
+     * @param name The name of the command
+     * @param arguments The arguments, one token per entry
+     * @return true If the command was sent
+     * @return false If there is no standard command by that name or the
+     *         arguments don't fit its grammar
+     */
+    bool issue_command(std::string_view name, std::vector<std::string> const &arguments);
+
+    /**
+     * @brief Starts listening for commands and running their callbacks on the
+     *        calling thread until `quit` or the end of the input
+     *
+     * @param mode "engine" to listen for commands sent to the engine by the
+     *        interface. Listening as the interface is not supported yet.
+     * @return false If the mode is not supported
+     */
+    bool start(std::string_view mode = "engine");
+
+    /**
+     * @brief Records every line read and written from now on to a session
+     *        log, which `chesspp-replay` can play back against an engine.
+     *        Call before start().
+     *
+     * @param path The file to write. It is created or truncated.
+     * @return false If the file could not be opened
+     */
+    bool record_to(std::string const &path);
+
+    /**
+     * @brief Get a copy of the latency and throughput statistics. Everything
+     *        is zero unless the library is built with CHESSPP_INSTRUMENTATION.
+     *
+     */
+    StatsSnapshot get_stats() const;
+
+    /**
+     * @brief Get the underlying engine, for the lower level API (eg. typed
+     *        `go` callbacks and the stop flag)
+     *
+     */
+    Engine &get_engine()
+    {
+        return *engine;
+    }
+};
+
+} // namespace chesspp
+
+#endif
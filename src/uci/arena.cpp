@@ -0,0 +1,16 @@
+#include "arena.hpp"
+#include "parser.hpp"
+
+chesspp::TokenSpan chesspp::LineArena::tokenise(std::string_view input)
+{
+    // assign() reuses the string's capacity when the line fits
+    line.assign(input.data(), input.size());
+    return Parser::tokenise(line, tokens);
+}
+
+void chesspp::LineArena::reset()
+{
+    line.clear();
+    tokens.clear();
+    arguments.clear();
+}
@@ -0,0 +1,117 @@
+/**
+ * @file arena.hpp
+ * @brief Reusable storage for parsing one line at a time
+ *
+ */
+
+#ifndef SRC_UCI_ARENA_H
+#define SRC_UCI_ARENA_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chesspp/argument.hpp"
+#include "command/parse_result.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief Owns everything a parsed line refers to: a copy of the line, its
+ *        tokens and its argument views. The arena is reset after each command
+ *        is dispatched, which keeps the capacity of its buffers, so once it
+ *        has seen the longest line parsing needs no heap allocation at all.
+ *
+ * Views handed out by the arena are invalidated by reset() and by the next
+ * call to tokenise().
+ */
+class LineArena
+{
+private:
+    /**
+     * @brief A copy of the line being parsed. The tokens point into it.
+     *
+     */
+    std::string line;
+
+    /**
+     * @brief The tokens of the line
+     *
+     */
+    std::vector<std::string_view> tokens;
+
+    /**
+     * @brief The arguments of the command on the line
+     *
+     */
+    std::vector<ArgumentView> arguments;
+
+public:
+    /**
+     * @brief Copies a line into the arena and splits it into tokens
+     *
+     * @param input The line to tokenise
+     * @return TokenSpan All the tokens on the line, including the command name
+     */
+    TokenSpan tokenise(std::string_view input);
+
+    /**
+     * @brief Parses the arguments of a command into the arena
+     *
+     * @param command The command to parse for. Either a Command or a
+     *        StaticCommand.
+     * @param argument_tokens The argument tokens, usually the tokens from
+     *        tokenise() without the command name
+     * @return std::vector<ArgumentView> const& The parsed arguments
+     *
+     * @throw ArgumentParseException
+     * @throw MissingArgumentException
+     */
+    template <typename CommandType>
+    std::vector<ArgumentView> const &parse_arguments(
+        CommandType const &command, TokenSpan argument_tokens)
+    {
+        return command.parse_arguments(argument_tokens, arguments);
+    }
+
+    /**
+     * @brief Parses the arguments of a command into the arena without
+     *        throwing
+     *
+     * @param command The command to parse for. Either a Command or a
+     *        StaticCommand.
+     * @param argument_tokens The argument tokens, from tokenise()
+     * @return ParseResult<std::vector<ArgumentView>> The parsed arguments, or
+     *         the error with its byte offset from the start of the line
+     */
+    template <typename CommandType>
+    ParseResult<std::vector<ArgumentView>> try_parse_arguments(
+        CommandType const &command, TokenSpan argument_tokens)
+    {
+        ParseResult<std::vector<ArgumentView>> const result =
+            command.try_parse_arguments(argument_tokens, arguments);
+        if (result)
+        {
+            return result;
+        }
+
+        // Offsets are relative to the first token, make them relative to the
+        // line
+        ParseError error = result.error();
+        error.offset += argument_tokens.empty()
+                            ? line.size()
+                            : static_cast<size_t>(argument_tokens[0].data() - line.data());
+        return error;
+    }
+
+    /**
+     * @brief Forgets the current line once its command has been dispatched.
+     *        Keeps all allocated capacity for the next line.
+     *
+     */
+    void reset();
+};
+
+} // namespace chesspp
+
+#endif
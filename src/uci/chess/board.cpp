@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <charconv>
+
+#include "board.hpp"
+
+namespace
+{
+/**
+ * @brief Maps a FEN piece letter to its piece, or piece::none
+ *
+ */
+uint8_t decode_piece(char c)
+{
+    switch (c)
+    {
+    case 'P': return chesspp::piece::pawn;
+    case 'N': return chesspp::piece::knight;
+    case 'B': return chesspp::piece::bishop;
+    case 'R': return chesspp::piece::rook;
+    case 'Q': return chesspp::piece::queen;
+    case 'K': return chesspp::piece::king;
+    case 'p': return chesspp::piece::pawn | chesspp::piece::black;
+    case 'n': return chesspp::piece::knight | chesspp::piece::black;
+    case 'b': return chesspp::piece::bishop | chesspp::piece::black;
+    case 'r': return chesspp::piece::rook | chesspp::piece::black;
+    case 'q': return chesspp::piece::queen | chesspp::piece::black;
+    case 'k': return chesspp::piece::king | chesspp::piece::black;
+    default: return chesspp::piece::none;
+    }
+}
+
+bool parse_placement(std::string_view placement, chesspp::Board &board)
+{
+    // FEN lists the ranks from 8 down to 1
+    unsigned rank = 7;
+    unsigned file = 0;
+    for (char const c : placement)
+    {
+        if (c == '/')
+        {
+            if (file != 8 or rank == 0)
+            {
+                return false;
+            }
+            rank--;
+            file = 0;
+        }
+        else if (c >= '1' and c <= '8')
+        {
+            file += c - '0';
+            if (file > 8)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            uint8_t const piece = decode_piece(c);
+            if (piece == chesspp::piece::none or file >= 8)
+            {
+                return false;
+            }
+            board.squares[chesspp::make_square(file, rank)] = piece;
+            file++;
+        }
+    }
+    return rank == 0 and file == 8;
+}
+
+bool parse_castling(std::string_view text, uint8_t &rights)
+{
+    rights = 0;
+    if (text == "-")
+    {
+        return true;
+    }
+    for (char const c : text)
+    {
+        switch (c)
+        {
+        case 'K': rights |= chesspp::castling::white_king; break;
+        case 'Q': rights |= chesspp::castling::white_queen; break;
+        case 'k': rights |= chesspp::castling::black_king; break;
+        case 'q': rights |= chesspp::castling::black_queen; break;
+        default: return false;
+        }
+    }
+    return not text.empty();
+}
+
+bool parse_en_passant(std::string_view text, chesspp::Square &square)
+{
+    if (text == "-")
+    {
+        square = chesspp::Board::no_square;
+        return true;
+    }
+    if (text.size() != 2 or text[0] < 'a' or text[0] > 'h' or (text[1] != '3' and text[1] != '6'))
+    {
+        return false;
+    }
+    square = chesspp::make_square(text[0] - 'a', text[1] - '1');
+    return true;
+}
+
+bool parse_counter(std::string_view text, uint16_t &value)
+{
+    char const *const end = text.data() + text.size();
+    std::from_chars_result const result = std::from_chars(text.data(), end, value);
+    return result.ec == std::errc() and result.ptr == end;
+}
+} // namespace
+
+chesspp::Board chesspp::Board::start_position()
+{
+    Board board;
+    parse_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", board);
+    return board;
+}
+
+bool chesspp::parse_fen(TokenSpan fields, Board &board)
+{
+    if (fields.size() != 4 and fields.size() != 6)
+    {
+        return false;
+    }
+
+    // Parse into a copy so the board is left alone on errors
+    Board parsed;
+    if (not parse_placement(fields[0], parsed))
+    {
+        return false;
+    }
+    if (fields[1] != "w" and fields[1] != "b")
+    {
+        return false;
+    }
+    parsed.black_to_move = fields[1] == "b";
+    if (not parse_castling(fields[2], parsed.castling) or
+        not parse_en_passant(fields[3], parsed.en_passant))
+    {
+        return false;
+    }
+    if (fields.size() == 6 and
+        (not parse_counter(fields[4], parsed.halfmove_clock) or
+         not parse_counter(fields[5], parsed.fullmove_number)))
+    {
+        return false;
+    }
+
+    board = parsed;
+    return true;
+}
+
+bool chesspp::parse_fen(std::string_view fen, Board &board)
+{
+    // Split into at most 7 fields, so a FEN with too many is still rejected
+    std::string_view fields[7];
+    size_t num_fields = 0;
+    size_t position = 0;
+    while (num_fields < 7)
+    {
+        position = fen.find_first_not_of(' ', position);
+        if (position == std::string_view::npos)
+        {
+            break;
+        }
+        size_t const end = std::min(fen.find(' ', position), fen.size());
+        fields[num_fields++] = fen.substr(position, end - position);
+        position = end;
+    }
+    return parse_fen(TokenSpan(fields, num_fields), board);
+}
@@ -0,0 +1,130 @@
+/**
+ * @file board.hpp
+ * @brief A flat board and a FEN parser that fills it
+ *
+ */
+
+#ifndef SRC_UCI_CHESS_BOARD_H
+#define SRC_UCI_CHESS_BOARD_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "chesspp/argument.hpp"
+#include "move.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief The contents of a square: a piece type in the low 3 bits and the
+ *        colour in bit 3, so black pieces are white pieces + 8
+ *
+ */
+namespace piece
+{
+enum : uint8_t
+{
+    none = 0,
+    pawn = 1,
+    knight = 2,
+    bishop = 3,
+    rook = 4,
+    queen = 5,
+    king = 6,
+    black = 8
+};
+} // namespace piece
+
+/**
+ * @brief Castling rights, as bits of Board::castling
+ *
+ */
+namespace castling
+{
+enum : uint8_t
+{
+    white_king = 1,
+    white_queen = 2,
+    black_king = 4,
+    black_queen = 8
+};
+} // namespace castling
+
+/**
+ * @brief A position as described by a FEN, in 72 bytes with no pointers
+ *
+ */
+struct Board
+{
+    /**
+     * @brief Marks a missing en passant square
+     *
+     */
+    static constexpr Square no_square = 64;
+
+    /**
+     * @brief The piece on each square, indexed by Square
+     *
+     */
+    std::array<uint8_t, 64> squares = {};
+
+    /**
+     * @brief True if black is to move
+     *
+     */
+    bool black_to_move = false;
+
+    /**
+     * @brief The castling rights
+     *
+     */
+    uint8_t castling = 0;
+
+    /**
+     * @brief The square a pawn can capture en passant on, or `no_square`
+     *
+     */
+    Square en_passant = no_square;
+
+    /**
+     * @brief The number of half moves since the last capture or pawn move
+     *
+     */
+    uint16_t halfmove_clock = 0;
+
+    /**
+     * @brief The number of the full move, starting at 1
+     *
+     */
+    uint16_t fullmove_number = 1;
+
+    /**
+     * @brief Get the standard starting position
+     *
+     */
+    static Board start_position();
+};
+
+static_assert(sizeof(Board) == 72, "Board should stay small and flat");
+
+/**
+ * @brief Parses a FEN into a board without allocating
+ *
+ * @param fields The fields of the FEN, one token each. The halfmove clock and
+ *        fullmove number may be left out.
+ * @param board Set to the position if the FEN is valid, left alone otherwise
+ * @return true If the FEN is valid
+ */
+bool parse_fen(TokenSpan fields, Board &board);
+
+/**
+ * @brief Parses a FEN with space separated fields into a board without
+ *        allocating
+ *
+ */
+bool parse_fen(std::string_view fen, Board &board);
+
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,72 @@
+#include "decode.hpp"
+
+bool chesspp::decode_moves(TokenSpan tokens, std::vector<Move> &moves)
+{
+    moves.resize(tokens.size());
+    bool valid = true;
+    for (size_t i = 0; i < tokens.size(); i++)
+    {
+        valid &= Move::from_uci(tokens[i], moves[i]);
+    }
+    if (not valid)
+    {
+        moves.clear();
+    }
+    return valid;
+}
+
+bool chesspp::decode_position(
+    std::vector<ArgumentView> const &arguments, Board &board, std::vector<Move> &moves)
+{
+    PositionDelta delta;
+    for (ArgumentView const &argument : arguments)
+    {
+        if (argument.value == "fen")
+        {
+            delta.fen = argument.parameters;
+        }
+        else if (argument.value == "moves")
+        {
+            delta.moves = argument.parameters;
+        }
+    }
+    return decode_position(delta, board, moves);
+}
+
+bool chesspp::decode_position(PositionDelta const &delta, Board &board, std::vector<Move> &moves)
+{
+    if (delta.reset)
+    {
+        if (delta.fen.empty())
+        {
+            board = Board::start_position();
+        }
+        else if (not parse_fen(delta.fen, board))
+        {
+            return false;
+        }
+    }
+    return decode_moves(delta.moves, moves);
+}
+
+bool chesspp::decode_bestmove(std::vector<ArgumentView> const &arguments, BestMove &best)
+{
+    BestMove decoded;
+    for (ArgumentView const &argument : arguments)
+    {
+        if (argument.value == "ponder")
+        {
+            if (argument.parameters.size() != 1 or
+                not Move::from_uci(argument.parameters[0], decoded.ponder))
+            {
+                return false;
+            }
+        }
+        else if (not Move::from_uci(argument.value, decoded.move))
+        {
+            return false;
+        }
+    }
+    best = decoded;
+    return true;
+}
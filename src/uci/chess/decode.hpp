@@ -0,0 +1,78 @@
+/**
+ * @file decode.hpp
+ * @brief Decodes the arguments of `position` and `bestmove` into boards and
+ *        packed moves
+ *
+ */
+
+#ifndef SRC_UCI_CHESS_DECODE_H
+#define SRC_UCI_CHESS_DECODE_H
+
+#include <vector>
+
+#include "chesspp/argument.hpp"
+#include "../position_tracker.hpp"
+#include "board.hpp"
+#include "move.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief The decoded arguments of a `bestmove` command
+ *
+ */
+struct BestMove
+{
+    Move move;
+
+    /**
+     * @brief The move to ponder on, the null move if there is none
+     *
+     */
+    Move ponder;
+};
+
+/**
+ * @brief Decodes a list of moves
+ *
+ * @param tokens The moves in long algebraic notation
+ * @param moves Cleared and filled with the moves. Keeps its capacity, so once
+ *        it has held the longest list decoding does not allocate.
+ * @return true If every move is valid
+ */
+bool decode_moves(TokenSpan tokens, std::vector<Move> &moves);
+
+/**
+ * @brief Decodes the arguments of a `position` command
+ *
+ * @param arguments The parsed arguments
+ * @param board Set to the starting position, either the standard one or the
+ *        FEN that was sent
+ * @param moves Set to the moves to play from the starting position
+ * @return true If the FEN and every move are valid
+ */
+bool decode_position(std::vector<ArgumentView> const &arguments, Board &board, std::vector<Move> &moves);
+
+/**
+ * @brief Decodes the change in position reported by a PositionTracker
+ *
+ * @param delta The change in position
+ * @param board Set to the starting position if `delta.reset` is set, left
+ *        alone otherwise
+ * @param moves Set to the moves to play
+ * @return true If the FEN and every move are valid
+ */
+bool decode_position(PositionDelta const &delta, Board &board, std::vector<Move> &moves);
+
+/**
+ * @brief Decodes the arguments of a `bestmove` command
+ *
+ * @param arguments The parsed arguments
+ * @param best Set to the moves if they are valid
+ * @return true If the moves are valid
+ */
+bool decode_bestmove(std::vector<ArgumentView> const &arguments, BestMove &best);
+
+} // namespace chesspp
+
+#endif
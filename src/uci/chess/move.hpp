@@ -0,0 +1,210 @@
+/**
+ * @file move.hpp
+ * @brief A move packed into 16 bits and its long algebraic notation
+ *
+ */
+
+#ifndef SRC_UCI_CHESS_MOVE_H
+#define SRC_UCI_CHESS_MOVE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace chesspp
+{
+/**
+ * @brief A square, numbered from a1 = 0 to h8 = 63 along the ranks
+ *
+ */
+using Square = uint8_t;
+
+/**
+ * @brief Makes a square from a file (0 = a) and a rank (0 = 1)
+ *
+ */
+constexpr Square make_square(unsigned file, unsigned rank)
+{
+    return static_cast<Square>(rank * 8 + file);
+}
+
+/**
+ * @brief The piece a pawn promotes to
+ *
+ */
+enum class Promotion : uint8_t
+{
+    none,
+    knight,
+    bishop,
+    rook,
+    queen
+};
+
+/**
+ * @brief A move packed into 16 bits: the source square in bits 0-5, the
+ *        destination square in bits 6-11 and the promotion in bits 12-14.
+ *
+ * The null move (`0000` in UCI) is the all zero value, which is not a real
+ * move since its squares are the same.
+ */
+class Move
+{
+private:
+    uint16_t data = 0;
+
+    /**
+     * @brief Maps the last character of a promotion to the piece, or 0 if it
+     *        is not a promotion piece
+     *
+     */
+    static constexpr uint8_t decode_promotion(char c)
+    {
+        switch (c)
+        {
+        case 'n':
+            return 1;
+        case 'b':
+            return 2;
+        case 'r':
+            return 3;
+        case 'q':
+            return 4;
+        default:
+            return 0;
+        }
+    }
+
+public:
+    /**
+     * @brief The longest UCI notation of a move, eg. "e7e8q"
+     *
+     */
+    static constexpr size_t max_uci_length = 5;
+
+    /**
+     * @brief Construct the null move
+     *
+     */
+    constexpr Move() = default;
+
+    constexpr Move(Square from, Square to, Promotion promotion = Promotion::none)
+        : data(static_cast<uint16_t>(
+              from | (to << 6) | (static_cast<unsigned>(promotion) << 12)))
+    {
+    }
+
+    constexpr Square from() const
+    {
+        return static_cast<Square>(data & 63);
+    }
+
+    constexpr Square to() const
+    {
+        return static_cast<Square>((data >> 6) & 63);
+    }
+
+    constexpr Promotion promotion() const
+    {
+        return static_cast<Promotion>(data >> 12);
+    }
+
+    constexpr bool is_null() const
+    {
+        return data == 0;
+    }
+
+    /**
+     * @brief Get the packed representation
+     *
+     */
+    constexpr uint16_t raw() const
+    {
+        return data;
+    }
+
+    constexpr bool operator==(Move other) const
+    {
+        return data == other.data;
+    }
+
+    constexpr bool operator!=(Move other) const
+    {
+        return data != other.data;
+    }
+
+    /**
+     * @brief Decodes a move in long algebraic notation, eg. "e2e4", "e7e8q" or
+     *        "0000" for the null move. The squares are range checked with a
+     *        single comparison instead of one branch per character.
+     *
+     * @param text The move
+     * @param move Set to the move if it is valid, left alone otherwise
+     * @return true If `text` is a valid move
+     */
+    static constexpr bool from_uci(std::string_view text, Move &move)
+    {
+        if (text.size() != 4 and text.size() != 5)
+        {
+            return false;
+        }
+
+        // Characters below 'a' or '1' wrap around to large values, so one
+        // comparison checks all four
+        unsigned const from_file = static_cast<unsigned char>(text[0]) - 'a';
+        unsigned const from_rank = static_cast<unsigned char>(text[1]) - '1';
+        unsigned const to_file = static_cast<unsigned char>(text[2]) - 'a';
+        unsigned const to_rank = static_cast<unsigned char>(text[3]) - '1';
+        unsigned const promotion = text.size() == 5 ? decode_promotion(text[4]) : 0;
+
+        bool const valid = (from_file | from_rank | to_file | to_rank) < 8 and
+                           (text.size() == 4 or promotion != 0);
+        if (valid)
+        {
+            move = Move(make_square(from_file, from_rank), make_square(to_file, to_rank),
+                        static_cast<Promotion>(promotion));
+            return true;
+        }
+        if (text == "0000")
+        {
+            move = Move();
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Writes the move in long algebraic notation
+     *
+     * @param out Where to write, with room for max_uci_length characters
+     * @return char* The end of what was written
+     */
+    constexpr char *to_uci(char *out) const
+    {
+        if (is_null())
+        {
+            out[0] = out[1] = out[2] = out[3] = '0';
+            return out + 4;
+        }
+        out[0] = static_cast<char>('a' + (from() & 7));
+        out[1] = static_cast<char>('1' + (from() >> 3));
+        out[2] = static_cast<char>('a' + (to() & 7));
+        out[3] = static_cast<char>('1' + (to() >> 3));
+        out[4] = " nbrq"[data >> 12];
+        return out + 4 + (promotion() != Promotion::none);
+    }
+
+    /**
+     * @brief Get the move in long algebraic notation
+     *
+     */
+    std::string to_uci() const
+    {
+        char text[max_uci_length] = {};
+        return std::string(text, to_uci(text));
+    }
+};
+
+} // namespace chesspp
+
+#endif
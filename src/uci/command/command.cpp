@@ -1,157 +1,185 @@
-#include <iostream>
 #include <algorithm>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "command.hpp"
+#include "group_arguments.hpp"
+#include "../io/output_writer.hpp"
 #include "chesspp/argument.hpp"
 
+void chesspp::throw_parse_error(ParseError error)
+{
+    if (error.code == ParseErrorCode::missing_argument)
+    {
+        throw_exception(MissingArgumentException());
+    }
+    throw_exception(ArgumentParseException());
+}
+
 void chesspp::Command::issue(std::vector<std::string> const &arguments) const
 {
-    // Add the name of the command to the output
-    std::string output = name;
+    issue(arguments, OutputWriter::standard());
+}
 
+void chesspp::Command::issue(
+    std::vector<std::string> const &arguments, OutputWriter &output) const
+{
     // Make sure that the arguments can be parsed. This will throw an
     // ArgumentParseException if we can't parse the arguments.
     parse_arguments(arguments);
 
-    // Add arguments to the output string
-    for (const std::string argument : arguments)
-    {
-        output.append(" " + argument);
-    }
-
-    // Print output to stdout.
-    std::cout << output << "\n";
+    // Format the command straight into the output buffer
+    output.write(name, arguments);
 }
 
 std::vector<chesspp::Argument> chesspp::Command::parse_arguments(
     std::vector<std::string> const &argument_strings) const
 {
-    // Convert the strings into Argument objects
-    std::vector<Argument> arguments = get_arguments(argument_strings);
-
-    // Check if all the required arguments are included.
-    if (not check_required_arguments(arguments))
-    {
-        throw MissingArgumentException();
-    }
+    // Parse views over the strings, then copy the result into Argument objects
+    std::vector<std::string_view> const tokens(
+        argument_strings.begin(), argument_strings.end());
+    std::vector<ArgumentView> views;
+    parse_arguments(tokens, views);
 
-    return arguments;
+    return std::vector<Argument>(views.begin(), views.end());
 }
 
-chesspp::ArgumentDefinition const *chesspp::Command::find_argument(
-    std::string const &argument_string) const
+std::vector<chesspp::ArgumentView> &chesspp::Command::parse_arguments(
+    TokenSpan tokens,
+    std::vector<ArgumentView> &arguments) const
 {
-    for (ArgumentDefinition const &accepted_argument : accepted_arguments)
+    ParseResult<std::vector<ArgumentView>> const result = try_parse_arguments(tokens, arguments);
+    if (not result)
     {
-        for (std::string const &value : accepted_argument.values)
-        {
-            if (value == argument_string)
-            {
-                return &accepted_argument;
-            }
-        }
+        throw_parse_error(result.error());
     }
-    return nullptr;
+    return *result;
 }
 
-std::vector<chesspp::Argument> chesspp::Command::get_arguments(
-    std::vector<std::string> const &argument_strings) const
+chesspp::ParseResult<std::vector<chesspp::ArgumentView>> chesspp::Command::try_parse_arguments(
+    TokenSpan tokens,
+    std::vector<ArgumentView> &arguments) const
 {
-    // Stores the arguments we will return
-    std::vector<chesspp::Argument> arguments;
-
-    // Stores parameters for the argument being parsed.
-    std::vector<std::string> parameters;
-
-    // Start parsing tokens from the back to the front.
-    for (auto it = argument_strings.rbegin(); it != argument_strings.rend(); ++it)
+    // Group the tokens into arguments
+    uint64_t found_arguments = 0;
+    ParseError const error = get_arguments(tokens, arguments, found_arguments);
+    if (error.code != ParseErrorCode::none)
     {
-        std::string argument_string = *it;
-
-        // Try to find a matching argument definition
-        chesspp::ArgumentDefinition const *arg_def = find_argument(argument_string);
-
-        // If the token does not match an argument definition then add it as a
-        // parameter.
-        if (arg_def == nullptr or (arg_def->num_parameters != -1 and
-                                   arg_def->num_parameters != parameters.size()))
-        {
-            parameters.push_back(argument_string);
-        }
-
-        // Otherwise add it to the argument list
-        else
-        {
-            // Since we are iterating in reverse we need to reverse parameters.
-            std::reverse(parameters.begin(), parameters.end());
-
-            // Create the argument and add it to the result list
-            chesspp::Argument argument(argument_string, parameters);
-            arguments.push_back(argument);
-
-            // empty the parameter list for the new argument.
-            parameters.clear();
-        }
+        return error;
     }
 
-    // If something went wrong we will have some parameters left over
-    if (not parameters.empty())
+    // Check if all the required arguments are included.
+    if (not check_required_arguments(found_arguments))
     {
-        throw ArgumentParseException();
+        return ParseError{ParseErrorCode::missing_argument, end_offset(tokens)};
     }
 
-    // Reverse arguments to get proper order, since we iterated in reverse.
-    std::reverse(arguments.begin(), arguments.end());
-
-    // Return result
     return arguments;
 }
 
-std::vector<chesspp::ArgumentDefinition> const chesspp::Command::get_required_arguments() const
+void chesspp::Command::index_arguments()
 {
-    // stores the required arguments that we need to find
-    std::vector<ArgumentDefinition> required_arguments;
+    if (accepted_arguments.size() > 64)
+    {
+        throw_exception(TooManyArgumentDefinitionsException());
+    }
 
-    // loop over the accepted arguments looking for ones that have the required
-    // flag.
-    for (ArgumentDefinition const &argument : accepted_arguments)
+    for (size_t i = 0; i < accepted_arguments.size(); i++)
     {
-        if (argument.required)
+        for (std::string const &value : accepted_arguments[i].values)
+        {
+            argument_index.emplace_back(value, i);
+        }
+        if (accepted_arguments[i].required)
+        {
+            required_arguments |= uint64_t(1) << i;
+        }
+        if (accepted_arguments[i].values.empty() and any_value_argument == -1)
         {
-            required_arguments.push_back(argument);
+            any_value_argument = static_cast<int>(i);
         }
     }
-    return required_arguments;
+
+    // Sort by value. If a value appears in more than one definition the first
+    // definition wins, so keep the original order among equal values and drop
+    // all but the first.
+    std::stable_sort(
+        argument_index.begin(), argument_index.end(),
+        [](auto const &left, auto const &right) { return left.first < right.first; });
+    argument_index.erase(
+        std::unique(
+            argument_index.begin(), argument_index.end(),
+            [](auto const &left, auto const &right) { return left.first == right.first; }),
+        argument_index.end());
+    argument_index.shrink_to_fit();
 }
 
-bool chesspp::Command::check_required_arguments(std::vector<chesspp::Argument> arguments) const
+chesspp::ArgumentDefinition const *chesspp::Command::find_argument(
+    std::string_view argument_string) const
 {
-    std::vector<chesspp::ArgumentDefinition> const &required_arguments = get_required_arguments();
+    auto const entry = std::lower_bound(
+        argument_index.begin(), argument_index.end(), argument_string,
+        [](auto const &entry, std::string_view value) { return entry.first < value; });
 
-    for (ArgumentDefinition const &required_argument : required_arguments)
+    if (entry == argument_index.end() or entry->first != argument_string)
     {
-        bool found = false;
-        for (Argument const &argument : arguments)
-        {
-            for (std::string const &value : required_argument.values)
+        return nullptr;
+    }
+    return &accepted_arguments[entry->second];
+}
+
+chesspp::ParseError chesspp::Command::get_arguments(
+    TokenSpan tokens,
+    std::vector<ArgumentView> &arguments,
+    uint64_t &found_arguments) const
+{
+    return group_arguments(
+        tokens, arguments,
+        [this](std::string_view token, bool leading) {
+            ArgumentDefinition const *arg_def = find_argument(token);
+            if (arg_def == nullptr and leading and any_value_argument != -1)
             {
-                if (value == argument.value)
-                {
-                    found = true;
-                    break;
-                }
+                arg_def = &accepted_arguments[any_value_argument];
             }
-            if (found)
+            if (arg_def == nullptr)
             {
-                break;
+                return ArgumentMatch();
             }
-        }
-        if (not found)
-        {
-            return false;
-        }
+            return ArgumentMatch{
+                static_cast<int>(arg_def - accepted_arguments.data()),
+                arg_def->num_parameters};
+        },
+        found_arguments);
+}
+
+bool chesspp::Command::check_required_arguments(uint64_t found_arguments) const
+{
+    return (found_arguments & required_arguments) == required_arguments;
+}
+
+void chesspp::Command::attach_callback(CommandCallback callback)
+{
+    this->callback = std::move(callback);
+}
+
+void chesspp::Command::attach_callback(void (*callback)(std::vector<Argument>))
+{
+    if (callback == nullptr)
+    {
+        this->callback.reset();
+        return;
+    }
+    this->callback = [callback](ArgumentSpan arguments) {
+        callback(std::vector<Argument>(arguments.begin(), arguments.end()));
+    };
+}
+
+void chesspp::Command::run(ArgumentSpan arguments) const
+{
+    if (callback)
+    {
+        callback(arguments);
     }
-    return true;
 }
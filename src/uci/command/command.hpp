@@ -11,16 +11,23 @@
 #ifndef SRC_UCI_COMMAND_H
 #define SRC_UCI_COMMAND_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #include <iostream>
 #include <exception>
 
 #include "chesspp/argument.hpp"
+#include "chesspp/callback.hpp"
+#include "parse_result.hpp"
 
 namespace chesspp
 {
 
+class OutputWriter;
+
 /**
  * @brief This exception is thrown when the command encounters a sequence of
  *        arguments that it could not parse.
@@ -47,6 +54,27 @@ class MissingArgumentException : public std::exception
     }
 };
 
+/**
+ * @brief This exception is thrown when a command is defined with more
+ *        argument definitions than it can index
+ *
+ */
+class TooManyArgumentDefinitionsException : public std::exception
+{
+    virtual const char *what() const throw()
+    {
+        return "Too many argument definitions for one command";
+    }
+};
+
+/**
+ * @brief Throws the exception that matches a parse error, or aborts when
+ *        compiled without exceptions. Used by the throwing parse functions.
+ *
+ * @throw ArgumentParseException
+ * @throw MissingArgumentException
+ */
+[[noreturn]] void throw_parse_error(ParseError error);
 
 /**
  * @brief Defines an argument that the command will accept as valid.
@@ -57,7 +85,9 @@ struct ArgumentDefinition
     /**
      * @brief Holds acceptable values that the argument might take on
      *        (eg. for debug this would be ["on", "off"]). If nothing is defined
-     *        then the argument will accept any value at all.
+     *        then the argument will accept any value at all, as long as it is
+     *        the first token and does not match another argument (eg. the
+     *        move in "bestmove e2e4 ponder e7e5").
      *
      */
     std::vector<std::string> const values;
@@ -107,28 +137,51 @@ private:
      */
     std::vector<ArgumentDefinition> accepted_arguments;
 
+    /**
+     * @brief Maps each accepted value to the index of its definition in
+     *        `accepted_arguments`. Sorted by value so it can be binary
+     *        searched. Built once when the command is constructed.
+     *
+     */
+    std::vector<std::pair<std::string, size_t>> argument_index;
+
+    /**
+     * @brief Has bit `i` set if `accepted_arguments[i]` is required
+     *
+     */
+    uint64_t required_arguments = 0;
+
+    /**
+     * @brief The index of the first definition with no values, which accepts
+     *        any value as the leading token. -1 if there is none.
+     *
+     */
+    int any_value_argument = -1;
+
     /**
      * @brief The callback to run when this command needs to be executed.
      *
      */
-    void (*callback)(std::vector<Argument>) = nullptr;
+    CommandCallback callback;
 
     /**
-     * @brief Get the required arguments for this command
+     * @brief Builds `argument_index` and `required_arguments` from
+     *        `accepted_arguments`
      *
-     * @return std::vector<ArgumentDefinition> const& A vector containing the
-     *         that are required by this command
+     * @throw TooManyArgumentDefinitionsException
      */
-    std::vector<ArgumentDefinition> const get_required_arguments() const;
+    void index_arguments();
 
     /**
-     * @brief Used to check that a list of arguments contains all the required
-     *        arguments for this command
+     * @brief Used to check that a set of matched argument definitions contains
+     *        all the required arguments for this command
      *
-     * @return true If all the required arguments are in the argument vector.
+     * @param found_arguments A mask with bit `i` set if `accepted_arguments[i]`
+     *        was found, as returned by get_arguments
+     * @return true If all the required arguments were found.
      * @return false If there were missing required arguments.
      */
-    bool check_required_arguments(std::vector<Argument> arguments) const;
+    bool check_required_arguments(uint64_t found_arguments) const;
 
     /**
      * @brief This function matches a string to an ArgumentDefinition value.
@@ -140,31 +193,48 @@ private:
      *         `nullptr` is returned.
      */
     ArgumentDefinition const *find_argument(
-        std::string const &argument_string) const;
+        std::string_view argument_string) const;
 
     /**
-     * @brief This function converts a vector of argument strings into a vector
-     *        of Argument objects
-     *
-     * @return std::vector<Argument> const& The list of parsed arguments
+     * @brief This function groups a list of tokens into argument views. The
+     *        parameters of each argument refer directly into `tokens`.
      *
-     * @throw ArgumentParseException
+     * @param tokens The tokens to group
+     * @param arguments Storage for the result. It is cleared and refilled.
+     * @param found_arguments Set to a mask with bit `i` set if
+     *        `accepted_arguments[i]` was among the arguments
+     * @return ParseError What went wrong, if anything
      */
-    std::vector<Argument> get_arguments(
-        std::vector<std::string> const &argument_strings) const;
+    ParseError get_arguments(
+        TokenSpan tokens,
+        std::vector<ArgumentView> &arguments,
+        uint64_t &found_arguments) const;
 
 public:
     /**
      * @brief Construct a new Command object
      *
      * @param name The name of the command
-     * @param accepted_arguments A vector containing the arguments that this command accepts
+     * @param accepted_arguments A vector containing the arguments that this
+     *        command accepts. At most 64 definitions are supported.
+     *
+     * @throw TooManyArgumentDefinitionsException
      */
     Command(
         std::string const &name,
         std::vector<ArgumentDefinition> const &accepted_arguments)
         : name(name), accepted_arguments(accepted_arguments)
     {
+        index_arguments();
+    }
+
+    /**
+     * @brief Get the name of the command
+     *
+     */
+    std::string const &get_name() const
+    {
+        return name;
     }
 
     /**
@@ -179,6 +249,37 @@ public:
     std::vector<Argument> parse_arguments(
         std::vector<std::string> const &argument_strings) const;
 
+    /**
+     * @brief Parses a list of tokens into argument views without copying any
+     *        strings. The views refer into `tokens` (and whatever buffer the
+     *        tokens refer to), so they are only valid for as long as those are.
+     *
+     * @param tokens The tokens to parse, eg. from Parser::tokenise
+     * @param arguments Storage for the parsed arguments. It is cleared and
+     *        refilled, so reusing it between calls avoids allocation.
+     * @return std::vector<ArgumentView>& A reference to `arguments`
+     *
+     * @throw ArgumentParseException
+     * @throw MissingArgumentException
+     */
+    std::vector<ArgumentView> &parse_arguments(
+        TokenSpan tokens,
+        std::vector<ArgumentView> &arguments) const;
+
+    /**
+     * @brief Parses a list of tokens into argument views like parse_arguments,
+     *        but reports errors through the result instead of throwing, so bad
+     *        input costs no more than good input.
+     *
+     * @param tokens The tokens to parse, eg. from Parser::tokenise
+     * @param arguments Storage for the parsed arguments
+     * @return ParseResult<std::vector<ArgumentView>> `arguments`, or the error
+     *         and its byte offset from the start of the first token
+     */
+    ParseResult<std::vector<ArgumentView>> try_parse_arguments(
+        TokenSpan tokens,
+        std::vector<ArgumentView> &arguments) const;
+
     /**
      * @brief Issues the command over stdout with the given arguments
      *
@@ -188,19 +289,47 @@ public:
     void issue(std::vector<std::string> const &arguments) const;
 
     /**
-     * @brief Attach a callback function to this command. The callback will be
-     *        run when this command needs to be executed
+     * @brief Issues the command through an output writer with the given
+     *        arguments. The writer decides when it reaches its sink.
+     *
+     * @throw ArgumentParseException
+     * @throw MissingArgumentException
+     */
+    void issue(std::vector<std::string> const &arguments, OutputWriter &output) const;
+
+    /**
+     * @brief Attach a callback to this command. The callback will be run when
+     *        this command needs to be executed
+     *
+     * @param callback
+     */
+    void attach_callback(CommandCallback callback);
+
+    /**
+     * @brief Attach a callback function that takes owning copies of the
+     *        arguments. Each run copies every argument, prefer a
+     *        CommandCallback.
      *
      * @param callback
      */
     void attach_callback(void (*callback)(std::vector<Argument>));
 
     /**
-     * @brief Executes this command
+     * @brief Check whether a callback is attached
+     *
+     */
+    bool has_callback() const
+    {
+        return static_cast<bool>(callback);
+    }
+
+    /**
+     * @brief Executes this command. Does nothing if no callback is attached.
+     *        Nothing is copied or allocated.
      *
      * @param arguments The arguments to execute the command with.
      */
-    void run(std::vector<Argument> arguments);
+    void run(ArgumentSpan arguments) const;
 };
 
 } // namespace chesspp
@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <utility>
+
+#include "command_table.hpp"
+
+size_t chesspp::CommandTable::overflow_hash(std::string_view name)
+{
+    uint64_t hash = 0xcbf29ce484222325u;
+    for (char const c : name)
+    {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3u;
+    }
+    return static_cast<size_t>(hash);
+}
+
+void chesspp::CommandTable::insert_overflow(Command *command)
+{
+    size_t const mask = overflow_slots.size() - 1;
+    size_t slot = overflow_hash(command->get_name()) & mask;
+    while (overflow_slots[slot] != nullptr)
+    {
+        slot = (slot + 1) & mask;
+    }
+    overflow_slots[slot] = command;
+}
+
+chesspp::Command *chesspp::CommandTable::find_overflow(std::string_view name) const
+{
+    size_t const mask = overflow_slots.size() - 1;
+    for (size_t slot = overflow_hash(name) & mask; overflow_slots[slot] != nullptr; slot = (slot + 1) & mask)
+    {
+        if (overflow_slots[slot]->get_name() == name)
+        {
+            return overflow_slots[slot];
+        }
+    }
+    return nullptr;
+}
+
+chesspp::Command *chesspp::CommandTable::add(Command command)
+{
+    if (find(command.get_name()) != nullptr)
+    {
+        return nullptr;
+    }
+
+    commands.push_back(std::move(command));
+    Command *const added = &commands.back();
+    std::string_view const name = added->get_name();
+
+    if (standard_hash::is_standard(name))
+    {
+        standard_slots[standard_hash::slot(name)] = added;
+        return added;
+    }
+
+    // Keep the overflow table at most half full so probes stay short
+    overflow_size++;
+    if (overflow_size * 2 > overflow_slots.size())
+    {
+        overflow_slots.assign(std::max<size_t>(16, overflow_slots.size() * 2), nullptr);
+        for (Command &existing : commands)
+        {
+            if (not standard_hash::is_standard(existing.get_name()))
+            {
+                insert_overflow(&existing);
+            }
+        }
+    }
+    else
+    {
+        insert_overflow(added);
+    }
+    return added;
+}
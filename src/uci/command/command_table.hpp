@@ -0,0 +1,239 @@
+/**
+ * @file command_table.hpp
+ * @brief Finds commands by name with a perfect hash over the standard verbs
+ *
+ */
+
+#ifndef SRC_UCI_COMMAND_COMMAND_TABLE_H
+#define SRC_UCI_COMMAND_COMMAND_TABLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string_view>
+#include <vector>
+
+#include "command.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief A perfect hash over the names of the standard UCI commands, in both
+ *        directions
+ *
+ */
+namespace standard_hash
+{
+/**
+ * @brief The names the hash is perfect for
+ *
+ */
+inline constexpr std::string_view names[] = {
+    "uci", "debug", "isready", "setoption", "register", "ucinewgame", "position",
+    "go", "stop", "ponderhit", "quit", "id", "uciok", "readyok", "bestmove",
+    "copyprotection", "registration", "info", "option"};
+
+/**
+ * @brief log2 of the number of slots
+ *
+ */
+inline constexpr unsigned slot_bits = 6;
+
+inline constexpr size_t num_slots = size_t(1) << slot_bits;
+
+/**
+ * @brief Packs the length, the first two characters and the last character
+ *        into one word, which is enough to tell the standard names apart
+ *
+ */
+constexpr uint32_t key(std::string_view name)
+{
+    if (name.size() < 2)
+    {
+        return static_cast<uint32_t>(name.size());
+    }
+    return static_cast<uint32_t>(name.size()) |
+           static_cast<uint32_t>(static_cast<unsigned char>(name[0])) << 8 |
+           static_cast<uint32_t>(static_cast<unsigned char>(name[1])) << 16 |
+           static_cast<uint32_t>(static_cast<unsigned char>(name.back())) << 24;
+}
+
+/**
+ * @brief Multiplicative hash of a key into a slot
+ *
+ */
+constexpr size_t slot(uint32_t key, uint32_t multiplier)
+{
+    return static_cast<uint32_t>(key * multiplier) >> (32 - slot_bits);
+}
+
+/**
+ * @brief Finds the first multiplier that sends every standard name to its own
+ *        slot
+ *
+ */
+constexpr uint32_t find_multiplier()
+{
+    for (uint32_t multiplier = 0x9E3779B1u;; multiplier += 2)
+    {
+        bool used[num_slots] = {};
+        bool collision = false;
+        for (std::string_view const name : names)
+        {
+            size_t const index = slot(key(name), multiplier);
+            collision = collision or used[index];
+            used[index] = true;
+        }
+        if (not collision)
+        {
+            return multiplier;
+        }
+    }
+}
+
+inline constexpr uint32_t multiplier = find_multiplier();
+
+/**
+ * @brief Get the slot of a name. Every standard name has its own slot.
+ *
+ */
+constexpr size_t slot(std::string_view name)
+{
+    return slot(key(name), multiplier);
+}
+
+/**
+ * @brief Builds the table of which standard name is in each slot
+ *
+ */
+constexpr std::array<std::string_view, num_slots> make_slot_names()
+{
+    std::array<std::string_view, num_slots> slot_names = {};
+    for (std::string_view const name : names)
+    {
+        slot_names[slot(name)] = name;
+    }
+    return slot_names;
+}
+
+/**
+ * @brief The standard name in each slot, empty for unused slots
+ *
+ */
+inline constexpr std::array<std::string_view, num_slots> slot_names = make_slot_names();
+
+/**
+ * @brief Check whether a name is one of the standard names, with one hash
+ *        and one compare
+ *
+ */
+constexpr bool is_standard(std::string_view name)
+{
+    return not name.empty() and slot_names[slot(name)] == name;
+}
+} // namespace standard_hash
+
+/**
+ * @brief A set of commands that can be looked up by name.
+ *
+ * Standard UCI commands live in a perfect hash table, so finding one costs a
+ * hash of four characters and one string compare. Other commands (eg. vendor
+ * extensions) live in an open addressing overflow table that is only probed
+ * when the name is not a standard command in the table, so registering many
+ * custom commands does not slow down the standard ones.
+ *
+ * Commands are never moved once added, so pointers to them stay valid, even
+ * when the table itself is moved. It cannot be copied, as the copy's slots
+ * would point at the original's commands.
+ */
+class CommandTable
+{
+private:
+    /**
+     * @brief The commands, in the order they were added
+     *
+     */
+    std::deque<Command> commands;
+
+    /**
+     * @brief The standard commands by standard_hash::slot
+     *
+     */
+    std::array<Command *, standard_hash::num_slots> standard_slots = {};
+
+    /**
+     * @brief The other commands, by a hash of their name with linear probing.
+     *        Its size is a power of two, at least twice the number of
+     *        commands in it.
+     *
+     */
+    std::vector<Command *> overflow_slots;
+
+    /**
+     * @brief The number of commands in `overflow_slots`
+     *
+     */
+    size_t overflow_size = 0;
+
+    /**
+     * @brief FNV-1a hash of a name, for the overflow table
+     *
+     */
+    static size_t overflow_hash(std::string_view name);
+
+    /**
+     * @brief Puts a command in the overflow table. The table must have room.
+     *
+     */
+    void insert_overflow(Command *command);
+
+    /**
+     * @brief Finds a command in the overflow table
+     *
+     */
+    Command *find_overflow(std::string_view name) const;
+
+public:
+    CommandTable() = default;
+    CommandTable(CommandTable const &) = delete;
+    CommandTable &operator=(CommandTable const &) = delete;
+    CommandTable(CommandTable &&) = default;
+    CommandTable &operator=(CommandTable &&) = default;
+
+    /**
+     * @brief Adds a command
+     *
+     * @return Command* The command in the table, or `nullptr` if there is
+     *         already a command by that name
+     */
+    Command *add(Command command);
+
+    /**
+     * @brief Find a command by name
+     *
+     * @return Command* The command, or `nullptr` if there is none by that name
+     */
+    Command *find(std::string_view name) const
+    {
+        Command *const command = standard_slots[standard_hash::slot(name)];
+        if (command != nullptr and command->get_name() == name)
+        {
+            return command;
+        }
+        return overflow_size == 0 ? nullptr : find_overflow(name);
+    }
+
+    /**
+     * @brief Get the number of commands
+     *
+     */
+    size_t size() const
+    {
+        return commands.size();
+    }
+};
+
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,439 @@
+/**
+ * @file grammar.hpp
+ * @brief Compile time tables describing the standard UCI commands
+ *
+ */
+
+#ifndef SRC_UCI_COMMAND_GRAMMAR_H
+#define SRC_UCI_COMMAND_GRAMMAR_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chesspp/argument.hpp"
+#include "command.hpp"
+#include "group_arguments.hpp"
+
+namespace chesspp
+{
+
+/**
+ * @brief The compile time equivalent of an ArgumentDefinition
+ *
+ */
+struct StaticArgumentDefinition
+{
+    /**
+     * @brief The most values a single definition can have
+     *
+     */
+    static constexpr size_t max_values = 3;
+
+    /**
+     * @brief Acceptable values for the argument. Only the first `num_values`
+     *        are used. If there are none the argument accepts any value as
+     *        the leading token (see ArgumentDefinition::values).
+     *
+     */
+    std::array<std::string_view, max_values> values = {};
+
+    /**
+     * @brief The number of entries in `values` that are used
+     *
+     */
+    size_t num_values = 0;
+
+    /**
+     * @brief See ArgumentDefinition::num_parameters
+     *
+     */
+    int num_parameters = 0;
+
+    /**
+     * @brief See ArgumentDefinition::required
+     *
+     */
+    bool required = false;
+
+    /**
+     * @brief Tag type for a definition that accepts any value
+     *
+     */
+    struct AnyValue
+    {
+    };
+
+    constexpr StaticArgumentDefinition() = default;
+
+    template <size_t M>
+    constexpr StaticArgumentDefinition(
+        std::string_view const (&values)[M],
+        int num_parameters = 0,
+        bool required = false)
+        : num_values(M), num_parameters(num_parameters), required(required)
+    {
+        static_assert(M <= max_values, "Too many values for one definition");
+        for (size_t i = 0; i < M; i++)
+        {
+            this->values[i] = values[i];
+        }
+    }
+
+    constexpr StaticArgumentDefinition(
+        AnyValue, int num_parameters = 0, bool required = false)
+        : num_parameters(num_parameters), required(required)
+    {
+    }
+};
+
+/**
+ * @brief Used in place of a list of values for a definition that accepts any
+ *        value as the leading token
+ *
+ */
+inline constexpr StaticArgumentDefinition::AnyValue any_value;
+
+/**
+ * @brief The compile time description of a command and its arguments
+ *
+ * @tparam N The number of argument definitions
+ */
+template <size_t N>
+struct CommandGrammar
+{
+    /**
+     * @brief The name of the command (eg. "debug")
+     *
+     */
+    std::string_view name;
+
+    /**
+     * @brief The arguments the command accepts
+     *
+     */
+    std::array<StaticArgumentDefinition, N> arguments = {};
+
+    /**
+     * @brief Checks that no value is accepted by more than one definition and
+     *        that the definitions fit in a 64 bit mask
+     *
+     */
+    constexpr bool is_valid() const
+    {
+        if (N > 64)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < N; i++)
+        {
+            for (size_t j = 0; j < arguments[i].num_values; j++)
+            {
+                for (size_t k = i; k < N; k++)
+                {
+                    for (size_t l = (k == i ? j + 1 : 0); l < arguments[k].num_values; l++)
+                    {
+                        if (arguments[i].values[j] == arguments[k].values[l])
+                        {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Builds the equivalent runtime Command
+     *
+     */
+    Command to_command() const
+    {
+        std::vector<ArgumentDefinition> accepted_arguments;
+        for (StaticArgumentDefinition const &argument : arguments)
+        {
+            accepted_arguments.emplace_back(
+                std::vector<std::string>(
+                    argument.values.begin(), argument.values.begin() + argument.num_values),
+                argument.num_parameters,
+                argument.required);
+        }
+        return Command(std::string(name), accepted_arguments);
+    }
+};
+
+/**
+ * @brief Makes the grammar for a command that takes no arguments
+ *
+ */
+constexpr CommandGrammar<0> make_grammar(std::string_view name)
+{
+    return CommandGrammar<0>{name};
+}
+
+/**
+ * @brief Makes the grammar for a command
+ *
+ * @param name The name of the command
+ * @param arguments The arguments the command accepts
+ */
+template <size_t N>
+constexpr CommandGrammar<N> make_grammar(
+    std::string_view name, StaticArgumentDefinition const (&arguments)[N])
+{
+    CommandGrammar<N> grammar{name};
+    for (size_t i = 0; i < N; i++)
+    {
+        grammar.arguments[i] = arguments[i];
+    }
+    return grammar;
+}
+
+/**
+ * @brief A command whose grammar is known at compile time. Keywords are
+ *        matched against the constant table, so no allocation happens at
+ *        startup and the optimiser can unroll the lookup. Parsing behaves
+ *        exactly like the equivalent runtime Command.
+ *
+ * @tparam Grammar A CommandGrammar with static storage duration
+ */
+template <auto const &Grammar>
+class StaticCommand
+{
+    static_assert(Grammar.is_valid(),
+                  "A grammar may have at most 64 definitions and no repeated values");
+
+    static constexpr size_t num_arguments = Grammar.arguments.size();
+
+    static constexpr uint64_t find_required_arguments()
+    {
+        uint64_t required = 0;
+        for (size_t i = 0; i < num_arguments; i++)
+        {
+            if (Grammar.arguments[i].required)
+            {
+                required |= uint64_t(1) << i;
+            }
+        }
+        return required;
+    }
+
+    static constexpr int find_any_value_argument()
+    {
+        for (size_t i = 0; i < num_arguments; i++)
+        {
+            if (Grammar.arguments[i].num_values == 0)
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+public:
+    /**
+     * @brief The name of the command (eg. "debug")
+     *
+     */
+    static constexpr std::string_view name = Grammar.name;
+
+    /**
+     * @brief Has bit `i` set if definition `i` is required
+     *
+     */
+    static constexpr uint64_t required_arguments = find_required_arguments();
+
+    /**
+     * @brief Matches a token against the argument definitions
+     *
+     * @param token The token to match
+     * @param leading Whether the token is the first argument token
+     */
+    static constexpr ArgumentMatch find_argument(std::string_view token, bool leading = false)
+    {
+        for (size_t i = 0; i < num_arguments; i++)
+        {
+            StaticArgumentDefinition const &argument = Grammar.arguments[i];
+            for (size_t j = 0; j < argument.num_values; j++)
+            {
+                if (argument.values[j] == token)
+                {
+                    return ArgumentMatch{static_cast<int>(i), argument.num_parameters};
+                }
+            }
+        }
+
+        constexpr int any_value = find_any_value_argument();
+        if (leading and any_value != -1)
+        {
+            return ArgumentMatch{any_value, Grammar.arguments[any_value].num_parameters};
+        }
+        return ArgumentMatch();
+    }
+
+    /**
+     * @brief Parses a list of tokens into argument views, see
+     *        Command::parse_arguments
+     *
+     * @throw ArgumentParseException
+     * @throw MissingArgumentException
+     */
+    static std::vector<ArgumentView> &parse_arguments(
+        TokenSpan tokens,
+        std::vector<ArgumentView> &arguments)
+    {
+        ParseResult<std::vector<ArgumentView>> const result = try_parse_arguments(tokens, arguments);
+        if (not result)
+        {
+            throw_parse_error(result.error());
+        }
+        return *result;
+    }
+
+    /**
+     * @brief Parses a list of tokens into argument views without throwing,
+     *        see Command::try_parse_arguments
+     *
+     */
+    static ParseResult<std::vector<ArgumentView>> try_parse_arguments(
+        TokenSpan tokens,
+        std::vector<ArgumentView> &arguments)
+    {
+        uint64_t found_arguments = 0;
+        ParseError const error = group_arguments(tokens, arguments, &find_argument, found_arguments);
+        if (error.code != ParseErrorCode::none)
+        {
+            return error;
+        }
+        if ((found_arguments & required_arguments) != required_arguments)
+        {
+            return ParseError{ParseErrorCode::missing_argument, end_offset(tokens)};
+        }
+        return arguments;
+    }
+
+    /**
+     * @brief Builds the equivalent runtime Command
+     *
+     */
+    static Command to_command()
+    {
+        return Grammar.to_command();
+    }
+};
+
+/**
+ * @brief The standard UCI commands as described in engine-interface.txt
+ *
+ */
+namespace grammar
+{
+
+/*******************************************************************************
+ *                              GUI to engine
+*******************************************************************************/
+
+inline constexpr auto uci = make_grammar("uci");
+
+inline constexpr auto debug = make_grammar("debug", {
+    {{"on", "off"}, 0, true}});
+
+inline constexpr auto isready = make_grammar("isready");
+
+inline constexpr auto setoption = make_grammar("setoption", {
+    {{"name"}, -1, true},
+    {{"value"}, -1}});
+
+inline constexpr auto register_ = make_grammar("register", {
+    {{"later"}, 0},
+    {{"name"}, -1},
+    {{"code"}, -1}});
+
+inline constexpr auto ucinewgame = make_grammar("ucinewgame");
+
+inline constexpr auto position = make_grammar("position", {
+    {{"fen"}, -1},
+    {{"startpos"}, 0},
+    {{"moves"}, -1}});
+
+inline constexpr auto go = make_grammar("go", {
+    {{"searchmoves"}, -1},
+    {{"ponder"}, 0},
+    {{"wtime"}, 1},
+    {{"btime"}, 1},
+    {{"winc"}, 1},
+    {{"binc"}, 1},
+    {{"movestogo"}, 1},
+    {{"depth"}, 1},
+    {{"nodes"}, 1},
+    {{"mate"}, 1},
+    {{"movetime"}, 1},
+    {{"infinite"}, 0}});
+
+inline constexpr auto stop = make_grammar("stop");
+
+inline constexpr auto ponderhit = make_grammar("ponderhit");
+
+inline constexpr auto quit = make_grammar("quit");
+
+/*******************************************************************************
+ *                              Engine to GUI
+*******************************************************************************/
+
+inline constexpr auto id = make_grammar("id", {
+    {{"name"}, -1},
+    {{"author"}, -1}});
+
+inline constexpr auto uciok = make_grammar("uciok");
+
+inline constexpr auto readyok = make_grammar("readyok");
+
+inline constexpr auto bestmove = make_grammar("bestmove", {
+    {any_value, 0, true},
+    {{"ponder"}, 1}});
+
+inline constexpr auto copyprotection = make_grammar("copyprotection", {
+    {{"checking", "ok", "error"}, 0, true}});
+
+inline constexpr auto registration = make_grammar("registration", {
+    {{"checking", "ok", "error"}, 0, true}});
+
+inline constexpr auto info = make_grammar("info", {
+    {{"depth"}, 1},
+    {{"seldepth"}, 1},
+    {{"time"}, 1},
+    {{"nodes"}, 1},
+    {{"pv"}, -1},
+    {{"multipv"}, 1},
+    {{"score"}, 0},
+    {{"cp"}, 1},
+    {{"mate"}, 1},
+    {{"lowerbound"}, 0},
+    {{"upperbound"}, 0},
+    {{"currmove"}, 1},
+    {{"currmovenumber"}, 1},
+    {{"hashfull"}, 1},
+    {{"nps"}, 1},
+    {{"tbhits"}, 1},
+    {{"sbhits"}, 1},
+    {{"cpuload"}, 1},
+    {{"string"}, -1},
+    {{"refutation"}, -1},
+    {{"currline"}, -1}});
+
+inline constexpr auto option = make_grammar("option", {
+    {{"name"}, -1, true},
+    {{"type"}, 1},
+    {{"default"}, -1},
+    {{"min"}, 1},
+    {{"max"}, 1},
+    {{"var"}, -1}});
+
+} // namespace grammar
+
+} // namespace chesspp
+
+#endif
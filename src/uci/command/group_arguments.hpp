@@ -0,0 +1,138 @@
+/**
+ * @file group_arguments.hpp
+ * @brief Groups tokens into arguments. Shared by the runtime Command and the
+ *        compile time StaticCommand, which only differ in how they look up
+ *        argument definitions.
+ *
+ */
+
+#ifndef SRC_UCI_COMMAND_GROUP_ARGUMENTS_H
+#define SRC_UCI_COMMAND_GROUP_ARGUMENTS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "chesspp/argument.hpp"
+#include "parse_result.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief The result of looking up a token in a command's argument definitions
+ *
+ */
+struct ArgumentMatch
+{
+    /**
+     * @brief The index of the matching definition, or -1 if nothing matched
+     *
+     */
+    int index = -1;
+
+    /**
+     * @brief The number of parameters the matching definition expects
+     *
+     */
+    int num_parameters = 0;
+};
+
+/**
+ * @brief Get the byte offset of a token from the start of the first token
+ *
+ */
+inline size_t token_offset(TokenSpan tokens, std::string_view token)
+{
+    return tokens.empty() ? 0 : static_cast<size_t>(token.data() - tokens[0].data());
+}
+
+/**
+ * @brief Get the byte offset of the end of the last token from the start of
+ *        the first token
+ *
+ */
+inline size_t end_offset(TokenSpan tokens)
+{
+    if (tokens.empty())
+    {
+        return 0;
+    }
+    std::string_view const &last = tokens[tokens.size() - 1];
+    return token_offset(tokens, last) + last.size();
+}
+
+/**
+ * @brief Groups a list of tokens into argument views. The parameters of each
+ *        argument refer directly into `tokens`.
+ *
+ * @param tokens The tokens to group
+ * @param arguments Storage for the result. It is cleared and refilled.
+ * @param find Looks up a definition: `find(token, leading)` returns an
+ *        ArgumentMatch, where `leading` is true for the first token (which
+ *        may match a definition that accepts any value).
+ * @param found_arguments Set to a mask with bit `i` set if definition `i` was
+ *        among the arguments
+ * @return ParseError What went wrong, if anything. Points at the last token
+ *         that could not be attached to an argument.
+ */
+template <typename Find>
+inline ParseError group_arguments(
+    TokenSpan tokens,
+    std::vector<ArgumentView> &arguments,
+    Find const &find,
+    uint64_t &found_arguments)
+{
+    arguments.clear();
+
+    // The definitions that have been matched so far
+    found_arguments = 0;
+
+    // The number of tokens seen since the last argument. Since parameters
+    // always directly follow their argument they are a contiguous range of
+    // `tokens`, so we only need to count them.
+    size_t num_parameters = 0;
+
+    // Start parsing tokens from the back to the front.
+    for (size_t i = tokens.size(); i-- > 0;)
+    {
+        // Try to find a matching argument definition
+        ArgumentMatch const match = find(tokens[i], i == 0);
+
+        // If the token does not match an argument definition then count it as
+        // a parameter.
+        if (match.index < 0 or (match.num_parameters != -1 and
+                                static_cast<size_t>(match.num_parameters) != num_parameters))
+        {
+            num_parameters++;
+        }
+
+        // Otherwise add it to the argument list
+        else
+        {
+            TokenSpan const parameters = {tokens.begin() + i + 1, num_parameters};
+            arguments.push_back(ArgumentView{tokens[i], parameters});
+            found_arguments |= uint64_t(1) << match.index;
+
+            // Start counting parameters for the new argument.
+            num_parameters = 0;
+        }
+    }
+
+    // If something went wrong we will have some parameters left over
+    if (num_parameters != 0)
+    {
+        return ParseError{
+            ParseErrorCode::unparsable_arguments,
+            token_offset(tokens, tokens[num_parameters - 1])};
+    }
+
+    // Reverse arguments to get proper order, since we iterated in reverse.
+    std::reverse(arguments.begin(), arguments.end());
+
+    return ParseError();
+}
+
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,148 @@
+/**
+ * @file parse_result.hpp
+ * @brief The result of parsing arguments without exceptions
+ *
+ */
+
+#ifndef SRC_UCI_COMMAND_PARSE_RESULT_H
+#define SRC_UCI_COMMAND_PARSE_RESULT_H
+
+#include <cstddef>
+#include <cstdlib>
+
+/**
+ * @brief 1 if the library is being compiled with exceptions enabled, 0 if
+ *        with -fno-exceptions
+ *
+ */
+#if defined(__cpp_exceptions) or defined(__EXCEPTIONS)
+#define CHESSPP_HAS_EXCEPTIONS 1
+#else
+#define CHESSPP_HAS_EXCEPTIONS 0
+#endif
+
+namespace chesspp
+{
+/**
+ * @brief Why a list of arguments could not be parsed
+ *
+ */
+enum class ParseErrorCode
+{
+    none,
+
+    /**
+     * @brief Some tokens could not be grouped into arguments. Reported as
+     *        ArgumentParseException by the throwing API.
+     *
+     */
+    unparsable_arguments,
+
+    /**
+     * @brief A required argument is missing. Reported as
+     *        MissingArgumentException by the throwing API.
+     *
+     */
+    missing_argument
+};
+
+/**
+ * @brief What went wrong while parsing, and where
+ *
+ */
+struct ParseError
+{
+    ParseErrorCode code = ParseErrorCode::none;
+
+    /**
+     * @brief The byte offset of the last token that could not be attached to
+     *        an argument, or of the end of the tokens for a missing argument.
+     *        Tokens are grouped from the back, so this is where the grouping
+     *        broke down, eg. `btime` in `wtime 10 btime`. Measured from the
+     *        start of the first token that was parsed, or from the start of
+     *        the line when parsed through a LineArena.
+     *
+     */
+    size_t offset = 0;
+};
+
+/**
+ * @brief Either a reference to a parsed value or a ParseError, in the style
+ *        of std::expected
+ *
+ * @tparam T The type of the parsed value
+ */
+template <typename T>
+class ParseResult
+{
+private:
+    T *parsed = nullptr;
+    ParseError parse_error;
+
+public:
+    ParseResult(T &value) : parsed(&value)
+    {
+    }
+
+    ParseResult(ParseError error) : parse_error(error)
+    {
+    }
+
+    bool has_value() const
+    {
+        return parsed != nullptr;
+    }
+
+    explicit operator bool() const
+    {
+        return has_value();
+    }
+
+    /**
+     * @brief Get the parsed value. Only valid if has_value() is true.
+     *
+     */
+    T &value() const
+    {
+        return *parsed;
+    }
+
+    T &operator*() const
+    {
+        return *parsed;
+    }
+
+    T *operator->() const
+    {
+        return parsed;
+    }
+
+    /**
+     * @brief Get the error. Its code is ParseErrorCode::none if there is a
+     *        value.
+     *
+     */
+    ParseError error() const
+    {
+        return parse_error;
+    }
+};
+
+/**
+ * @brief Throws an exception, or aborts when compiled without exceptions
+ *
+ */
+template <typename Exception>
+[[noreturn]] void throw_exception(Exception const &exception)
+{
+#if CHESSPP_HAS_EXCEPTIONS
+    throw exception;
+#else
+    static_cast<void>(exception);
+    std::abort();
+#endif
+}
+
+} // namespace chesspp
+
+#endif
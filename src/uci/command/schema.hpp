@@ -0,0 +1,260 @@
+/**
+ * @file schema.hpp
+ * @brief Decodes parsed arguments straight into the fields of a struct
+ *
+ */
+
+#ifndef SRC_UCI_COMMAND_SCHEMA_H
+#define SRC_UCI_COMMAND_SCHEMA_H
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "chesspp/argument.hpp"
+#include "../chess/move.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief Why an argument could not be decoded
+ *
+ */
+enum class DecodeError
+{
+    none,
+
+    /**
+     * @brief A number was malformed or out of range
+     *
+     */
+    malformed_number,
+
+    /**
+     * @brief A move was not in long algebraic notation
+     *
+     */
+    malformed_move,
+
+    /**
+     * @brief An argument had the wrong number of parameters
+     *
+     */
+    wrong_parameter_count,
+
+    /**
+     * @brief An argument has no field in the schema
+     *
+     */
+    unknown_argument
+};
+
+/**
+ * @brief The outcome of decoding a list of arguments
+ *
+ */
+struct DecodeResult
+{
+    DecodeError error = DecodeError::none;
+
+    /**
+     * @brief The argument that could not be decoded
+     *
+     */
+    std::string_view argument;
+
+    explicit operator bool() const
+    {
+        return error == DecodeError::none;
+    }
+};
+
+/**
+ * @brief A fixed capacity list of packed moves, so that a struct holding one
+ *        stays flat
+ *
+ * @tparam Capacity The most moves the list can hold
+ */
+template <size_t Capacity>
+struct MoveList
+{
+    std::array<Move, Capacity> moves = {};
+    size_t count = 0;
+
+    Move const *begin() const { return moves.data(); }
+    Move const *end() const { return moves.data() + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+};
+
+/**
+ * @brief Decodes the parameters of an argument into a field. Overloaded for
+ *        each supported field type.
+ *
+ */
+namespace field_decoder
+{
+/**
+ * @brief A flag is set by its keyword alone
+ *
+ */
+inline DecodeError decode(TokenSpan parameters, bool &field)
+{
+    field = true;
+    return parameters.empty() ? DecodeError::none : DecodeError::wrong_parameter_count;
+}
+
+/**
+ * @brief An integer is decoded with std::from_chars and must take up the
+ *        whole token
+ *
+ */
+template <typename Integer>
+std::enable_if_t<std::is_integral_v<Integer>, DecodeError> decode(TokenSpan parameters, Integer &field)
+{
+    if (parameters.size() != 1)
+    {
+        return DecodeError::wrong_parameter_count;
+    }
+    std::string_view const text = parameters[0];
+    char const *const end = text.data() + text.size();
+    std::from_chars_result const result = std::from_chars(text.data(), end, field);
+    return result.ec == std::errc() and result.ptr == end ? DecodeError::none
+                                                          : DecodeError::malformed_number;
+}
+
+/**
+ * @brief Moves are decoded into packed moves
+ *
+ */
+template <size_t Capacity>
+DecodeError decode(TokenSpan parameters, MoveList<Capacity> &field)
+{
+    if (parameters.size() > Capacity)
+    {
+        return DecodeError::wrong_parameter_count;
+    }
+    field.count = parameters.size();
+    for (size_t i = 0; i < parameters.size(); i++)
+    {
+        if (not Move::from_uci(parameters[i], field.moves[i]))
+        {
+            field.count = 0;
+            return DecodeError::malformed_move;
+        }
+    }
+    return DecodeError::none;
+}
+
+template <typename Member>
+struct MemberTraits;
+
+template <typename Struct, typename Field>
+struct MemberTraits<Field Struct::*>
+{
+    using StructType = Struct;
+};
+
+/**
+ * @brief Decodes into the field `Member` points to
+ *
+ */
+template <auto Member>
+DecodeError decode_member(
+    TokenSpan parameters, typename MemberTraits<decltype(Member)>::StructType &out)
+{
+    return decode(parameters, out.*Member);
+}
+} // namespace field_decoder
+
+/**
+ * @brief Binds an argument keyword to a field of `Struct`
+ *
+ */
+template <typename Struct>
+struct SchemaField
+{
+    std::string_view keyword;
+    DecodeError (*decode)(TokenSpan parameters, Struct &out) = nullptr;
+};
+
+/**
+ * @brief Binds an argument keyword to a field. The field's type decides how
+ *        the parameters are decoded: `bool` for flags, integer types for
+ *        numbers and MoveList for moves.
+ *
+ */
+template <auto Member>
+constexpr auto field(std::string_view keyword)
+{
+    using Struct = typename field_decoder::MemberTraits<decltype(Member)>::StructType;
+    return SchemaField<Struct>{keyword, &field_decoder::decode_member<Member>};
+}
+
+/**
+ * @brief A typed description of a command's arguments: which field of
+ *        `Struct` each keyword is decoded into
+ *
+ * @tparam Struct The struct the arguments are decoded into
+ * @tparam N The number of fields
+ */
+template <typename Struct, size_t N>
+struct ArgumentSchema
+{
+    std::array<SchemaField<Struct>, N> fields;
+
+    /**
+     * @brief Decodes parsed arguments into `out`. Fields without an argument
+     *        are left alone, so `out` should start out with their defaults.
+     *        Never throws.
+     *
+     * @param arguments The parsed arguments, eg. from
+     *        StaticCommand::parse_arguments
+     * @param out The struct to decode into
+     * @return DecodeResult What went wrong, if anything. Decoding stops at the
+     *         first argument that can't be decoded.
+     */
+    DecodeResult decode(std::vector<ArgumentView> const &arguments, Struct &out) const
+    {
+        for (ArgumentView const &argument : arguments)
+        {
+            DecodeError error = DecodeError::unknown_argument;
+            for (SchemaField<Struct> const &field : fields)
+            {
+                if (field.keyword == argument.value)
+                {
+                    error = field.decode(argument.parameters, out);
+                    break;
+                }
+            }
+            if (error != DecodeError::none)
+            {
+                return DecodeResult{error, argument.value};
+            }
+        }
+        return DecodeResult();
+    }
+};
+
+/**
+ * @brief Makes a schema from a list of fields
+ *
+ */
+template <typename Struct, size_t N>
+constexpr ArgumentSchema<Struct, N> make_schema(SchemaField<Struct> const (&fields)[N])
+{
+    ArgumentSchema<Struct, N> schema{};
+    for (size_t i = 0; i < N; i++)
+    {
+        schema.fields[i] = fields[i];
+    }
+    return schema;
+}
+
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,405 @@
+#include <thread>
+#include <utility>
+
+#include "engine.hpp"
+#include "command/grammar.hpp"
+#include "instrumentation/report.hpp"
+#include "io/line_reader.hpp"
+
+chesspp::Engine::Engine(int input_fd, OutputWriter &output)
+    : Engine(fd_input, output)
+{
+    // The other constructor only binds `input` to `fd_input`, so it can be
+    // pointed at the descriptor afterwards
+    fd_input = FdSource(input_fd);
+}
+
+chesspp::Engine::Engine(InputSource &input, OutputWriter &output)
+    : fd_input(-1),
+      input(input),
+      output(output)
+{
+    for (Command command : {
+             grammar::uci.to_command(),
+             grammar::debug.to_command(),
+             grammar::isready.to_command(),
+             grammar::setoption.to_command(),
+             grammar::register_.to_command(),
+             grammar::ucinewgame.to_command(),
+             grammar::position.to_command(),
+             grammar::go.to_command(),
+             grammar::stop.to_command(),
+             grammar::ponderhit.to_command(),
+             grammar::quit.to_command(),
+         })
+    {
+        commands.add(std::move(command));
+    }
+
+    uci_command = find_command("uci");
+    setoption_command = find_command("setoption");
+    position_command = find_command("position");
+    ucinewgame_command = find_command("ucinewgame");
+    go_command = find_command("go");
+    debug_command = find_command("debug");
+
+    if constexpr (instrumentation::enabled)
+    {
+        Command *const stats = commands.add(Command("stats", {}));
+        stats->attach_callback([this](ArgumentSpan) {
+            if (debug_mode)
+            {
+                send_stats();
+            }
+        });
+    }
+}
+
+bool chesspp::Engine::register_command(std::string_view name, CommandCallback callback)
+{
+    Command *command = find_command(name);
+    if (command == nullptr)
+    {
+        return false;
+    }
+    command->attach_callback(std::move(callback));
+    return true;
+}
+
+bool chesspp::Engine::register_command(
+    std::string_view name, void (*callback)(std::vector<Argument>))
+{
+    Command *command = find_command(name);
+    if (command == nullptr)
+    {
+        return false;
+    }
+    command->attach_callback(callback);
+    return true;
+}
+
+void chesspp::Engine::register_position_callback(
+    InplaceFunction<void(PositionDelta const &)> callback)
+{
+    position_callback = std::move(callback);
+}
+
+void chesspp::Engine::register_go_callback(InplaceFunction<void(SearchLimits const &)> callback)
+{
+    go_callback = std::move(callback);
+}
+
+void chesspp::Engine::register_signal_callback(InplaceFunction<void(Signal)> callback)
+{
+    signal_callback = std::move(callback);
+}
+
+void chesspp::Engine::announce_options()
+{
+    options.announce(output);
+    options_announced = true;
+}
+
+void chesspp::Engine::set_recorder(Recorder *recorder)
+{
+    this->recorder = recorder;
+    output.set_recorder(recorder);
+}
+
+chesspp::StatsSnapshot chesspp::Engine::get_stats() const
+{
+    StatsSnapshot stats;
+    parse_latency.snapshot(stats.parse);
+    dispatch_latency.snapshot(stats.dispatch);
+    stats.bytes_in = bytes_read.load();
+    commands_read.snapshot(stats.commands_in);
+    output.get_stats(stats);
+    return stats;
+}
+
+void chesspp::Engine::send_stats()
+{
+    write_stats(output, get_stats());
+}
+
+bool chesspp::Engine::add_command(Command command)
+{
+    return commands.add(std::move(command)) != nullptr;
+}
+
+chesspp::Command *chesspp::Engine::find_command(std::string_view name)
+{
+    return commands.find(name);
+}
+
+size_t chesspp::Engine::find_command_token(TokenSpan tokens)
+{
+    for (size_t i = 0; i < tokens.size(); i++)
+    {
+        if (find_command(tokens[i]) != nullptr)
+        {
+            return i;
+        }
+    }
+    return tokens.size();
+}
+
+void chesspp::Engine::signal(TokenSpan tokens, bool queued)
+{
+    size_t const index = find_command_token(tokens);
+    if (index == tokens.size())
+    {
+        return;
+    }
+
+    std::string_view const name = tokens[index];
+    Signal received;
+    if (name == "stop")
+    {
+        stop_flag.store(searches_read + 1, std::memory_order_relaxed);
+        received = Signal::stop;
+    }
+    else if (name == "ponderhit")
+    {
+        ponderhit_flag.store(searches_read + 1, std::memory_order_relaxed);
+        received = Signal::ponderhit;
+    }
+    else if (name == "quit")
+    {
+        quit_flag.store(true, std::memory_order_relaxed);
+        received = Signal::quit;
+    }
+    else if (name == "go" and queued)
+    {
+        // Later signals are tagged with the new search. The flags are left
+        // alone, as the search they belong to may still be running.
+        searches_read++;
+        received = Signal::go;
+    }
+    else if (name == "ucinewgame")
+    {
+        received = Signal::ucinewgame;
+    }
+    else
+    {
+        return;
+    }
+
+    if (signal_callback)
+    {
+        signal_callback(received);
+    }
+}
+
+bool chesspp::Engine::receive(ReceivedCommand &received, TokenSpan tokens)
+{
+    size_t const index = find_command_token(tokens);
+    if (index == tokens.size())
+    {
+        return false;
+    }
+
+    received.command = find_command(tokens[index]);
+    ParseResult<std::vector<ArgumentView>> const result =
+        received.arena.try_parse_arguments(*received.command, tokens.subspan(index + 1));
+
+    // Lines that can't be parsed are ignored
+    if (not result)
+    {
+        return false;
+    }
+    received.arguments = &*result;
+    return true;
+}
+
+void chesspp::Engine::read_input()
+{
+    LineReader reader(input);
+    std::string_view line;
+    uint64_t counted_bytes = 0;
+    while (not quit_requested() and reader.next_line(line))
+    {
+        instrumentation::Timestamp const received_at = reader.received_at();
+        if constexpr (instrumentation::enabled)
+        {
+            bytes_read.add(reader.bytes_read() - counted_bytes);
+            counted_bytes = reader.bytes_read();
+        }
+        if (recorder != nullptr)
+        {
+            recorder->record(Direction::to_engine, line);
+        }
+
+        // Use the queue unless it is full or older commands are waiting in
+        // the overflow.
+        ReceivedCommand *received = nullptr;
+        std::unique_ptr<ReceivedCommand> overflowed;
+        if (overflow_size.load() == 0)
+        {
+            received = queue.acquire();
+        }
+        if (received == nullptr)
+        {
+            overflowed = std::make_unique<ReceivedCommand>();
+            received = overflowed.get();
+        }
+
+        TokenSpan const tokens = received->arena.tokenise(line);
+        bool const queued = receive(*received, tokens);
+        signal(tokens, queued);
+        if (not queued)
+        {
+            received->arena.reset();
+            continue;
+        }
+        received->received_at = received_at;
+        received->search = searches_read;
+        commands_read.add(received->command->get_name());
+        parse_latency.record_since(received_at);
+
+        if (overflowed)
+        {
+            std::lock_guard<std::mutex> lock(overflow_mutex);
+            overflow.push_back(std::move(overflowed));
+            overflow_size.fetch_add(1);
+        }
+        else
+        {
+            queue.publish();
+        }
+        wake_engine();
+    }
+
+    input_closed.store(true);
+    wake_engine();
+}
+
+void chesspp::Engine::wake_engine()
+{
+    if (waiting.load())
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        wake.notify_one();
+    }
+}
+
+chesspp::ReceivedCommand *chesspp::Engine::next_command()
+{
+    // Anything in the queue is older than anything in the overflow
+    if (ReceivedCommand *received = queue.front())
+    {
+        return received;
+    }
+    if (overflow_size.load() != 0)
+    {
+        std::lock_guard<std::mutex> lock(overflow_mutex);
+        running_overflow = std::move(overflow.front());
+        overflow.pop_front();
+        overflow_size.fetch_sub(1);
+        return running_overflow.get();
+    }
+    return nullptr;
+}
+
+void chesspp::Engine::finish_command()
+{
+    if (running_overflow)
+    {
+        running_overflow.reset();
+    }
+    else
+    {
+        queue.front()->arena.reset();
+        queue.release();
+    }
+}
+
+chesspp::ReceivedCommand *chesspp::Engine::wait_for_command()
+{
+    while (true)
+    {
+        if (ReceivedCommand *received = next_command())
+        {
+            return received;
+        }
+        if (input_closed.load())
+        {
+            // Anything added before the input closed is visible by now
+            return next_command();
+        }
+
+        // Nothing is left to do for now, so send anything the callbacks wrote
+        output.flush();
+        if (recorder != nullptr)
+        {
+            recorder->flush();
+        }
+
+        waiting.store(true);
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            wake.wait(lock, [this]() {
+                return queue.front() != nullptr or overflow_size.load() != 0 or
+                       input_closed.load();
+            });
+        }
+        waiting.store(false);
+    }
+}
+
+void chesspp::Engine::start()
+{
+    std::thread reader(&Engine::read_input, this);
+
+    while (ReceivedCommand *received = wait_for_command())
+    {
+        Command *const command = received->command;
+        std::vector<ArgumentView> const &arguments = *received->arguments;
+        dispatch_latency.record_since(received->received_at);
+        if (command == go_command)
+        {
+            running_search.store(received->search, std::memory_order_relaxed);
+        }
+
+        if (command == debug_command)
+        {
+            debug_mode = arguments[0].value == "on";
+        }
+        else if (command == uci_command)
+        {
+            options_announced = false;
+        }
+        else if (command == setoption_command)
+        {
+            options.set(arguments);
+        }
+        if (position_callback)
+        {
+            if (command == position_command)
+            {
+                position_callback(position_tracker.update(arguments));
+            }
+            else if (command == ucinewgame_command)
+            {
+                position_tracker.reset();
+            }
+        }
+        if (go_callback and command == go_command and
+            decode_search_limits(arguments, search_limits))
+        {
+            go_callback(search_limits);
+        }
+        command->run(arguments);
+        if (command == uci_command and not options_announced)
+        {
+            announce_options();
+        }
+        finish_command();
+    }
+
+    reader.join();
+    if (recorder != nullptr)
+    {
+        recorder->flush();
+    }
+}
@@ -1,18 +1,582 @@
+/**
+ * @file engine.hpp
+ * @brief The engine side of the Universal Chess Interface
+ *
+ */
+
 #ifndef CHESSPP_ENGINE_H
 #define CHESSPP_ENGINE_H
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "chesspp/argument.hpp"
+#include "chesspp/inplace_function.hpp"
+#include "chesspp/stats.hpp"
+#include "arena.hpp"
+#include "command/command.hpp"
+#include "command/command_table.hpp"
+#include "instrumentation/probes.hpp"
+#include "io/line_reader.hpp"
+#include "io/output_writer.hpp"
+#include "options.hpp"
+#include "position_tracker.hpp"
+#include "replay/recorder.hpp"
+#include "search_limits.hpp"
+#include "spsc_queue.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief A command received from the interface, parsed by the reader thread
+ *        and waiting to be run by the engine thread
+ *
+ */
+struct ReceivedCommand
+{
+    /**
+     * @brief Holds the line and everything parsed from it
+     *
+     */
+    LineArena arena;
+
+    /**
+     * @brief The command to run
+     *
+     */
+    Command *command = nullptr;
+
+    /**
+     * @brief The arguments to run the command with. Points into `arena`.
+     *
+     */
+    std::vector<ArgumentView> const *arguments = nullptr;
+
+    /**
+     * @brief When the line arrived
+     *
+     */
+    instrumentation::Timestamp received_at;
+
+    /**
+     * @brief The number of `go` commands read up to and including this one
+     *
+     */
+    uint64_t search = 0;
+};
+
+/**
+ * @brief The commands the reader thread reports the moment they are read,
+ *        before they are queued
+ *
+ */
+enum class Signal
+{
+    go,
+    stop,
+    ponderhit,
+    ucinewgame,
+    quit
+};
+
 /**
  * @brief Provides an API for a chess engine to use the Universal Chess
  *        Interface
+ *
+ * Input is read and parsed on a dedicated reader thread so the engine can
+ * always process input, even while thinking. Parsed commands are handed to
+ * the engine thread (the thread that calls start()) through a lock-free queue
+ * and their callbacks run there, in the order they were received.
+ *
+ * `stop`, `ponderhit` and `quit` also raise a flag as soon as they are read,
+ * before they are queued, so a search running inside a callback can notice
+ * them by polling stop_requested() and friends. Searches are numbered by
+ * their `go`, and `stop` and `ponderhit` are tagged with the search they
+ * follow, so one read while an earlier search is still running applies to
+ * that search and not to the next.
  */
 class Engine
 {
 private:
-    /* data */
+    /**
+     * @brief The number of parsed commands that can wait for the engine thread
+     *
+     */
+    static constexpr size_t queue_size = 64;
+
+    /**
+     * @brief The source used when constructed from a descriptor
+     *
+     */
+    FdSource fd_input;
+
+    /**
+     * @brief Where commands from the interface are read from
+     *
+     */
+    InputSource &input;
+
+    /**
+     * @brief Where commands to the interface are written. Flushed whenever the
+     *        engine thread runs out of commands to run.
+     *
+     */
+    OutputWriter &output;
+
+    /**
+     * @brief The commands the engine accepts from the interface
+     *
+     */
+    CommandTable commands;
+
+    /**
+     * @brief The `uci`, `setoption`, `position`, `ucinewgame`, `go` and
+     *        `debug` commands in `commands`
+     *
+     */
+    Command *uci_command;
+    Command *setoption_command;
+    Command *position_command;
+    Command *ucinewgame_command;
+    Command *go_command;
+    Command *debug_command;
+
+    /**
+     * @brief The engine's options, announced on `uci` and changed by
+     *        `setoption`
+     *
+     */
+    OptionRegistry options;
+
+    /**
+     * @brief Set once the options have been announced for the `uci` being
+     *        run. Only used by the engine thread.
+     *
+     */
+    bool options_announced = false;
+
+    /**
+     * @brief Whether the interface has switched debug mode on. Only used by
+     *        the engine thread.
+     *
+     */
+    bool debug_mode = false;
+
+    /**
+     * @brief Turns `position` commands into the moves that are new. Only used
+     *        by the engine thread, and only if `position_callback` is set.
+     *
+     */
+    PositionTracker position_tracker;
+
+    /**
+     * @brief The callback to run with the change in position for each
+     *        `position` command
+     *
+     */
+    InplaceFunction<void(PositionDelta const &)> position_callback;
+
+    /**
+     * @brief Storage for the decoded arguments of `go`, reused for each one
+     *
+     */
+    SearchLimits search_limits;
+
+    /**
+     * @brief The callback to run with the decoded arguments of each `go`
+     *
+     */
+    InplaceFunction<void(SearchLimits const &)> go_callback;
+
+    /**
+     * @brief The callback the reader thread runs for each Signal
+     *
+     */
+    InplaceFunction<void(Signal)> signal_callback;
+
+    /**
+     * @brief Hands parsed commands from the reader thread to the engine thread
+     *
+     */
+    SpscQueue<ReceivedCommand, queue_size> queue;
+
+    /**
+     * @brief Commands that arrived while the queue was full. The reader thread
+     *        never waits for the engine thread, otherwise a search waiting for
+     *        `stop` could never see it. Once anything is in here new commands
+     *        are added here too, to keep them in order, until it is empty.
+     *
+     */
+    std::deque<std::unique_ptr<ReceivedCommand>> overflow;
+    std::mutex overflow_mutex;
+
+    /**
+     * @brief The number of commands in `overflow`
+     *
+     */
+    std::atomic<size_t> overflow_size{0};
+
+    /**
+     * @brief The overflow command the engine thread is running, if any
+     *
+     */
+    std::unique_ptr<ReceivedCommand> running_overflow;
+
+    /**
+     * @brief The number of `go` commands the reader thread has read. Only
+     *        used by the reader thread.
+     *
+     */
+    uint64_t searches_read = 0;
+
+    /**
+     * @brief The number of the search the last `go` dispatched started
+     *
+     */
+    alignas(64) std::atomic<uint64_t> running_search{0};
+
+    /**
+     * @brief One more than the number of the search the last `stop`
+     *        followed, 0 if none has. A stop applies to that search and every
+     *        one before it.
+     *
+     */
+    alignas(64) std::atomic<uint64_t> stop_flag{0};
+
+    /**
+     * @brief One more than the number of the search the last `ponderhit`
+     *        followed, 0 if none has
+     *
+     */
+    alignas(64) std::atomic<uint64_t> ponderhit_flag{0};
+
+    /**
+     * @brief Set when `quit` is read
+     *
+     */
+    alignas(64) std::atomic<bool> quit_flag{false};
+
+    /**
+     * @brief Set by the reader thread once it will not queue anything else
+     *
+     */
+    std::atomic<bool> input_closed{false};
+
+    /**
+     * @brief Set while the engine thread is asleep waiting for a command. The
+     *        reader thread only touches `wake_mutex` when this is set.
+     *
+     */
+    std::atomic<bool> waiting{false};
+
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+
+    /**
+     * @brief Records every line read and written, if set
+     *
+     */
+    Recorder *recorder = nullptr;
+
+    /**
+     * @brief What the engine measures with CHESSPP_INSTRUMENTATION. Written
+     *        by the reader and engine threads, read by get_stats().
+     *
+     */
+    instrumentation::LatencyHistogram parse_latency;
+    instrumentation::LatencyHistogram dispatch_latency;
+    instrumentation::Counter bytes_read;
+    instrumentation::CommandCounters commands_read;
+
+    /**
+     * @brief Find a command by name
+     *
+     * @return Command* The command, or `nullptr` if there is none by that name
+     */
+    Command *find_command(std::string_view name);
+
+    /**
+     * @brief Finds the first token on a line that names a command. Unknown
+     *        tokens before it are ignored as the UCI specification requires.
+     *
+     * @return size_t The index of the token, or `tokens.size()` if none do
+     */
+    size_t find_command_token(TokenSpan tokens);
+
+    /**
+     * @brief Raises the fast path flags for the command on a line, and
+     *        counts `go`
+     *
+     * @param queued Whether the line will be queued. A `go` that is not
+     *        starts no search, so is not counted.
+     */
+    void signal(TokenSpan tokens, bool queued);
+
+    /**
+     * @brief Parses a line into a queue slot
+     *
+     * @return true If the line holds a valid command
+     * @return false If the line should be ignored
+     */
+    bool receive(ReceivedCommand &received, TokenSpan tokens);
+
+    /**
+     * @brief The body of the reader thread
+     *
+     */
+    void read_input();
+
+    /**
+     * @brief Wakes the engine thread if it is waiting for a command
+     *
+     */
+    void wake_engine();
+
+    /**
+     * @brief Get the next command to run, from the queue or the overflow.
+     *        Engine thread only.
+     *
+     * @return ReceivedCommand* The command or `nullptr` if there is none yet
+     */
+    ReceivedCommand *next_command();
+
+    /**
+     * @brief Hands the storage of the command returned by next_command back
+     *        to the reader thread. Engine thread only.
+     *
+     */
+    void finish_command();
+
+    /**
+     * @brief Blocks until a command is available or the input is closed
+     *
+     * @return ReceivedCommand* The next command or `nullptr` if the input is
+     *         closed and every command has been run
+     */
+    ReceivedCommand *wait_for_command();
+
 public:
+    /**
+     * @brief Construct a new Engine object
+     *
+     * @param input_fd The descriptor to read commands from the interface from.
+     *        Standard input by default. It is not closed by the engine.
+     * @param output Where commands to the interface are written
+     */
+    explicit Engine(int input_fd = 0, OutputWriter &output = OutputWriter::standard());
+
+    /**
+     * @brief Construct a new Engine object that reads from any source, eg.
+     *        the input of a Transport
+     *
+     * @param input Where to read commands from the interface from. Must
+     *        outlive the engine.
+     * @param output Where commands to the interface are written
+     */
+    Engine(InputSource &input, OutputWriter &output);
+
+    /**
+     * @brief Get the writer for commands to the interface
+     *
+     */
+    OutputWriter &get_output()
+    {
+        return output;
+    }
+
+    /**
+     * @brief Attach a callback to one of the commands the interface can send
+     *
+     * @param name The name of the command (eg. "debug")
+     * @param callback The callable to run when the command is received. It is
+     *        passed the arguments as a span that is only valid during the call.
+     * @return true If the callback was attached
+     * @return false If there is no command by that name
+     */
+    bool register_command(std::string_view name, CommandCallback callback);
+
+    /**
+     * @brief Adds a command the interface can send besides the standard ones
+     *        (eg. a vendor extension). Must be called before start().
+     *
+     * @param command The command. Attach its callback before or after adding
+     *        it, with register_command.
+     * @return true If the command was added
+     * @return false If there already is a command by that name
+     */
+    bool add_command(Command command);
+
+    /**
+     * @brief Attach a callback that takes owning copies of the arguments to
+     *        one of the commands the interface can send. Each run copies
+     *        every argument, prefer a CommandCallback.
+     *
+     * @param name The name of the command (eg. "debug")
+     * @param callback The function to run when the command is received
+     * @return true If the callback was attached
+     * @return false If there is no command by that name
+     */
+    bool register_command(
+        std::string_view name, void (*callback)(std::vector<Argument>));
+
+    /**
+     * @brief Attach a callback that receives only what changed for each
+     *        `position` command: while the interface keeps extending the same
+     *        game it is passed just the new moves, otherwise a full reset.
+     *        Runs before any callback attached to `position` itself. The
+     *        history is forgotten on `ucinewgame`.
+     *
+     * @param callback The callable to run with the change in position
+     */
+    void register_position_callback(InplaceFunction<void(PositionDelta const &)> callback);
+
+    /**
+     * @brief Attach a callback that receives the arguments of each `go`
+     *        decoded into SearchLimits, with no strings to parse. A `go` whose
+     *        arguments can't be decoded (eg. a malformed number) is ignored.
+     *        Runs before any callback attached to `go` itself.
+     *
+     * @param callback The callable to run with the search limits
+     */
+    void register_go_callback(InplaceFunction<void(SearchLimits const &)> callback);
+
+    /**
+     * @brief Attach a callback that the reader thread runs as soon as it
+     *        reads one of the commands in Signal, after the stop and
+     *        ponderhit flags and the search number have been updated and
+     *        before the command is queued. It runs on the reader thread, so it must be quick and
+     *        thread safe. Must be called before start().
+     *
+     * @param callback The callable to run with the command that was read
+     */
+    void register_signal_callback(InplaceFunction<void(Signal)> callback);
+
+    /**
+     * @brief Get the engine's options. Add them before start(). They are
+     *        announced by announce_options() when `uci` is received, and
+     *        `setoption` changes them before any callback attached to
+     *        `setoption` runs.
+     *
+     */
+    OptionRegistry &get_options()
+    {
+        return options;
+    }
+
+    /**
+     * @brief Writes an `option` line for each option to get_output(). Call
+     *        it from the callback attached to `uci`, after the `id` lines and
+     *        before `uciok`, writing all three to the same writer. If the
+     *        callback does not, the engine calls it once the callback
+     *        returns. Engine thread only.
+     *
+     */
+    void announce_options();
+
+    /**
+     * @brief Record every line read from the interface and written to it,
+     *        including lines that are ignored. Must be called before start().
+     *
+     * @param recorder The recorder, or `nullptr` to stop recording. Must
+     *        outlive the engine, or be replaced first.
+     */
+    void set_recorder(Recorder *recorder);
+
+    /**
+     * @brief Starts reading commands from the interface and running their
+     *        callbacks on the calling thread. Returns after `quit` has been
+     *        run, or once the input is closed and every command has been run.
+     *
+     */
+    void start();
+
+    /**
+     * @brief Check whether the interface has switched debug mode on with
+     *        `debug on`. Engine thread only.
+     *
+     */
+    bool debug_enabled() const
+    {
+        return debug_mode;
+    }
+
+    /**
+     * @brief Get a copy of the latency and throughput statistics. Can be
+     *        called from any thread. Everything is zero unless the library is
+     *        built with CHESSPP_INSTRUMENTATION.
+     *
+     */
+    StatsSnapshot get_stats() const;
+
+    /**
+     * @brief Writes the statistics to the interface as an `info string`.
+     *
+     * With CHESSPP_INSTRUMENTATION the engine also accepts a `stats` command,
+     * which does this while debug mode is on.
+     */
+    void send_stats();
+
+    /**
+     * @brief Get the number of the search started by the last `go`
+     *        dispatched, counting from 1. 0 before the first.
+     *
+     */
+    uint64_t get_running_search() const
+    {
+        return running_search.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the number of `go` commands read so far, ie. the number of
+     *        the search that signals read now apply to. Only valid on the
+     *        reader thread, eg. in the signal callback.
+     *
+     */
+    uint64_t get_searches_read() const
+    {
+        return searches_read;
+    }
+
+    /**
+     * @brief Check whether `stop` has been received for the search started by
+     *        the last `go` dispatched or a later one, even if a later `go` has
+     *        been read since. Cheap enough to poll from a search.
+     *
+     */
+    bool stop_requested() const
+    {
+        return stop_flag.load(std::memory_order_relaxed) >
+               running_search.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Check whether `ponderhit` has been received for the search
+     *        started by the last `go` dispatched or a later one
+     *
+     */
+    bool ponderhit_received() const
+    {
+        return ponderhit_flag.load(std::memory_order_relaxed) >
+               running_search.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Check whether `quit` has been received
+     *
+     */
+    bool quit_requested() const
+    {
+        return quit_flag.load(std::memory_order_relaxed);
+    }
 };
 
-#endif
\ No newline at end of file
+} // namespace chesspp
+
+#endif
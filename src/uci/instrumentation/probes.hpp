@@ -0,0 +1,246 @@
+/**
+ * @file probes.hpp
+ * @brief The live counters and histograms behind StatsSnapshot. When the
+ *        library is built without CHESSPP_INSTRUMENTATION every type here is
+ *        empty and every member function does nothing, so the probes compile
+ *        away.
+ *
+ */
+
+#ifndef SRC_UCI_INSTRUMENTATION_PROBES_H
+#define SRC_UCI_INSTRUMENTATION_PROBES_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "chesspp/stats.hpp"
+#include "../command/command_table.hpp"
+
+/**
+ * @brief Set to 1 by the CHESSPP_INSTRUMENTATION CMake option
+ *
+ */
+#ifndef CHESSPP_INSTRUMENTATION
+#define CHESSPP_INSTRUMENTATION 0
+#endif
+
+namespace chesspp
+{
+namespace instrumentation
+{
+inline constexpr bool enabled = CHESSPP_INSTRUMENTATION;
+
+#if CHESSPP_INSTRUMENTATION
+
+/**
+ * @brief A point in time, in nanoseconds on the steady clock
+ *
+ */
+struct Timestamp
+{
+    int64_t nanoseconds = 0;
+};
+
+inline Timestamp now()
+{
+    return Timestamp{std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now().time_since_epoch())
+                         .count()};
+}
+
+/**
+ * @brief Get the nanoseconds from `start` to `end`, 0 if `end` is earlier
+ *
+ */
+inline uint64_t elapsed(Timestamp start, Timestamp end)
+{
+    return end.nanoseconds > start.nanoseconds
+               ? static_cast<uint64_t>(end.nanoseconds - start.nanoseconds)
+               : 0;
+}
+
+/**
+ * @brief A running total that any thread can add to
+ *
+ */
+class Counter
+{
+private:
+    std::atomic<uint64_t> value{0};
+
+public:
+    void add(uint64_t amount)
+    {
+        value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    uint64_t load() const
+    {
+        return value.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief A lock-free log-linear histogram of latencies in nanoseconds, see
+ *        chesspp::histogram for the bucket layout. Recording is a few
+ *        relaxed atomic adds, so any thread can record while another takes
+ *        a snapshot. A snapshot taken during a record may be off by that one
+ *        value.
+ *
+ */
+class LatencyHistogram
+{
+private:
+    std::array<std::atomic<uint64_t>, histogram::num_buckets> counts = {};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+
+public:
+    void record(uint64_t nanoseconds)
+    {
+        counts[histogram::bucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+        uint64_t previous = max.load(std::memory_order_relaxed);
+        while (previous < nanoseconds and
+               not max.compare_exchange_weak(previous, nanoseconds, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /**
+     * @brief Records the time from `start` until now
+     *
+     */
+    void record_since(Timestamp start)
+    {
+        record(elapsed(start, now()));
+    }
+
+    void snapshot(HistogramSnapshot &snapshot) const
+    {
+        for (size_t i = 0; i < histogram::num_buckets; i++)
+        {
+            snapshot.counts[i] = counts[i].load(std::memory_order_relaxed);
+        }
+        snapshot.count = count.load(std::memory_order_relaxed);
+        snapshot.sum = sum.load(std::memory_order_relaxed);
+        snapshot.max = max.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Counts commands by name. Standard commands are counted in the slot
+ *        the perfect hash gives them, anything else in one shared counter.
+ *
+ */
+class CommandCounters
+{
+private:
+    std::array<Counter, standard_hash::num_slots> standard;
+    Counter other;
+
+public:
+    void add(std::string_view name)
+    {
+        if (standard_hash::is_standard(name))
+        {
+            standard[standard_hash::slot(name)].add(1);
+        }
+        else
+        {
+            other.add(1);
+        }
+    }
+
+    /**
+     * @brief Appends the commands that have been counted at least once
+     *
+     */
+    void snapshot(std::vector<CommandCount> &counts) const
+    {
+        counts.clear();
+        for (std::string_view const name : standard_hash::names)
+        {
+            uint64_t const count = standard[standard_hash::slot(name)].load();
+            if (count != 0)
+            {
+                counts.push_back(CommandCount{name, count});
+            }
+        }
+        if (other.load() != 0)
+        {
+            counts.push_back(CommandCount{"other", other.load()});
+        }
+    }
+};
+
+#else
+
+struct Timestamp
+{
+};
+
+inline Timestamp now()
+{
+    return Timestamp();
+}
+
+inline uint64_t elapsed(Timestamp, Timestamp)
+{
+    return 0;
+}
+
+class Counter
+{
+public:
+    void add(uint64_t)
+    {
+    }
+
+    uint64_t load() const
+    {
+        return 0;
+    }
+};
+
+class LatencyHistogram
+{
+public:
+    void record(uint64_t)
+    {
+    }
+
+    void record_since(Timestamp)
+    {
+    }
+
+    void snapshot(HistogramSnapshot &) const
+    {
+    }
+};
+
+class CommandCounters
+{
+public:
+    void add(std::string_view)
+    {
+    }
+
+    void snapshot(std::vector<CommandCount> &counts) const
+    {
+        counts.clear();
+    }
+};
+
+#endif
+
+} // namespace instrumentation
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,50 @@
+#include <string_view>
+
+#include "report.hpp"
+
+namespace
+{
+void append_histogram(
+    chesspp::OutputWriter::Line &line, std::string_view name, chesspp::HistogramSnapshot const &histogram)
+{
+    line.append(name);
+    line.append(" n=");
+    line.append_integer(histogram.count);
+    line.append(" p50=");
+    line.append_integer(histogram.percentile(0.5));
+    line.append("ns p99=");
+    line.append_integer(histogram.percentile(0.99));
+    line.append("ns max=");
+    line.append_integer(histogram.max);
+    line.append("ns");
+}
+
+void append_commands(
+    chesspp::OutputWriter::Line &line, std::vector<chesspp::CommandCount> const &commands)
+{
+    for (chesspp::CommandCount const &command : commands)
+    {
+        line.append(' ');
+        line.append(command.name);
+        line.append('=');
+        line.append_integer(command.count);
+    }
+}
+} // namespace
+
+void chesspp::write_stats(OutputWriter &output, StatsSnapshot const &stats)
+{
+    OutputWriter::Line line = output.begin_line("info");
+    line.append(" string stats bytes in ");
+    line.append_integer(stats.bytes_in);
+    line.append(" out ");
+    line.append_integer(stats.bytes_out);
+    append_histogram(line, " parse", stats.parse);
+    append_histogram(line, " dispatch", stats.dispatch);
+    append_histogram(line, " write", stats.write);
+    line.append(" commands in");
+    append_commands(line, stats.commands_in);
+    line.append(" out");
+    append_commands(line, stats.commands_out);
+    line.finish();
+}
@@ -0,0 +1,29 @@
+/**
+ * @file report.hpp
+ * @brief Formats a StatsSnapshot as an `info string` for the interface
+ *
+ */
+
+#ifndef SRC_UCI_INSTRUMENTATION_REPORT_H
+#define SRC_UCI_INSTRUMENTATION_REPORT_H
+
+#include "chesspp/stats.hpp"
+#include "../io/output_writer.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief Writes a snapshot as one `info string` line, eg.
+ *
+ *     info string stats bytes in 5120 out 40960
+ *         parse n=64 p50=1023ns p99=4095ns max=5210ns
+ *         dispatch n=64 ... write n=640 ...
+ *         commands in go=32 position=32 out bestmove=32 info=608
+ *
+ * (all on one line). Latency percentiles are upper bounds within 12.5%.
+ */
+void write_stats(OutputWriter &output, StatsSnapshot const &stats);
+
+} // namespace chesspp
+
+#endif
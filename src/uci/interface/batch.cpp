@@ -0,0 +1,322 @@
+#include <charconv>
+#include <utility>
+
+#include "batch.hpp"
+
+void chesspp::append_result(std::string &buffer, BatchResult const &result)
+{
+    EpdPosition const &position = *result.position;
+    char digits[24];
+    if (position.id.empty())
+    {
+        auto const end = std::to_chars(digits, digits + sizeof(digits), position.line);
+        buffer.append(digits, end.ptr - digits);
+    }
+    else
+    {
+        buffer.append(position.id);
+    }
+
+    buffer.push_back('\t');
+    for (size_t i = 0; i < position.fields.size(); i++)
+    {
+        if (i != 0)
+        {
+            buffer.push_back(' ');
+        }
+        buffer.append(position.fields[i]);
+    }
+
+    buffer.push_back('\t');
+    buffer.append(result.bestmove);
+    buffer.push_back('\t');
+    buffer.append(result.score);
+    buffer.push_back('\t');
+    auto const end = std::to_chars(digits, digits + sizeof(digits), result.depth);
+    buffer.append(digits, end.ptr - digits);
+    buffer.push_back('\n');
+}
+
+chesspp::Batch::Batch(BatchOptions options) : options(std::move(options))
+{
+    if (this->options.pipeline_depth == 0)
+    {
+        this->options.pipeline_depth = 1;
+    }
+    go_tokens.assign(this->options.go_arguments.begin(), this->options.go_arguments.end());
+}
+
+bool chesspp::Batch::next_position(EpdPosition &position)
+{
+    if (not retry.empty())
+    {
+        position = retry.front();
+        retry.pop_front();
+        return true;
+    }
+    if (not exhausted and positions->next(position))
+    {
+        return true;
+    }
+    exhausted = true;
+    return false;
+}
+
+void chesspp::Batch::start_search(int engine, EpdPosition const &position)
+{
+    Engine &state = engines[engine];
+    if (state.searches.empty())
+    {
+        state.busy_since = Clock::now();
+    }
+    state.searches.push_back(Search{position, false});
+
+    position_tokens.clear();
+    position_tokens.push_back("fen");
+    position_tokens.insert(position_tokens.end(), position.fields.begin(), position.fields.end());
+    multiplexer->send(engine, "position", TokenSpan(position_tokens));
+    multiplexer->send(engine, "go", TokenSpan(go_tokens));
+}
+
+bool chesspp::Batch::steal(int engine)
+{
+    // Take from whoever has the most searches waiting
+    int victim = -1;
+    size_t most_waiting = 0;
+    for (size_t i = 0; i < engines.size(); i++)
+    {
+        size_t waiting = 0;
+        for (size_t j = 1; j < engines[i].searches.size(); j++)
+        {
+            waiting += engines[i].searches[j].abandoned ? 0 : 1;
+        }
+        if (waiting > most_waiting)
+        {
+            victim = static_cast<int>(i);
+            most_waiting = waiting;
+        }
+    }
+    if (victim == -1)
+    {
+        return false;
+    }
+
+    // The newest is the furthest from being started
+    std::deque<Search> &searches = engines[victim].searches;
+    for (size_t j = searches.size() - 1; j >= 1; j--)
+    {
+        if (not searches[j].abandoned)
+        {
+            searches[j].abandoned = true;
+            start_search(engine, searches[j].position);
+            report.engines[engine].stolen++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void chesspp::Batch::feed(int engine)
+{
+    Engine &state = engines[engine];
+    if (not state.ready or not state.alive)
+    {
+        return;
+    }
+
+    EpdPosition position;
+    while (state.searches.size() < options.pipeline_depth and next_position(position))
+    {
+        start_search(engine, position);
+    }
+    if (state.searches.empty())
+    {
+        steal(engine);
+    }
+}
+
+void chesspp::Batch::finish_if_done()
+{
+    if (not exhausted or not retry.empty())
+    {
+        return;
+    }
+    for (Engine const &state : engines)
+    {
+        if (state.alive and not state.searches.empty())
+        {
+            return;
+        }
+    }
+
+    for (size_t i = 0; i < engines.size(); i++)
+    {
+        multiplexer->send(static_cast<int>(i), "quit");
+    }
+    multiplexer->stop();
+}
+
+void chesspp::Batch::on_readyok(int engine)
+{
+    engines[engine].ready = true;
+    feed(engine);
+    finish_if_done();
+}
+
+void chesspp::Batch::on_info(int engine, ArgumentSpan arguments)
+{
+    Engine &state = engines[engine];
+    for (ArgumentView const &argument : arguments)
+    {
+        if (argument.value == "depth" and not argument.parameters.empty())
+        {
+            int64_t depth = 0;
+            std::string_view const text = argument.parameters[0];
+            if (std::from_chars(text.data(), text.data() + text.size(), depth).ec == std::errc())
+            {
+                state.depth = depth;
+            }
+        }
+        else if ((argument.value == "cp" or argument.value == "mate") and
+                 not argument.parameters.empty())
+        {
+            state.score.assign(argument.value);
+            state.score.push_back(' ');
+            state.score.append(argument.parameters[0]);
+        }
+    }
+}
+
+void chesspp::Batch::on_bestmove(int engine, ArgumentSpan arguments)
+{
+    Engine &state = engines[engine];
+    if (state.searches.empty())
+    {
+        return;
+    }
+
+    Search const search = state.searches.front();
+    state.searches.pop_front();
+    if (not search.abandoned)
+    {
+        BatchResult result;
+        result.position = &search.position;
+        result.bestmove = arguments[0].value;
+        result.score = state.score;
+        result.depth = state.depth;
+        result.engine = engine;
+        report.positions++;
+        report.engines[engine].positions++;
+        if (on_result)
+        {
+            on_result(result);
+        }
+    }
+    state.score.clear();
+    state.depth = 0;
+
+    // Cut short a search that another engine has taken over. The stop is
+    // read after the go, so it ends that search and no other.
+    if (not state.searches.empty() and state.searches.front().abandoned)
+    {
+        multiplexer->send(engine, "stop");
+    }
+
+    // Count the busy time before feeding, which may start a new busy spell
+    if (state.searches.empty())
+    {
+        report.engines[engine].busy_seconds +=
+            std::chrono::duration<double>(Clock::now() - state.busy_since).count();
+    }
+    feed(engine);
+    finish_if_done();
+}
+
+void chesspp::Batch::on_close(int engine)
+{
+    Engine &state = engines[engine];
+    state.alive = false;
+    if (not state.searches.empty())
+    {
+        report.engines[engine].busy_seconds +=
+            std::chrono::duration<double>(Clock::now() - state.busy_since).count();
+    }
+    for (Search const &search : state.searches)
+    {
+        if (not search.abandoned)
+        {
+            retry.push_back(search.position);
+        }
+    }
+    state.searches.clear();
+
+    for (size_t i = 0; i < engines.size(); i++)
+    {
+        feed(static_cast<int>(i));
+    }
+    finish_if_done();
+}
+
+bool chesspp::Batch::run(EpdReader &positions, ResultCallback on_result)
+{
+    Multiplexer pool;
+    multiplexer = &pool;
+    this->positions = &positions;
+    this->on_result = std::move(on_result);
+    exhausted = false;
+    retry.clear();
+    engines.clear();
+    report = BatchReport();
+
+    pool.register_command("uciok", [this](int engine, ArgumentSpan) {
+        multiplexer->send(engine, "isready");
+    });
+    pool.register_command("readyok", [this](int engine, ArgumentSpan) { on_readyok(engine); });
+    pool.register_command("info", [this](int engine, ArgumentSpan arguments) {
+        on_info(engine, arguments);
+    });
+    pool.register_command("bestmove", [this](int engine, ArgumentSpan arguments) {
+        on_bestmove(engine, arguments);
+    });
+    pool.register_close_callback([this](int engine) { on_close(engine); });
+
+    // Engines are numbered by their session, so ones that fail to start
+    // are left out
+    for (std::string const &command : options.engines)
+    {
+        int const session = pool.add_engine(command);
+        if (session != -1)
+        {
+            pool.send(session, "uci");
+        }
+    }
+    engines.resize(pool.size());
+    report.engines.resize(pool.size());
+    bool const started = pool.size() != 0;
+
+    auto const start = Clock::now();
+    if (started)
+    {
+        pool.run();
+    }
+    report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Anything left was not analysed because the engines exited
+    for (Engine const &state : engines)
+    {
+        for (Search const &search : state.searches)
+        {
+            report.unanalysed += search.abandoned ? 0 : 1;
+        }
+    }
+    report.unanalysed += retry.size();
+    EpdPosition position;
+    while (not exhausted and positions.next(position))
+    {
+        report.unanalysed++;
+    }
+
+    multiplexer = nullptr;
+    this->on_result = ResultCallback();
+    return started and report.unanalysed == 0;
+}
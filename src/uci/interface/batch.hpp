@@ -0,0 +1,324 @@
+/**
+ * @file batch.hpp
+ * @brief Analyses a list of positions on a pool of local engines
+ *
+ */
+
+#ifndef SRC_UCI_INTERFACE_BATCH_H
+#define SRC_UCI_INTERFACE_BATCH_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chesspp/inplace_function.hpp"
+#include "epd.hpp"
+#include "multiplexer.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief How to run a batch
+ *
+ */
+struct BatchOptions
+{
+    /**
+     * @brief The shell command of each engine process in the pool
+     *
+     */
+    std::vector<std::string> engines;
+
+    /**
+     * @brief The arguments of the `go` sent for every position
+     *
+     */
+    std::vector<std::string> go_arguments = {"depth", "10"};
+
+    /**
+     * @brief How many `position`/`go` pairs an engine is sent before the
+     *        first is answered. With more than 1 the next search is already
+     *        waiting in the engine's input when it sends bestmove. Use 1 for
+     *        engines that don't queue commands received while searching.
+     *
+     */
+    size_t pipeline_depth = 2;
+};
+
+/**
+ * @brief The analysis of one position. The views are only valid during the
+ *        result callback.
+ *
+ */
+struct BatchResult
+{
+    EpdPosition const *position = nullptr;
+
+    std::string_view bestmove;
+
+    /**
+     * @brief The score of the last info line with one, eg. "cp 23" or
+     *        "mate -3". Empty if there was none.
+     *
+     */
+    std::string_view score;
+
+    /**
+     * @brief The depth of the last info line with one, 0 if there was none
+     *
+     */
+    int64_t depth = 0;
+
+    /**
+     * @brief The engine that analysed the position
+     *
+     */
+    int engine = 0;
+};
+
+/**
+ * @brief How one engine of the pool was used
+ *
+ */
+struct EngineUsage
+{
+    /**
+     * @brief The positions it analysed
+     *
+     */
+    uint64_t positions = 0;
+
+    /**
+     * @brief The positions it took from another engine's pipeline
+     *
+     */
+    uint64_t stolen = 0;
+
+    /**
+     * @brief The time it had at least one search to do
+     *
+     */
+    double busy_seconds = 0;
+};
+
+/**
+ * @brief What a batch did
+ *
+ */
+struct BatchReport
+{
+    /**
+     * @brief The positions analysed
+     *
+     */
+    uint64_t positions = 0;
+
+    /**
+     * @brief The positions that were not analysed because every engine
+     *        exited
+     *
+     */
+    uint64_t unanalysed = 0;
+
+    double seconds = 0;
+
+    /**
+     * @brief One entry for each engine that could be started
+     *
+     */
+    std::vector<EngineUsage> engines;
+
+    double positions_per_second() const
+    {
+        return seconds > 0 ? static_cast<double>(positions) / seconds : 0;
+    }
+
+    /**
+     * @brief Get the fraction of the batch an engine was busy for, between 0
+     *        and 1
+     *
+     */
+    double utilisation(size_t engine) const
+    {
+        return seconds > 0 ? engines[engine].busy_seconds / seconds : 0;
+    }
+};
+
+/**
+ * @brief Appends a result to a buffer as one tab separated line: the
+ *        position's id (or its line number), its FEN, the best move, the
+ *        score and the depth
+ *
+ */
+void append_result(std::string &buffer, BatchResult const &result);
+
+/**
+ * @brief Analyses positions on a pool of engines run by a Multiplexer, so the
+ *        whole pool is driven from one thread.
+ *
+ * Positions are read from the EpdReader only as engines need them, so a
+ * file of any size is streamed. An engine is kept `pipeline_depth` searches
+ * ahead. Once the reader runs dry, an engine with nothing to do steals the
+ * newest search that another engine has queued but not started, and the
+ * other engine's answer to it is ignored (it is told to stop as soon as it
+ * starts that search). If an engine exits, its searches go back to the pool.
+ */
+class Batch
+{
+public:
+    /**
+     * @brief A callback for each position analysed, in the order the
+     *        results arrive
+     *
+     */
+    using ResultCallback = InplaceFunction<void(BatchResult const &)>;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief A position sent to an engine
+     *
+     */
+    struct Search
+    {
+        EpdPosition position;
+
+        /**
+         * @brief Set if another engine stole the search, so the answer to it
+         *        is ignored
+         *
+         */
+        bool abandoned = false;
+    };
+
+    /**
+     * @brief The state of one engine of the pool
+     *
+     */
+    struct Engine
+    {
+        /**
+         * @brief The searches sent, oldest (the one running) first
+         *
+         */
+        std::deque<Search> searches;
+
+        /**
+         * @brief Set once the engine has answered isready
+         *
+         */
+        bool ready = false;
+
+        bool alive = true;
+
+        /**
+         * @brief When `searches` last became non-empty
+         *
+         */
+        Clock::time_point busy_since;
+
+        /**
+         * @brief The score and depth of the running search so far
+         *
+         */
+        std::string score;
+        int64_t depth = 0;
+    };
+
+    BatchOptions options;
+
+    std::vector<Engine> engines;
+
+    /**
+     * @brief Searches taken back from engines that exited
+     *
+     */
+    std::deque<EpdPosition> retry;
+
+    Multiplexer *multiplexer = nullptr;
+    EpdReader *positions = nullptr;
+    ResultCallback on_result;
+
+    /**
+     * @brief Set once the reader has run dry
+     *
+     */
+    bool exhausted = false;
+
+    BatchReport report;
+
+    /**
+     * @brief Storage for the `position` and `go` arguments
+     *
+     */
+    std::vector<std::string_view> position_tokens;
+    std::vector<std::string_view> go_tokens;
+
+    /**
+     * @brief Gets the next position that has not been sent to any engine
+     *
+     */
+    bool next_position(EpdPosition &position);
+
+    /**
+     * @brief Sends a search to an engine
+     *
+     */
+    void start_search(int engine, EpdPosition const &position);
+
+    /**
+     * @brief Tops up an engine's pipeline, stealing if there is nothing else
+     *        left to do
+     *
+     */
+    void feed(int engine);
+
+    /**
+     * @brief Takes a queued search from the busiest other engine
+     *
+     * @return false If no engine has a search queued behind the running one
+     */
+    bool steal(int engine);
+
+    /**
+     * @brief Stops the run if every search has been answered
+     *
+     */
+    void finish_if_done();
+
+    void on_readyok(int engine);
+    void on_info(int engine, ArgumentSpan arguments);
+    void on_bestmove(int engine, ArgumentSpan arguments);
+    void on_close(int engine);
+
+public:
+    explicit Batch(BatchOptions options);
+
+    /**
+     * @brief Starts the engines and analyses every position
+     *
+     * @param positions The positions to analyse
+     * @param on_result Called for each position analysed
+     * @return false If no engine could be started, or every engine exited
+     *         before the positions ran out
+     */
+    bool run(EpdReader &positions, ResultCallback on_result);
+
+    /**
+     * @brief Get what the last run did
+     *
+     */
+    BatchReport const &get_report() const
+    {
+        return report;
+    }
+};
+
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,148 @@
+#include <algorithm>
+
+#include "epd.hpp"
+
+namespace
+{
+constexpr std::string_view whitespace = " \t\r";
+
+/**
+ * @brief Removes and returns the first whitespace separated field of `text`
+ *
+ */
+std::string_view next_field(std::string_view &text)
+{
+    size_t const start = text.find_first_not_of(whitespace);
+    if (start == std::string_view::npos)
+    {
+        text = {};
+        return {};
+    }
+    text.remove_prefix(start);
+    size_t const end = std::min(text.find_first_of(whitespace), text.size());
+    std::string_view const field = text.substr(0, end);
+    text.remove_prefix(end);
+    return field;
+}
+
+bool is_number(std::string_view text)
+{
+    if (text.empty())
+    {
+        return false;
+    }
+    for (char const character : text)
+    {
+        if (character < '0' or character > '9')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Removes and returns the next operation of an EPD record, up to a
+ *        `;` that is not inside a quoted operand
+ *
+ */
+std::string_view next_operation(std::string_view &text)
+{
+    bool quoted = false;
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        if (text[i] == '"')
+        {
+            quoted = not quoted;
+        }
+        else if (text[i] == ';' and not quoted)
+        {
+            std::string_view const operation = text.substr(0, i);
+            text.remove_prefix(i + 1);
+            return operation;
+        }
+    }
+    std::string_view const operation = text;
+    text = {};
+    return operation;
+}
+} // namespace
+
+bool chesspp::EpdReader::parse_line(std::string_view line, EpdPosition &position)
+{
+    for (size_t i = 0; i < 4; i++)
+    {
+        position.fields[i] = next_field(line);
+    }
+    if (position.fields[3].empty() or
+        (position.fields[1] != "w" and position.fields[1] != "b"))
+    {
+        return false;
+    }
+    position.fields[4] = "0";
+    position.fields[5] = "1";
+    position.id = {};
+
+    // A FEN has the clocks next, an EPD record its operations
+    std::string_view rest = line;
+    std::string_view const halfmove = next_field(rest);
+    std::string_view const fullmove = next_field(rest);
+    if (is_number(halfmove) and is_number(fullmove))
+    {
+        position.fields[4] = halfmove;
+        position.fields[5] = fullmove;
+        return true;
+    }
+
+    while (not line.empty())
+    {
+        std::string_view operation = next_operation(line);
+        std::string_view const opcode = next_field(operation);
+        size_t const start = operation.find_first_not_of(whitespace);
+        std::string_view operand =
+            start == std::string_view::npos ? std::string_view() : operation.substr(start);
+        operand = operand.substr(0, operand.find_last_not_of(whitespace) + 1);
+
+        if (opcode == "id")
+        {
+            if (operand.size() >= 2 and operand.front() == '"' and operand.back() == '"')
+            {
+                operand = operand.substr(1, operand.size() - 2);
+            }
+            position.id = operand;
+        }
+        else if (opcode == "hmvc" and is_number(operand))
+        {
+            position.fields[4] = operand;
+        }
+        else if (opcode == "fmvn" and is_number(operand))
+        {
+            position.fields[5] = operand;
+        }
+    }
+    return true;
+}
+
+bool chesspp::EpdReader::next(EpdPosition &position)
+{
+    while (not remaining.empty())
+    {
+        size_t const end = std::min(remaining.find('\n'), remaining.size());
+        std::string_view const line = remaining.substr(0, end);
+        remaining.remove_prefix(end == remaining.size() ? end : end + 1);
+        line_number++;
+
+        size_t const start = line.find_first_not_of(whitespace);
+        if (start == std::string_view::npos or line[start] == '#')
+        {
+            continue;
+        }
+        if (parse_line(line, position))
+        {
+            position.line = line_number;
+            return true;
+        }
+        malformed++;
+    }
+    return false;
+}
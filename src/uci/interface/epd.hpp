@@ -0,0 +1,103 @@
+/**
+ * @file epd.hpp
+ * @brief Reads positions from EPD and FEN files
+ *
+ */
+
+#ifndef SRC_UCI_INTERFACE_EPD_H
+#define SRC_UCI_INTERFACE_EPD_H
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace chesspp
+{
+/**
+ * @brief A position read from an EPD or FEN file. Every view points into the
+ *        text the reader was given.
+ *
+ */
+struct EpdPosition
+{
+    /**
+     * @brief The six fields of the position's FEN: placement, side to move,
+     *        castling, en passant, halfmove clock and fullmove number. For an
+     *        EPD line the clocks come from its `hmvc` and `fmvn` operations,
+     *        or are "0" and "1".
+     *
+     */
+    std::array<std::string_view, 6> fields;
+
+    /**
+     * @brief The operand of the `id` operation without its quotes, or empty
+     *
+     */
+    std::string_view id;
+
+    /**
+     * @brief The line of the file the position is on, counting from 1
+     *
+     */
+    size_t line = 0;
+};
+
+/**
+ * @brief Reads one position per line from EPD or FEN text, without copying
+ *        it.
+ *
+ * A line is a FEN, or the four position fields of an EPD record followed by
+ * its operations (eg. `bm Nf3; id "WAC.001";`). Blank lines and lines that
+ * start with `#` are skipped. So are lines that are not a position, which
+ * are counted.
+ */
+class EpdReader
+{
+private:
+    /**
+     * @brief The text that has not been read yet
+     *
+     */
+    std::string_view remaining;
+
+    size_t line_number = 0;
+
+    size_t malformed = 0;
+
+    /**
+     * @brief Parses one line into a position
+     *
+     * @return false If the line is not a position
+     */
+    static bool parse_line(std::string_view line, EpdPosition &position);
+
+public:
+    /**
+     * @param text The whole file. Must outlive the reader and the positions
+     *        it reads.
+     */
+    explicit EpdReader(std::string_view text) : remaining(text)
+    {
+    }
+
+    /**
+     * @brief Reads the next position
+     *
+     * @param position Set to the position
+     * @return false At the end of the text
+     */
+    bool next(EpdPosition &position);
+
+    /**
+     * @brief Get the number of lines skipped because they are not positions
+     *
+     */
+    size_t get_malformed() const
+    {
+        return malformed;
+    }
+};
+
+} // namespace chesspp
+
+#endif
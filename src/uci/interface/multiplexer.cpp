@@ -0,0 +1,415 @@
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "multiplexer.hpp"
+#include "../command/grammar.hpp"
+#include "../parser.hpp"
+
+namespace
+{
+/**
+ * @brief The epoll data of the wake eventfd. Sessions use their number
+ *        shifted left by one, with the low bit set for the input pipe.
+ *
+ */
+constexpr uint64_t wake_tag = UINT64_MAX;
+
+/**
+ * @brief The size of one read from an engine
+ *
+ */
+constexpr size_t read_size = 64 * 1024;
+
+/**
+ * @brief The most events handled per turn of the loop
+ *
+ */
+constexpr int max_events = 256;
+
+bool set_non_blocking(int fd)
+{
+    int const flags = fcntl(fd, F_GETFL);
+    return flags != -1 and fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+} // namespace
+
+chesspp::Multiplexer::Multiplexer()
+    : epoll_fd(epoll_create1(EPOLL_CLOEXEC)),
+      wake_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+      read_buffer(read_size)
+{
+    for (Command command : {
+             grammar::id.to_command(),
+             grammar::uciok.to_command(),
+             grammar::readyok.to_command(),
+             grammar::bestmove.to_command(),
+             grammar::copyprotection.to_command(),
+             grammar::registration.to_command(),
+             grammar::info.to_command(),
+             grammar::option.to_command(),
+         })
+    {
+        engine_commands.add(std::move(command));
+    }
+
+    for (Command command : {
+             grammar::uci.to_command(),
+             grammar::debug.to_command(),
+             grammar::isready.to_command(),
+             grammar::setoption.to_command(),
+             grammar::register_.to_command(),
+             grammar::ucinewgame.to_command(),
+             grammar::position.to_command(),
+             grammar::go.to_command(),
+             grammar::stop.to_command(),
+             grammar::ponderhit.to_command(),
+             grammar::quit.to_command(),
+         })
+    {
+        interface_commands.add(std::move(command));
+    }
+
+    if (epoll_fd != -1 and wake_fd != -1)
+    {
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = wake_tag;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+    }
+}
+
+chesspp::Multiplexer::~Multiplexer()
+{
+    // Kill and reap the engines before closing the descriptors that watch
+    // them
+    sessions.clear();
+    if (wake_fd != -1)
+    {
+        close(wake_fd);
+    }
+    if (epoll_fd != -1)
+    {
+        close(epoll_fd);
+    }
+}
+
+int chesspp::Multiplexer::add_engine(std::string const &command)
+{
+    if (epoll_fd == -1 or wake_fd == -1)
+    {
+        return -1;
+    }
+
+    auto session = std::make_unique<Session>();
+    if (not session->process.spawn(command) or
+        not set_non_blocking(session->process.input()) or
+        not set_non_blocking(session->process.output()))
+    {
+        return -1;
+    }
+
+    int const number = static_cast<int>(sessions.size());
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = static_cast<uint64_t>(number) << 1;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, session->process.output(), &event) != 0)
+    {
+        return -1;
+    }
+
+    sessions.push_back(std::move(session));
+    open_sessions++;
+    return number;
+}
+
+bool chesspp::Multiplexer::register_command(std::string_view name, SessionCallback callback)
+{
+    if (engine_commands.find(name) == nullptr)
+    {
+        return false;
+    }
+    callbacks[standard_hash::slot(name)] = std::move(callback);
+    return true;
+}
+
+void chesspp::Multiplexer::register_close_callback(CloseCallback callback)
+{
+    close_callback = std::move(callback);
+}
+
+bool chesspp::Multiplexer::send(int session, std::string_view name, TokenSpan arguments)
+{
+    if (not is_open(session))
+    {
+        return false;
+    }
+    Command const *command = interface_commands.find(name);
+    if (command == nullptr or not command->try_parse_arguments(arguments, send_arguments))
+    {
+        return false;
+    }
+
+    Session &target = *sessions[session];
+    target.pending.append(command->get_name());
+    for (std::string_view argument : arguments)
+    {
+        target.pending.push_back(' ');
+        target.pending.append(argument);
+    }
+    target.pending.push_back('\n');
+
+    // A session waiting for room is written when epoll reports it
+    if (not target.dirty and not target.waiting_to_write)
+    {
+        target.dirty = true;
+        dirty.push_back(session);
+    }
+    return true;
+}
+
+bool chesspp::Multiplexer::send(
+    int session, std::string_view name, std::vector<std::string> const &arguments)
+{
+    send_tokens.assign(arguments.begin(), arguments.end());
+    return send(session, name, TokenSpan(send_tokens));
+}
+
+void chesspp::Multiplexer::handle_line(int session, std::string_view line)
+{
+    if (not line.empty() and line.back() == '\r')
+    {
+        line.remove_suffix(1);
+    }
+    Parser::tokenise(line, tokens);
+
+    // Like the engine, skip anything before the first known command
+    size_t index = 0;
+    Command const *command = nullptr;
+    while (index < tokens.size() and (command = engine_commands.find(tokens[index])) == nullptr)
+    {
+        index++;
+    }
+    if (command == nullptr)
+    {
+        return;
+    }
+
+    SessionCallback const &callback = callbacks[standard_hash::slot(command->get_name())];
+    if (not callback or
+        not command->try_parse_arguments(TokenSpan(tokens).subspan(index + 1), arguments))
+    {
+        return;
+    }
+    callback(session, ArgumentSpan(arguments));
+}
+
+void chesspp::Multiplexer::read_session(int session)
+{
+    Session &source = *sessions[session];
+    ssize_t size;
+    do
+    {
+        size = read(source.process.output(), read_buffer.data(), read_buffer.size());
+    } while (size == -1 and errno == EINTR);
+
+    if (size == -1 and (errno == EAGAIN or errno == EWOULDBLOCK))
+    {
+        return;
+    }
+    if (size <= 0)
+    {
+        close_session(session);
+        return;
+    }
+
+    // Complete lines are handled straight from the read buffer. Only the
+    // start of a line split across reads is copied.
+    std::string_view data(read_buffer.data(), static_cast<size_t>(size));
+    size_t newline;
+    while ((newline = data.find('\n')) != std::string_view::npos)
+    {
+        if (source.partial_line.empty())
+        {
+            handle_line(session, data.substr(0, newline));
+        }
+        else
+        {
+            source.partial_line.append(data.data(), newline);
+            handle_line(session, source.partial_line);
+            source.partial_line.clear();
+        }
+        data.remove_prefix(newline + 1);
+    }
+    source.partial_line.append(data);
+}
+
+void chesspp::Multiplexer::write_session(int session)
+{
+    Session &target = *sessions[session];
+    while (target.written < target.pending.size())
+    {
+        ssize_t const size = write(target.process.input(),
+                                   target.pending.data() + target.written,
+                                   target.pending.size() - target.written);
+        if (size >= 0)
+        {
+            target.written += static_cast<size_t>(size);
+            continue;
+        }
+        if (errno == EINTR)
+        {
+            continue;
+        }
+        if (errno == EAGAIN or errno == EWOULDBLOCK)
+        {
+            // Wait for the engine to read some of what it has been sent
+            if (not target.waiting_to_write)
+            {
+                epoll_event event = {};
+                event.events = EPOLLOUT;
+                event.data.u64 = static_cast<uint64_t>(session) << 1 | 1;
+                epoll_ctl(epoll_fd, EPOLL_CTL_ADD, target.process.input(), &event);
+                target.waiting_to_write = true;
+            }
+            return;
+        }
+
+        // The engine closed its input. Its output closing will close the
+        // session.
+        break;
+    }
+
+    target.pending.clear();
+    target.written = 0;
+    if (target.waiting_to_write)
+    {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, target.process.input(), nullptr);
+        target.waiting_to_write = false;
+    }
+}
+
+void chesspp::Multiplexer::write_dirty()
+{
+    for (int const session : dirty)
+    {
+        Session &target = *sessions[session];
+        target.dirty = false;
+        if (target.open)
+        {
+            write_session(session);
+        }
+    }
+    dirty.clear();
+}
+
+void chesspp::Multiplexer::close_session(int session)
+{
+    Session &source = *sessions[session];
+    if (not source.open)
+    {
+        return;
+    }
+    source.open = false;
+    open_sessions--;
+
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, source.process.output(), nullptr);
+    if (source.waiting_to_write)
+    {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, source.process.input(), nullptr);
+        source.waiting_to_write = false;
+    }
+    source.pending.clear();
+    source.partial_line.clear();
+
+    // An engine without output is of no more use, and waiting for one that
+    // has not exited would hold up every other session
+    source.process.kill();
+
+    if (close_callback)
+    {
+        close_callback(session);
+    }
+}
+
+void chesspp::Multiplexer::run()
+{
+    // Writing to an engine that has exited raises SIGPIPE. Block it on this
+    // thread while running, and discard any that were raised afterwards.
+    sigset_t pipe_signal;
+    sigset_t previous_mask;
+    sigemptyset(&pipe_signal);
+    sigaddset(&pipe_signal, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_signal, &previous_mask);
+
+    epoll_event events[max_events];
+    while (open_sessions != 0 and not stop_requested.load())
+    {
+        write_dirty();
+
+        int const count = epoll_wait(epoll_fd, events, max_events, -1);
+        if (count == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            uint64_t const tag = events[i].data.u64;
+            if (tag == wake_tag)
+            {
+                uint64_t value;
+                while (read(wake_fd, &value, sizeof(value)) == sizeof(value))
+                {
+                }
+                continue;
+            }
+
+            int const session = static_cast<int>(tag >> 1);
+            if (not sessions[session]->open)
+            {
+                // Closed while handling an earlier event of this batch
+                continue;
+            }
+            if (tag & 1)
+            {
+                write_session(session);
+            }
+            else
+            {
+                read_session(session);
+            }
+        }
+    }
+    write_dirty();
+    stop_requested.store(false);
+
+    if (not sigismember(&previous_mask, SIGPIPE))
+    {
+        timespec const no_wait = {0, 0};
+        while (sigtimedwait(&pipe_signal, nullptr, &no_wait) == SIGPIPE)
+        {
+        }
+        pthread_sigmask(SIG_SETMASK, &previous_mask, nullptr);
+    }
+}
+
+void chesspp::Multiplexer::stop()
+{
+    stop_requested.store(true);
+    uint64_t const value = 1;
+    ssize_t const result = write(wake_fd, &value, sizeof(value));
+    (void)result;
+}
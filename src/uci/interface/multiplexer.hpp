@@ -0,0 +1,312 @@
+/**
+ * @file multiplexer.hpp
+ * @brief Talks UCI to many local engine processes from one thread
+ *
+ */
+
+#ifndef SRC_UCI_INTERFACE_MULTIPLEXER_H
+#define SRC_UCI_INTERFACE_MULTIPLEXER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chesspp/argument.hpp"
+#include "chesspp/inplace_function.hpp"
+#include "../command/command_table.hpp"
+#include "../io/subprocess.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief The interface side of UCI for many engines at once, eg. for an
+ *        analysis farm.
+ *
+ * Each engine runs as a Subprocess and is called a session. Every session's
+ * pipes are non-blocking and registered with one epoll instance, and run()
+ * services all of them on the calling thread, so hundreds of engines need no
+ * thread each.
+ *
+ * Lines from an engine are tokenised and parsed with the grammars of the
+ * commands an engine may send (id, uciok, readyok, bestmove, copyprotection,
+ * registration, info and option). The callback registered for the command is
+ * run with the number of the session it came from. Lines that are not one of
+ * those commands, or don't parse, are ignored.
+ *
+ * Commands sent to an engine are checked against the grammars of the
+ * commands an interface may send and are buffered. The buffers are written
+ * once per turn of the event loop, so everything sent to an engine while
+ * handling a batch of events goes out in one write.
+ *
+ * Apart from stop(), a Multiplexer must only be used from one thread: set it
+ * up, then call run(), and send commands from the callbacks.
+ */
+class Multiplexer
+{
+public:
+    /**
+     * @brief A callback for a command received from an engine. It gets the
+     *        session the command came from and its arguments, which are only
+     *        valid during the call.
+     *
+     */
+    using SessionCallback = InplaceFunction<void(int, ArgumentSpan)>;
+
+    /**
+     * @brief A callback for an engine closing its output, usually because it
+     *        exited. It gets the session.
+     *
+     */
+    using CloseCallback = InplaceFunction<void(int)>;
+
+private:
+    /**
+     * @brief An engine process and the state of its pipes
+     *
+     */
+    struct Session
+    {
+        Subprocess process;
+
+        /**
+         * @brief The start of a line that has not been completely read yet
+         *
+         */
+        std::string partial_line;
+
+        /**
+         * @brief Commands waiting to be written to the engine
+         *
+         */
+        std::string pending;
+
+        /**
+         * @brief How much of `pending` has been written
+         *
+         */
+        size_t written = 0;
+
+        /**
+         * @brief Set until the engine closes its output
+         *
+         */
+        bool open = true;
+
+        /**
+         * @brief Set while the session is in the `dirty` list
+         *
+         */
+        bool dirty = false;
+
+        /**
+         * @brief Set while epoll watches the input pipe for room to write
+         *
+         */
+        bool waiting_to_write = false;
+    };
+
+    std::vector<std::unique_ptr<Session>> sessions;
+
+    /**
+     * @brief The sessions that have been sent something since the last
+     *        time the buffers were written
+     *
+     */
+    std::vector<int> dirty;
+
+    /**
+     * @brief The number of sessions that are still open
+     *
+     */
+    size_t open_sessions = 0;
+
+    int epoll_fd = -1;
+
+    /**
+     * @brief An eventfd that stop() writes to, to wake the event loop
+     *
+     */
+    int wake_fd = -1;
+
+    std::atomic<bool> stop_requested{false};
+
+    /**
+     * @brief The commands an engine may send
+     *
+     */
+    CommandTable engine_commands;
+
+    /**
+     * @brief The commands an interface may send
+     *
+     */
+    CommandTable interface_commands;
+
+    /**
+     * @brief The callbacks for the commands engines send, by the slot
+     *        standard_hash gives the command's name
+     *
+     */
+    std::array<SessionCallback, standard_hash::num_slots> callbacks;
+
+    CloseCallback close_callback;
+
+    /**
+     * @brief Storage reused for every line, so parsing does not allocate
+     *        once it has grown large enough
+     *
+     */
+    std::vector<std::string_view> tokens;
+    std::vector<ArgumentView> arguments;
+    std::vector<char> read_buffer;
+
+    /**
+     * @brief Storage for checking commands that are sent. Separate from the
+     *        above, since callbacks send while their arguments point into it.
+     *
+     */
+    std::vector<std::string_view> send_tokens;
+    std::vector<ArgumentView> send_arguments;
+
+    /**
+     * @brief Reads what one engine has written and handles every complete
+     *        line
+     *
+     */
+    void read_session(int session);
+
+    /**
+     * @brief Parses a line from an engine and runs its callback
+     *
+     */
+    void handle_line(int session, std::string_view line);
+
+    /**
+     * @brief Writes as much of a session's pending commands as the pipe
+     *        takes, and watches the pipe for room to write the rest
+     *
+     */
+    void write_session(int session);
+
+    /**
+     * @brief Writes the pending commands of every dirty session
+     *
+     */
+    void write_dirty();
+
+    /**
+     * @brief Stops watching a session whose engine closed its output, and
+     *        runs the close callback
+     *
+     */
+    void close_session(int session);
+
+public:
+    Multiplexer();
+    ~Multiplexer();
+
+    Multiplexer(Multiplexer const &) = delete;
+    Multiplexer &operator=(Multiplexer const &) = delete;
+
+    /**
+     * @brief Starts an engine and adds it as a new session
+     *
+     * @param command The shell command that runs the engine
+     * @return int The session, numbered from 0 in the order they were added,
+     *         or -1 if the engine could not be started
+     */
+    int add_engine(std::string const &command);
+
+    /**
+     * @brief Registers the callback for a command received from engines,
+     *        replacing any previous one
+     *
+     * @param name The name of the command (eg. "bestmove")
+     * @param callback The callback
+     * @return false If engines don't send a command with this name
+     */
+    bool register_command(std::string_view name, SessionCallback callback);
+
+    /**
+     * @brief Registers the callback for an engine closing its output
+     *
+     */
+    void register_close_callback(CloseCallback callback);
+
+    /**
+     * @brief Sends a command to an engine. It is written by run().
+     *
+     * @param session The session to send to
+     * @param name The name of the command (eg. "go")
+     * @param arguments The arguments of the command
+     * @return false If the session is not open, the command is not one an
+     *         interface sends or the arguments don't fit its grammar
+     */
+    bool send(int session, std::string_view name, TokenSpan arguments);
+
+    /**
+     * @brief Sends a command to an engine, see the TokenSpan overload
+     *
+     */
+    bool send(int session, std::string_view name, std::vector<std::string> const &arguments);
+
+    /**
+     * @brief Sends a command without arguments to an engine (eg. "isready")
+     *
+     */
+    bool send(int session, std::string_view name)
+    {
+        return send(session, name, TokenSpan());
+    }
+
+    /**
+     * @brief Handles the engines until every session has closed or stop()
+     *        is called
+     *
+     */
+    void run();
+
+    /**
+     * @brief Makes run() return after the events it is handling. Can be
+     *        called from any thread.
+     *
+     */
+    void stop();
+
+    /**
+     * @brief Get the number of sessions added
+     *
+     */
+    size_t size() const
+    {
+        return sessions.size();
+    }
+
+    /**
+     * @brief Check whether a session's engine still has its output open
+     *
+     */
+    bool is_open(int session) const
+    {
+        return session >= 0 and static_cast<size_t>(session) < sessions.size() and
+               sessions[session]->open;
+    }
+
+    /**
+     * @brief Get the process id of a session's engine, -1 if it has been
+     *        reaped
+     *
+     */
+    pid_t get_pid(int session) const
+    {
+        return sessions[session]->process.get_pid();
+    }
+};
+
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,390 @@
+/**
+ * @file info_builder.hpp
+ * @brief A typed builder for `info` commands
+ *
+ */
+
+#ifndef SRC_UCI_IO_INFO_BUILDER_H
+#define SRC_UCI_IO_INFO_BUILDER_H
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+#include "output_writer.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief The fields of an `info` command, as bits of a mask
+ *
+ */
+namespace info_field
+{
+enum : uint32_t
+{
+    depth = 1u << 0,
+    seldepth = 1u << 1,
+    time = 1u << 2,
+    nodes = 1u << 3,
+    pv = 1u << 4,
+    multipv = 1u << 5,
+    score = 1u << 6,
+    bound = 1u << 7,
+    currmove = 1u << 8,
+    currmovenumber = 1u << 9,
+    hashfull = 1u << 10,
+    nps = 1u << 11,
+    tbhits = 1u << 12,
+    sbhits = 1u << 13,
+    cpuload = 1u << 14,
+    string = 1u << 15,
+    refutation = 1u << 16,
+    currline = 1u << 17
+};
+} // namespace info_field
+
+template <uint32_t Fields>
+class InfoScoreBuilder;
+
+/**
+ * @brief Formats an `info` command straight into an OutputWriter's buffer.
+ *        Numbers are written with std::to_chars, so nothing is allocated.
+ *
+ * The fields that have been added are tracked in the type, so mistakes are
+ * compile errors instead of runtime parse errors:
+ *  - a field can only be added once,
+ *  - `string` must be the last field, since it takes the rest of the line,
+ *  - `lowerbound`/`upperbound` can only come straight after the score,
+ *  - `seldepth` needs a `depth`.
+ *
+ * Nothing is written unless send() is called. Example:
+ *
+ *     chesspp::info(output).depth(12).nodes(123456).score_cp(35).pv(moves).send();
+ *
+ * The writer is locked from info() until send(), so keep the chain short.
+ *
+ * @tparam Fields The fields that have been added so far
+ */
+template <uint32_t Fields = 0>
+class InfoBuilder
+{
+private:
+    template <uint32_t>
+    friend class InfoBuilder;
+    template <uint32_t>
+    friend class InfoScoreBuilder;
+
+    /**
+     * @brief The line being formatted
+     *
+     */
+    OutputWriter::Line line;
+
+    explicit InfoBuilder(OutputWriter::Line &&line) : line(std::move(line))
+    {
+    }
+
+    /**
+     * @brief Records that a field has been added
+     *
+     */
+    template <uint32_t Field>
+    InfoBuilder<Fields | Field> add()
+    {
+        static_assert((Fields & Field) == 0, "An info field can only be sent once");
+        static_assert((Fields & info_field::string) == 0, "string must be the last info field");
+        return InfoBuilder<Fields | Field>(std::move(line));
+    }
+
+    /**
+     * @brief Appends " <keyword> <value>" for an integer value
+     *
+     */
+    template <typename Integer>
+    void append_integer(std::string_view keyword, Integer value)
+    {
+        line.append(keyword);
+        line.append_integer(value);
+    }
+
+    /**
+     * @brief Appends " <keyword> <move1> ... <movei>"
+     *
+     */
+    template <typename Moves>
+    void append_moves(std::string_view keyword, Moves const &moves)
+    {
+        line.append(keyword);
+        for (auto const &move : moves)
+        {
+            line.append(' ');
+            line.append(std::string_view(move));
+        }
+    }
+
+public:
+    /**
+     * @brief Starts an info command
+     *
+     */
+    explicit InfoBuilder(OutputWriter &output) : line(output.begin_line("info"))
+    {
+        static_assert(Fields == 0, "Only an empty InfoBuilder can be started");
+    }
+
+    /**
+     * @brief Search depth in plies
+     *
+     */
+    InfoBuilder<Fields | info_field::depth> depth(int plies) &&
+    {
+        append_integer(" depth ", plies);
+        return add<info_field::depth>();
+    }
+
+    /**
+     * @brief Selective search depth in plies
+     *
+     */
+    InfoBuilder<Fields | info_field::seldepth> seldepth(int plies) &&
+    {
+        append_integer(" seldepth ", plies);
+        return add<info_field::seldepth>();
+    }
+
+    /**
+     * @brief The time searched in milliseconds
+     *
+     */
+    InfoBuilder<Fields | info_field::time> time(int64_t milliseconds) &&
+    {
+        append_integer(" time ", milliseconds);
+        return add<info_field::time>();
+    }
+
+    /**
+     * @brief The number of nodes searched
+     *
+     */
+    InfoBuilder<Fields | info_field::nodes> nodes(uint64_t count) &&
+    {
+        append_integer(" nodes ", count);
+        return add<info_field::nodes>();
+    }
+
+    /**
+     * @brief The best line found. `moves` is any range of strings or string
+     *        views.
+     *
+     */
+    template <typename Moves>
+    InfoBuilder<Fields | info_field::pv> pv(Moves const &moves) &&
+    {
+        append_moves(" pv", moves);
+        return add<info_field::pv>();
+    }
+
+    /**
+     * @brief The index of the line in multi pv mode, starting at 1
+     *
+     */
+    InfoBuilder<Fields | info_field::multipv> multipv(int index) &&
+    {
+        append_integer(" multipv ", index);
+        return add<info_field::multipv>();
+    }
+
+    /**
+     * @brief The score in centipawns from the engine's point of view. Can be
+     *        followed by lowerbound() or upperbound().
+     *
+     */
+    InfoScoreBuilder<Fields | info_field::score> score_cp(int centipawns) &&
+    {
+        append_integer(" score cp ", centipawns);
+        return InfoScoreBuilder<Fields | info_field::score>(add<info_field::score>());
+    }
+
+    /**
+     * @brief Mate in `moves` moves (not plies), negative if the engine is
+     *        getting mated. Can be followed by lowerbound() or upperbound().
+     *
+     */
+    InfoScoreBuilder<Fields | info_field::score> score_mate(int moves) &&
+    {
+        append_integer(" score mate ", moves);
+        return InfoScoreBuilder<Fields | info_field::score>(add<info_field::score>());
+    }
+
+    /**
+     * @brief The move currently being searched
+     *
+     */
+    InfoBuilder<Fields | info_field::currmove> currmove(std::string_view move) &&
+    {
+        line.append(" currmove ");
+        line.append(move);
+        return add<info_field::currmove>();
+    }
+
+    /**
+     * @brief The number of the move currently being searched, starting at 1
+     *
+     */
+    InfoBuilder<Fields | info_field::currmovenumber> currmovenumber(int number) &&
+    {
+        append_integer(" currmovenumber ", number);
+        return add<info_field::currmovenumber>();
+    }
+
+    /**
+     * @brief How full the hash is in permill
+     *
+     */
+    InfoBuilder<Fields | info_field::hashfull> hashfull(int permill) &&
+    {
+        append_integer(" hashfull ", permill);
+        return add<info_field::hashfull>();
+    }
+
+    /**
+     * @brief Nodes searched per second
+     *
+     */
+    InfoBuilder<Fields | info_field::nps> nps(uint64_t nodes_per_second) &&
+    {
+        append_integer(" nps ", nodes_per_second);
+        return add<info_field::nps>();
+    }
+
+    /**
+     * @brief Positions found in the endgame tablebases
+     *
+     */
+    InfoBuilder<Fields | info_field::tbhits> tbhits(uint64_t hits) &&
+    {
+        append_integer(" tbhits ", hits);
+        return add<info_field::tbhits>();
+    }
+
+    /**
+     * @brief Positions found in the Shredder endgame databases
+     *
+     */
+    InfoBuilder<Fields | info_field::sbhits> sbhits(uint64_t hits) &&
+    {
+        append_integer(" sbhits ", hits);
+        return add<info_field::sbhits>();
+    }
+
+    /**
+     * @brief CPU usage in permill
+     *
+     */
+    InfoBuilder<Fields | info_field::cpuload> cpuload(int permill) &&
+    {
+        append_integer(" cpuload ", permill);
+        return add<info_field::cpuload>();
+    }
+
+    /**
+     * @brief A move and the line that refutes it
+     *
+     */
+    template <typename Moves>
+    InfoBuilder<Fields | info_field::refutation> refutation(Moves const &moves) &&
+    {
+        append_moves(" refutation", moves);
+        return add<info_field::refutation>();
+    }
+
+    /**
+     * @brief The line a cpu is currently calculating
+     *
+     * @param cpu The number of the cpu, starting at 1
+     * @param moves The line
+     */
+    template <typename Moves>
+    InfoBuilder<Fields | info_field::currline> currline(int cpu, Moves const &moves) &&
+    {
+        append_integer(" currline ", cpu);
+        append_moves("", moves);
+        return add<info_field::currline>();
+    }
+
+    /**
+     * @brief A string for the interface to display. Must be the last field.
+     *
+     */
+    InfoBuilder<Fields | info_field::string> string(std::string_view text) &&
+    {
+        line.append(" string ");
+        line.append(text);
+        return add<info_field::string>();
+    }
+
+    /**
+     * @brief Ends the command and hands it to the writer
+     *
+     */
+    void send() &&
+    {
+        static_assert(Fields != 0, "An info command needs at least one field");
+        static_assert((Fields & info_field::seldepth) == 0 or (Fields & info_field::depth) != 0,
+                      "seldepth must be sent together with depth");
+        line.finish();
+    }
+};
+
+/**
+ * @brief An InfoBuilder whose last field is the score, the only place a bound
+ *        is allowed
+ *
+ * @tparam Fields The fields that have been added so far
+ */
+template <uint32_t Fields>
+class InfoScoreBuilder : public InfoBuilder<Fields>
+{
+private:
+    template <uint32_t>
+    friend class InfoBuilder;
+
+    explicit InfoScoreBuilder(InfoBuilder<Fields> &&builder) : InfoBuilder<Fields>(std::move(builder))
+    {
+    }
+
+public:
+    /**
+     * @brief The score is only a lower bound
+     *
+     */
+    InfoBuilder<Fields | info_field::bound> lowerbound() &&
+    {
+        this->line.append(" lowerbound");
+        return this->template add<info_field::bound>();
+    }
+
+    /**
+     * @brief The score is only an upper bound
+     *
+     */
+    InfoBuilder<Fields | info_field::bound> upperbound() &&
+    {
+        this->line.append(" upperbound");
+        return this->template add<info_field::bound>();
+    }
+};
+
+/**
+ * @brief Starts an info command on a writer
+ *
+ */
+inline InfoBuilder<> info(OutputWriter &output)
+{
+    return InfoBuilder<>(output);
+}
+
+} // namespace chesspp
+
+#endif
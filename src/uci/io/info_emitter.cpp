@@ -0,0 +1,270 @@
+#include "info_emitter.hpp"
+
+chesspp::InfoEmitter::InfoEmitter(
+    OutputWriter &output, Clock::duration interval, Clock::time_point (*now)())
+    : output(output), interval(interval), now(now), last_line(now() - interval)
+{
+}
+
+void chesspp::InfoEmitter::set(uint32_t field)
+{
+    stats.updates++;
+    if (pending & field)
+    {
+        stats.coalesced++;
+    }
+    pending |= field;
+}
+
+void chesspp::InfoEmitter::emit_if_due()
+{
+    if (pending != 0 and now() - last_line >= interval)
+    {
+        emit();
+    }
+}
+
+void chesspp::InfoEmitter::emit()
+{
+    if (pending == 0)
+    {
+        return;
+    }
+
+    // Only one pv fits on a line
+    bool fields = true;
+    for (PendingPv &pv : pvs)
+    {
+        if (pv.pending)
+        {
+            write_line(&pv, fields);
+            pv.pending = false;
+            fields = false;
+        }
+    }
+    if (fields)
+    {
+        write_line(nullptr, true);
+    }
+
+    pending = 0;
+    last_line = now();
+}
+
+void chesspp::InfoEmitter::write_line(PendingPv const *pv, bool fields)
+{
+    OutputWriter::Line line = output.begin_line("info");
+    if (pv != nullptr)
+    {
+        PvInfo const &info = pv->info;
+        line.append(" depth ");
+        line.append_integer(info.depth);
+        if (info.seldepth > 0)
+        {
+            line.append(" seldepth ");
+            line.append_integer(info.seldepth);
+        }
+        if (info.multipv > 0)
+        {
+            line.append(" multipv ");
+            line.append_integer(info.multipv);
+        }
+        line.append(info.mate ? " score mate " : " score cp ");
+        line.append_integer(info.score);
+        if (info.bound == PvInfo::Bound::lower)
+        {
+            line.append(" lowerbound");
+        }
+        else if (info.bound == PvInfo::Bound::upper)
+        {
+            line.append(" upperbound");
+        }
+    }
+    if (fields)
+    {
+        if (pending & info_field::nodes)
+        {
+            line.append(" nodes ");
+            line.append_integer(nodes_value);
+        }
+        if (pending & info_field::nps)
+        {
+            line.append(" nps ");
+            line.append_integer(nps_value);
+        }
+        if (pending & info_field::time)
+        {
+            line.append(" time ");
+            line.append_integer(time_value);
+        }
+        if (pending & info_field::hashfull)
+        {
+            line.append(" hashfull ");
+            line.append_integer(hashfull_value);
+        }
+        if (pending & info_field::tbhits)
+        {
+            line.append(" tbhits ");
+            line.append_integer(tbhits_value);
+        }
+        if (pending & info_field::cpuload)
+        {
+            line.append(" cpuload ");
+            line.append_integer(cpuload_value);
+        }
+        if (pending & info_field::currmove)
+        {
+            line.append(" currmove ");
+            line.append(currmove_value);
+            line.append(" currmovenumber ");
+            line.append_integer(currmovenumber_value);
+        }
+    }
+    if (pv != nullptr)
+    {
+        line.append(" pv");
+        line.append(pv->moves);
+        last_pv_depth = pv->info.depth;
+    }
+    line.finish();
+    stats.lines++;
+}
+
+void chesspp::InfoEmitter::set_pv(PvInfo const &info)
+{
+    bool const new_depth = info.depth != last_pv_depth;
+
+    // Pvs pending from the last depth go out before this one
+    if (new_depth and (pending & info_field::pv))
+    {
+        emit();
+    }
+
+    size_t const index = info.multipv > 0 ? static_cast<size_t>(info.multipv) : 0;
+    if (index >= pvs.size())
+    {
+        pvs.resize(index + 1);
+    }
+    PendingPv &pv = pvs[index];
+    stats.updates++;
+    if (pv.pending)
+    {
+        stats.coalesced++;
+    }
+    pv.info = info;
+    pv.moves.swap(new_moves);
+    pv.pending = true;
+    pending |= info_field::pv;
+
+    if (new_depth)
+    {
+        emit();
+    }
+    else
+    {
+        emit_if_due();
+    }
+}
+
+void chesspp::InfoEmitter::nodes(uint64_t count)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    nodes_value = count;
+    set(info_field::nodes);
+    emit_if_due();
+}
+
+void chesspp::InfoEmitter::nps(uint64_t nodes_per_second)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    nps_value = nodes_per_second;
+    set(info_field::nps);
+    emit_if_due();
+}
+
+void chesspp::InfoEmitter::time(int64_t milliseconds)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    time_value = milliseconds;
+    set(info_field::time);
+    emit_if_due();
+}
+
+void chesspp::InfoEmitter::hashfull(int permill)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    hashfull_value = permill;
+    set(info_field::hashfull);
+    emit_if_due();
+}
+
+void chesspp::InfoEmitter::tbhits(uint64_t hits)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    tbhits_value = hits;
+    set(info_field::tbhits);
+    emit_if_due();
+}
+
+void chesspp::InfoEmitter::cpuload(int permill)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    cpuload_value = permill;
+    set(info_field::cpuload);
+    emit_if_due();
+}
+
+void chesspp::InfoEmitter::currmove(std::string_view move, int number)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    currmove_value.assign(move.data(), move.size());
+    currmovenumber_value = number;
+    set(info_field::currmove);
+    emit_if_due();
+}
+
+void chesspp::InfoEmitter::string(std::string_view text)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    emit();
+    info(output).string(text).send();
+    stats.updates++;
+    stats.lines++;
+}
+
+void chesspp::InfoEmitter::bestmove(std::string_view move, std::string_view ponder)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    emit();
+
+    OutputWriter::Line line = output.begin_line("bestmove");
+    line.append(' ');
+    line.append(move);
+    if (not ponder.empty())
+    {
+        line.append(" ponder ");
+        line.append(ponder);
+    }
+    line.finish();
+
+    // The next search starts from scratch
+    last_pv_depth = -1;
+}
+
+void chesspp::InfoEmitter::poll()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    emit_if_due();
+}
+
+void chesspp::InfoEmitter::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    emit();
+}
+
+chesspp::InfoEmitterStats chesspp::InfoEmitter::get_stats()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
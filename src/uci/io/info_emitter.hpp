@@ -0,0 +1,337 @@
+/**
+ * @file info_emitter.hpp
+ * @brief Rate limits `info` output by merging updates
+ *
+ */
+
+#ifndef SRC_UCI_IO_INFO_EMITTER_H
+#define SRC_UCI_IO_INFO_EMITTER_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "info_builder.hpp"
+#include "output_writer.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief The search result that goes with a `pv`
+ *
+ */
+struct PvInfo
+{
+    enum class Bound
+    {
+        exact,
+        lower,
+        upper
+    };
+
+    /**
+     * @brief Search depth in plies
+     *
+     */
+    int depth = 0;
+
+    /**
+     * @brief Selective search depth in plies, not sent if 0
+     *
+     */
+    int seldepth = 0;
+
+    /**
+     * @brief The index of the line in multi pv mode, not sent if 0
+     *
+     */
+    int multipv = 0;
+
+    /**
+     * @brief The score in centipawns, or in moves to mate if `mate` is set
+     *
+     */
+    int score = 0;
+
+    /**
+     * @brief Whether `score` is a mate score
+     *
+     */
+    bool mate = false;
+
+    /**
+     * @brief Whether `score` is exact or only a bound
+     *
+     */
+    Bound bound = Bound::exact;
+};
+
+/**
+ * @brief Counters describing how an InfoEmitter has merged updates
+ *
+ */
+struct InfoEmitterStats
+{
+    /**
+     * @brief The number of updates passed to the emitter
+     *
+     */
+    uint64_t updates = 0;
+
+    /**
+     * @brief The number of updates that replaced a pending value and so never
+     *        reached the output
+     *
+     */
+    uint64_t coalesced = 0;
+
+    /**
+     * @brief The number of `info` lines written
+     *
+     */
+    uint64_t lines = 0;
+};
+
+/**
+ * @brief Merges frequent `info` updates so that at most one line is written
+ *        per interval, to protect slow interfaces and pipes.
+ *
+ * Only the latest value of each field is kept until the next line is due.
+ * Each multipv line keeps its own pending pv, so the lines of a multipv
+ * search are merged separately and each is written on a line of its own.
+ * Some updates are never delayed or dropped:
+ *  - a pv at a new depth is written straight away, together with anything
+ *    pending. Pvs still pending from the last depth are written first.
+ *  - `string` messages and `bestmove` are written straight away, after
+ *    anything pending so the order is kept.
+ *
+ * Pending values are written when the next update arrives after the interval
+ * has passed, or when poll() or flush() is called. All member functions are
+ * thread safe.
+ */
+class InfoEmitter
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    /**
+     * @brief Where the lines are written
+     *
+     */
+    OutputWriter &output;
+
+    /**
+     * @brief The minimum time between merged lines
+     *
+     */
+    Clock::duration interval;
+
+    /**
+     * @brief Gets the current time. Replaceable for testing.
+     *
+     */
+    Clock::time_point (*now)();
+
+    /**
+     * @brief When the last line was written
+     *
+     */
+    Clock::time_point last_line;
+
+    /**
+     * @brief The info_field bits of the values waiting to be written
+     *
+     */
+    uint32_t pending = 0;
+
+    uint64_t nodes_value = 0;
+    uint64_t nps_value = 0;
+    uint64_t tbhits_value = 0;
+    int64_t time_value = 0;
+    int hashfull_value = 0;
+    int cpuload_value = 0;
+    int currmovenumber_value = 0;
+    std::string currmove_value;
+
+    /**
+     * @brief A pv and its search result, waiting to be written
+     *
+     */
+    struct PendingPv
+    {
+        PvInfo info;
+        std::string moves;
+        bool pending = false;
+    };
+
+    /**
+     * @brief The pvs by multipv index, 0 for a search without multipv
+     *
+     */
+    std::vector<PendingPv> pvs;
+
+    /**
+     * @brief The moves of the pv being stored. Swapped into its PendingPv by
+     *        set_pv(), once anything that has to go out first is written.
+     *
+     */
+    std::string new_moves;
+
+    /**
+     * @brief The depth of the last pv that was written, or -1 if none has
+     *        been
+     *
+     */
+    int last_pv_depth = -1;
+
+    InfoEmitterStats stats;
+
+    std::mutex mutex;
+
+    /**
+     * @brief Records that a field has a new value
+     *
+     */
+    void set(uint32_t field);
+
+    /**
+     * @brief Writes a line if one is due. The caller must hold `mutex`.
+     *
+     */
+    void emit_if_due();
+
+    /**
+     * @brief Writes everything pending, as one line per pending pv with the
+     *        other fields on the first. The caller must hold `mutex`.
+     *
+     */
+    void emit();
+
+    /**
+     * @brief Writes one `info` line
+     *
+     * @param pv The pv to write, or `nullptr` for none
+     * @param fields Whether to write the pending fields other than the pv
+     */
+    void write_line(PendingPv const *pv, bool fields);
+
+    /**
+     * @brief Stores a pv with the moves in `new_moves`, writing it straight
+     *        away if it starts a new depth
+     *
+     */
+    void set_pv(PvInfo const &info);
+
+public:
+    /**
+     * @brief Construct a new InfoEmitter object
+     *
+     * @param output Where the lines are written
+     * @param interval The minimum time between merged lines
+     * @param now The clock to use
+     */
+    InfoEmitter(
+        OutputWriter &output,
+        Clock::duration interval = std::chrono::milliseconds(100),
+        Clock::time_point (*now)() = &Clock::now);
+
+    /**
+     * @brief The number of nodes searched
+     *
+     */
+    void nodes(uint64_t count);
+
+    /**
+     * @brief Nodes searched per second
+     *
+     */
+    void nps(uint64_t nodes_per_second);
+
+    /**
+     * @brief The time searched in milliseconds
+     *
+     */
+    void time(int64_t milliseconds);
+
+    /**
+     * @brief How full the hash is in permill
+     *
+     */
+    void hashfull(int permill);
+
+    /**
+     * @brief Positions found in the endgame tablebases
+     *
+     */
+    void tbhits(uint64_t hits);
+
+    /**
+     * @brief CPU usage in permill
+     *
+     */
+    void cpuload(int permill);
+
+    /**
+     * @brief The move currently being searched and its number
+     *
+     */
+    void currmove(std::string_view move, int number);
+
+    /**
+     * @brief The best line found and its search result. `moves` is any range
+     *        of strings or string views.
+     *
+     */
+    template <typename Moves>
+    void pv(PvInfo const &info, Moves const &moves)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        new_moves.clear();
+        for (auto const &move : moves)
+        {
+            new_moves.push_back(' ');
+            new_moves.append(std::string_view(move));
+        }
+        set_pv(info);
+    }
+
+    /**
+     * @brief Writes a string message, after anything pending
+     *
+     */
+    void string(std::string_view text);
+
+    /**
+     * @brief Writes the best move, after anything pending
+     *
+     * @param move The best move
+     * @param ponder The move to ponder on, not sent if empty
+     */
+    void bestmove(std::string_view move, std::string_view ponder = {});
+
+    /**
+     * @brief Writes pending values if a line is due
+     *
+     */
+    void poll();
+
+    /**
+     * @brief Writes pending values now
+     *
+     */
+    void flush();
+
+    /**
+     * @brief Get the counters
+     *
+     */
+    InfoEmitterStats get_stats();
+};
+
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,110 @@
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+
+#include "line_reader.hpp"
+
+size_t chesspp::FdSource::read(char *data, size_t size)
+{
+    while (true)
+    {
+        ssize_t const count = ::read(fd, data, size);
+        if (count > 0)
+        {
+            return static_cast<size_t>(count);
+        }
+        if (count < 0 and errno == EINTR)
+        {
+            continue;
+        }
+        return 0;
+    }
+}
+
+chesspp::LineReader::LineReader(int fd, size_t capacity)
+    : fd_source(fd), source(&fd_source), buffer(capacity > 0 ? capacity : 1)
+{
+}
+
+chesspp::LineReader::LineReader(InputSource &source, size_t capacity)
+    : fd_source(-1), source(&source), buffer(capacity > 0 ? capacity : 1)
+{
+}
+
+bool chesspp::LineReader::fill()
+{
+    if (closed)
+    {
+        return false;
+    }
+
+    // Move the unfinished line to the front of the buffer to make room after
+    // it, and only grow the buffer if the line already fills it.
+    if (begin > 0)
+    {
+        std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+    if (end == buffer.size())
+    {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    size_t const count = source->read(buffer.data() + end, buffer.size() - end);
+    if (count == 0)
+    {
+        closed = true;
+        return false;
+    }
+    filled_at = instrumentation::now();
+    end += count;
+    total_read += count;
+    return true;
+}
+
+bool chesspp::LineReader::next_line(std::string_view &line)
+{
+    // Only search the bytes that have not been searched yet
+    size_t searched = begin;
+    while (true)
+    {
+        char const *const newline = static_cast<char const *>(
+            std::memchr(buffer.data() + searched, '\n', end - searched));
+
+        if (newline != nullptr)
+        {
+            size_t length = newline - (buffer.data() + begin);
+            if (length > 0 and buffer[begin + length - 1] == '\r')
+            {
+                length--;
+            }
+            line = std::string_view(buffer.data() + begin, length);
+            begin = newline - buffer.data() + 1;
+            return true;
+        }
+
+        searched = end - begin;
+        if (not fill())
+        {
+            break;
+        }
+        // fill() moved the unfinished line to the front of the buffer
+        searched += begin;
+    }
+
+    // Return whatever is left as the last line
+    if (begin == end)
+    {
+        return false;
+    }
+    size_t length = end - begin;
+    if (buffer[begin + length - 1] == '\r')
+    {
+        length--;
+    }
+    line = std::string_view(buffer.data() + begin, length);
+    begin = end;
+    return true;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file line_reader.hpp
+ * @brief Reads lines straight from a file descriptor or another source of
+ *        bytes
+ *
+ */
+
+#ifndef SRC_UCI_IO_LINE_READER_H
+#define SRC_UCI_IO_LINE_READER_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "../instrumentation/probes.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief Somewhere a LineReader can get its bytes from
+ *
+ */
+class InputSource
+{
+public:
+    virtual ~InputSource() = default;
+
+    /**
+     * @brief Reads at least one byte, blocking until there is one
+     *
+     * @return size_t The number of bytes read, 0 once the input is closed
+     */
+    virtual size_t read(char *data, size_t size) = 0;
+};
+
+/**
+ * @brief Reads from a file descriptor with read(2)
+ *
+ */
+class FdSource : public InputSource
+{
+private:
+    /**
+     * @brief The descriptor to read from. Not owned.
+     *
+     */
+    int fd;
+
+public:
+    explicit FdSource(int fd) : fd(fd)
+    {
+    }
+
+    size_t read(char *data, size_t size) override;
+};
+
+/**
+ * @brief Reads newline terminated lines from a file descriptor with read(2),
+ *        bypassing iostreams. Works with any readable descriptor: stdin, a
+ *        pipe, a file or a socket, or with any other InputSource.
+ *
+ * Bytes are read into a buffer that is reused for the lifetime of the reader.
+ * Complete lines are returned as views into that buffer, a line that is split
+ * across reads is kept until the rest of it arrives, and the buffer only
+ * grows if a single line does not fit in it.
+ */
+class LineReader
+{
+private:
+    /**
+     * @brief The source used when constructed from a descriptor
+     *
+     */
+    FdSource fd_source;
+
+    /**
+     * @brief Where the bytes come from. Not owned.
+     *
+     */
+    InputSource *source;
+
+    /**
+     * @brief Holds bytes that have been read but not returned yet
+     *
+     */
+    std::vector<char> buffer;
+
+    /**
+     * @brief The first byte in `buffer` that has not been returned yet
+     *
+     */
+    size_t begin = 0;
+
+    /**
+     * @brief One past the last byte in `buffer` that has been read
+     *
+     */
+    size_t end = 0;
+
+    /**
+     * @brief Set once the source has reported the end of the input or an
+     *        error
+     *
+     */
+    bool closed = false;
+
+    /**
+     * @brief The number of bytes read so far
+     *
+     */
+    uint64_t total_read = 0;
+
+    /**
+     * @brief When the last read returned
+     *
+     */
+    instrumentation::Timestamp filled_at;
+
+    /**
+     * @brief Reads more bytes into the buffer, making room first
+     *
+     * @return true If any bytes were read
+     * @return false If the input is closed
+     */
+    bool fill();
+
+public:
+    /**
+     * @brief Construct a new LineReader object
+     *
+     * @param fd The descriptor to read from. It is not closed by the reader.
+     * @param capacity The initial size of the buffer in bytes
+     */
+    explicit LineReader(int fd, size_t capacity = 64 * 1024);
+
+    /**
+     * @brief Construct a new LineReader object
+     *
+     * @param source Where to read from. Must outlive the reader.
+     * @param capacity The initial size of the buffer in bytes
+     */
+    explicit LineReader(InputSource &source, size_t capacity = 64 * 1024);
+
+    LineReader(LineReader const &) = delete;
+    LineReader &operator=(LineReader const &) = delete;
+
+    /**
+     * @brief Reads the next line, blocking until one is complete
+     *
+     * @param line Set to the line without its "\n" or "\r\n" ending. Only
+     *        valid until the next call.
+     * @return true If a line was read
+     * @return false If the input is closed and every line has been returned. A
+     *         last line without an ending is still returned before this.
+     */
+    bool next_line(std::string_view &line);
+
+    /**
+     * @brief Get when the last line returned arrived, ie. when the read
+     *        that completed it returned. Only measured with
+     *        CHESSPP_INSTRUMENTATION.
+     *
+     */
+    instrumentation::Timestamp received_at() const
+    {
+        return filled_at;
+    }
+
+    /**
+     * @brief Get the number of bytes read from the source so far
+     *
+     */
+    uint64_t bytes_read() const
+    {
+        return total_read;
+    }
+};
+
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,76 @@
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped_file.hpp"
+
+chesspp::MappedFile::MappedFile(std::string const &path)
+{
+    int const fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return;
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) == 0 and S_ISREG(status.st_mode))
+    {
+        // An empty file can't be mapped, but is still a file
+        size = static_cast<size_t>(status.st_size);
+        if (size == 0)
+        {
+            opened = true;
+        }
+        else
+        {
+            void *const mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED)
+            {
+                address = mapping;
+                opened = true;
+                // It is read front to back, so let the kernel read ahead
+                madvise(address, size, MADV_SEQUENTIAL);
+            }
+            else
+            {
+                size = 0;
+            }
+        }
+    }
+
+    // The mapping stays valid without the descriptor
+    close(fd);
+}
+
+chesspp::MappedFile::~MappedFile()
+{
+    if (address != nullptr)
+    {
+        munmap(address, size);
+    }
+}
+
+chesspp::MappedFile::MappedFile(MappedFile &&other) noexcept
+    : address(std::exchange(other.address, nullptr)),
+      size(std::exchange(other.size, 0)),
+      opened(std::exchange(other.opened, false))
+{
+}
+
+chesspp::MappedFile &chesspp::MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        if (address != nullptr)
+        {
+            munmap(address, size);
+        }
+        address = std::exchange(other.address, nullptr);
+        size = std::exchange(other.size, 0);
+        opened = std::exchange(other.opened, false);
+    }
+    return *this;
+}
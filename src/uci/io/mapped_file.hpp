@@ -0,0 +1,78 @@
+/**
+ * @file mapped_file.hpp
+ * @brief Maps a whole file into memory for reading
+ *
+ */
+
+#ifndef SRC_UCI_IO_MAPPED_FILE_H
+#define SRC_UCI_IO_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace chesspp
+{
+/**
+ * @brief A read-only, private mapping of a file. The kernel pages the file in
+ *        as it is read, so even a very large file can be walked through
+ *        without copying it into a buffer first.
+ *
+ */
+class MappedFile
+{
+private:
+    /**
+     * @brief The start of the mapping, nullptr if nothing is mapped
+     *
+     */
+    void *address = nullptr;
+
+    size_t size = 0;
+
+    /**
+     * @brief Set if the file was opened, even if it is empty
+     *
+     */
+    bool opened = false;
+
+public:
+    MappedFile() = default;
+
+    /**
+     * @brief Maps a file, see is_open() for whether it worked
+     *
+     * @param path The file to map
+     */
+    explicit MappedFile(std::string const &path);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+    MappedFile(MappedFile const &) = delete;
+    MappedFile &operator=(MappedFile const &) = delete;
+
+    /**
+     * @brief Check whether the file could be opened and mapped
+     *
+     */
+    bool is_open() const
+    {
+        return opened;
+    }
+
+    /**
+     * @brief Get the contents of the file. Valid for as long as the
+     *        MappedFile is.
+     *
+     */
+    std::string_view data() const
+    {
+        return std::string_view(static_cast<char const *>(address), size);
+    }
+};
+
+} // namespace chesspp
+
+#endif
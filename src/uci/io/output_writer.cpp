@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <cerrno>
+#include <utility>
+
+#include <unistd.h>
+
+#include "output_writer.hpp"
+#include "../replay/recorder.hpp"
+
+void chesspp::FdSink::write(std::string_view data)
+{
+    while (not data.empty())
+    {
+        ssize_t const count = ::write(fd, data.data(), data.size());
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // The other end has gone away, nothing more can be written
+            return;
+        }
+        data.remove_prefix(count);
+    }
+}
+
+chesspp::OutputWriter::OutputWriter(
+    OutputSink &sink,
+    size_t flush_size,
+    std::chrono::steady_clock::duration flush_interval)
+    : sink(sink), flush_size(flush_size), flush_interval(flush_interval)
+{
+    buffer.reserve(flush_size);
+}
+
+chesspp::OutputWriter::~OutputWriter()
+{
+    if (flusher.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        buffered.notify_one();
+        flusher.join();
+    }
+    flush();
+}
+
+chesspp::OutputWriter::Line::Line(OutputWriter &output, std::string_view name)
+    : output(&output),
+      lock(output.mutex),
+      name(name),
+      start(output.buffer.size()),
+      started(instrumentation::now())
+{
+    output.buffer.append(name);
+}
+
+chesspp::OutputWriter::Line::Line(Line &&other) noexcept
+    : output(std::exchange(other.output, nullptr)),
+      lock(std::move(other.lock)),
+      name(other.name),
+      start(other.start),
+      started(other.started)
+{
+}
+
+chesspp::OutputWriter::Line::~Line()
+{
+    // Drop a line that was never finished
+    if (output != nullptr)
+    {
+        output->buffer.resize(start);
+    }
+}
+
+void chesspp::OutputWriter::Line::finish()
+{
+    output->buffer.push_back('\n');
+    output->finish_command(name, start, started);
+    output = nullptr;
+    lock.unlock();
+}
+
+void chesspp::OutputWriter::write(std::string_view name, TokenSpan arguments)
+{
+    Line line(*this, name);
+    for (std::string_view argument : arguments)
+    {
+        line.append(' ');
+        line.append(argument);
+    }
+    line.finish();
+}
+
+void chesspp::OutputWriter::write(
+    std::string_view name, std::vector<std::string> const &arguments)
+{
+    Line line(*this, name);
+    for (std::string const &argument : arguments)
+    {
+        line.append(' ');
+        line.append(argument);
+    }
+    line.finish();
+}
+
+void chesspp::OutputWriter::finish_command(
+    std::string_view name, size_t start, instrumentation::Timestamp started)
+{
+    auto const now = std::chrono::steady_clock::now();
+    if (start == 0)
+    {
+        oldest = now;
+    }
+
+    commands_written.add(name);
+    if (recorder != nullptr)
+    {
+        // Without the newline
+        recorder->record(
+            Direction::to_interface,
+            std::string_view(buffer).substr(start, buffer.size() - start - 1));
+    }
+    if constexpr (instrumentation::enabled)
+    {
+        buffered_at.push_back(started);
+    }
+
+    bool const critical = std::find(
+        flush_commands.begin(), flush_commands.end(), name) != flush_commands.end();
+    if (critical or buffer.size() >= flush_size or now - oldest >= flush_interval)
+    {
+        flush_buffer();
+    }
+    else if (start == 0)
+    {
+        // The buffer was empty, so the flusher has nothing to wait for yet
+        if (not flusher.joinable())
+        {
+            flusher = std::thread(&OutputWriter::flush_when_due, this);
+        }
+        buffered.notify_one();
+    }
+}
+
+void chesspp::OutputWriter::flush_when_due()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (not stopping)
+    {
+        if (buffer.empty())
+        {
+            buffered.wait(lock);
+            continue;
+        }
+        auto const due = oldest + flush_interval;
+        if (std::chrono::steady_clock::now() < due)
+        {
+            buffered.wait_until(lock, due);
+            continue;
+        }
+        flush_buffer();
+    }
+}
+
+void chesspp::OutputWriter::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    flush_buffer();
+}
+
+void chesspp::OutputWriter::flush_buffer()
+{
+    if (not buffer.empty())
+    {
+        sink.write(buffer);
+
+        if constexpr (instrumentation::enabled)
+        {
+            instrumentation::Timestamp const written = instrumentation::now();
+            for (instrumentation::Timestamp const started : buffered_at)
+            {
+                write_latency.record(instrumentation::elapsed(started, written));
+            }
+            buffered_at.clear();
+            bytes_written.add(buffer.size());
+        }
+
+        // clear() keeps the capacity for the next batch
+        buffer.clear();
+    }
+}
+
+void chesspp::OutputWriter::set_flush_commands(std::vector<std::string> const &commands)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    flush_commands = commands;
+}
+
+void chesspp::OutputWriter::set_recorder(Recorder *recorder)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->recorder = recorder;
+}
+
+void chesspp::OutputWriter::get_stats(StatsSnapshot &stats) const
+{
+    write_latency.snapshot(stats.write);
+    stats.bytes_out = bytes_written.load();
+    commands_written.snapshot(stats.commands_out);
+}
+
+chesspp::OutputWriter &chesspp::OutputWriter::standard()
+{
+    static FdSink stdout_sink(STDOUT_FILENO);
+    static OutputWriter writer(stdout_sink);
+    return writer;
+}
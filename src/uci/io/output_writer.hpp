@@ -0,0 +1,379 @@
+/**
+ * @file output_writer.hpp
+ * @brief Buffers outgoing commands and writes them in batches
+ *
+ */
+
+#ifndef SRC_UCI_IO_OUTPUT_WRITER_H
+#define SRC_UCI_IO_OUTPUT_WRITER_H
+
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "chesspp/argument.hpp"
+#include "chesspp/stats.hpp"
+#include "../instrumentation/probes.hpp"
+
+namespace chesspp
+{
+class Recorder;
+
+/**
+ * @brief Somewhere an OutputWriter can send its bytes
+ *
+ */
+class OutputSink
+{
+public:
+    virtual ~OutputSink() = default;
+
+    /**
+     * @brief Writes all of `data`, blocking if necessary
+     *
+     */
+    virtual void write(std::string_view data) = 0;
+};
+
+/**
+ * @brief Writes to a file descriptor with write(2)
+ *
+ */
+class FdSink : public OutputSink
+{
+private:
+    /**
+     * @brief The descriptor to write to. Not owned.
+     *
+     */
+    int fd;
+
+public:
+    explicit FdSink(int fd) : fd(fd)
+    {
+    }
+
+    void write(std::string_view data) override;
+};
+
+/**
+ * @brief Collects everything written to it in memory
+ *
+ */
+class StringSink : public OutputSink
+{
+public:
+    /**
+     * @brief Everything that has been written
+     *
+     */
+    std::string data;
+
+    /**
+     * @brief The number of times write() was called
+     *
+     */
+    size_t writes = 0;
+
+    void write(std::string_view data) override
+    {
+        this->data.append(data);
+        writes++;
+    }
+};
+
+/**
+ * @brief Formats outgoing commands into a reusable buffer and hands them to a
+ *        sink in batches, so a burst of `info` lines costs one write instead of
+ *        one per line.
+ *
+ * The buffer is flushed when:
+ *  - a latency critical command (`bestmove`, `readyok`, `uciok` by default)
+ *    is written,
+ *  - it holds at least `flush_size` bytes,
+ *  - the oldest buffered command is `flush_interval` old, even if nothing
+ *    else is written,
+ *  - flush() is called (the engine does this before it waits for input).
+ *
+ * The time limit is kept by a thread that sleeps until the oldest buffered
+ * command is due. It is started the first time a command is left in the
+ * buffer, so a writer that always flushes straight away never starts it.
+ *
+ * All member functions are thread safe.
+ */
+class OutputWriter
+{
+private:
+    /**
+     * @brief Where the output goes
+     *
+     */
+    OutputSink &sink;
+
+    /**
+     * @brief Commands that have been formatted but not written yet
+     *
+     */
+    std::string buffer;
+
+    /**
+     * @brief Flush once the buffer holds this many bytes
+     *
+     */
+    size_t flush_size;
+
+    /**
+     * @brief Flush once the oldest buffered command is this old
+     *
+     */
+    std::chrono::steady_clock::duration flush_interval;
+
+    /**
+     * @brief When the oldest command in the buffer was written
+     *
+     */
+    std::chrono::steady_clock::time_point oldest;
+
+    /**
+     * @brief Commands that are flushed as soon as they are written
+     *
+     */
+    std::vector<std::string> flush_commands = {"bestmove", "readyok", "uciok"};
+
+    std::mutex mutex;
+
+    /**
+     * @brief Wakes the flusher when the buffer stops being empty, or the
+     *        writer is destroyed
+     *
+     */
+    std::condition_variable buffered;
+
+    /**
+     * @brief Set when the writer is destroyed
+     *
+     */
+    bool stopping = false;
+
+    /**
+     * @brief Flushes the buffer once its oldest command is `flush_interval`
+     *        old. Not started until a command is left in the buffer.
+     *
+     */
+    std::thread flusher;
+
+    /**
+     * @brief From a command being started to it being written to the sink
+     *
+     */
+    instrumentation::LatencyHistogram write_latency;
+    instrumentation::Counter bytes_written;
+    instrumentation::CommandCounters commands_written;
+
+    /**
+     * @brief When each command in the buffer was started. Only used with
+     *        CHESSPP_INSTRUMENTATION.
+     *
+     */
+    std::vector<instrumentation::Timestamp> buffered_at;
+
+    /**
+     * @brief Records every command written, if set
+     *
+     */
+    Recorder *recorder = nullptr;
+
+    /**
+     * @brief Writes the buffer to the sink. The caller must hold `mutex`.
+     *
+     */
+    void flush_buffer();
+
+    /**
+     * @brief Called once a command has been appended to the buffer. Flushes
+     *        if any of the flush conditions hold. The caller must hold `mutex`.
+     *
+     * @param name The name of the command that was appended
+     * @param start Where the command starts in the buffer
+     * @param started When the command was started
+     */
+    void finish_command(
+        std::string_view name, size_t start, instrumentation::Timestamp started);
+
+    /**
+     * @brief The flusher thread
+     *
+     */
+    void flush_when_due();
+
+public:
+    /**
+     * @brief A command being formatted directly into the writer's buffer.
+     *        Holds the writer's lock until it is finished or destroyed, so
+     *        lines from different threads never interleave. A line that is
+     *        destroyed without being finished is discarded.
+     *
+     */
+    class Line
+    {
+    private:
+        /**
+         * @brief The writer being written to, `nullptr` once finished or
+         *        moved from
+         *
+         */
+        OutputWriter *output;
+
+        std::unique_lock<std::mutex> lock;
+
+        /**
+         * @brief The name of the command. Must outlive the line.
+         *
+         */
+        std::string_view name;
+
+        /**
+         * @brief Where the line starts in the writer's buffer
+         *
+         */
+        size_t start;
+
+        /**
+         * @brief When the line was started
+         *
+         */
+        instrumentation::Timestamp started;
+
+    public:
+        Line(OutputWriter &output, std::string_view name);
+        Line(Line &&other) noexcept;
+        Line(Line const &) = delete;
+        Line &operator=(Line const &) = delete;
+        Line &operator=(Line &&) = delete;
+        ~Line();
+
+        /**
+         * @brief Appends text to the line
+         *
+         */
+        void append(std::string_view text)
+        {
+            output->buffer.append(text);
+        }
+
+        /**
+         * @brief Appends a single character to the line
+         *
+         */
+        void append(char character)
+        {
+            output->buffer.push_back(character);
+        }
+
+        /**
+         * @brief Appends an integer to the line in decimal without allocating
+         *
+         */
+        template <typename Integer>
+        void append_integer(Integer value)
+        {
+            char digits[24];
+            std::to_chars_result const result =
+                std::to_chars(digits, digits + sizeof(digits), value);
+            output->buffer.append(digits, result.ptr - digits);
+        }
+
+        /**
+         * @brief Ends the line and lets the writer flush it if it needs to
+         *
+         */
+        void finish();
+    };
+
+    /**
+     * @brief Construct a new OutputWriter object
+     *
+     * @param sink Where to write the output. Must outlive the writer.
+     * @param flush_size Flush once the buffer holds this many bytes
+     * @param flush_interval Flush once the oldest buffered command is this old
+     */
+    explicit OutputWriter(
+        OutputSink &sink,
+        size_t flush_size = 4096,
+        std::chrono::steady_clock::duration flush_interval = std::chrono::milliseconds(10));
+
+    /**
+     * @brief Stops the flusher and flushes anything still buffered
+     *
+     */
+    ~OutputWriter();
+
+    OutputWriter(OutputWriter const &) = delete;
+    OutputWriter &operator=(OutputWriter const &) = delete;
+
+    /**
+     * @brief Writes a command and its arguments as one line
+     *
+     * @param name The name of the command
+     * @param arguments The arguments, separated by single spaces
+     */
+    void write(std::string_view name, TokenSpan arguments);
+
+    /**
+     * @brief Writes a command and its arguments as one line
+     *
+     */
+    void write(std::string_view name, std::vector<std::string> const &arguments);
+
+    /**
+     * @brief Starts formatting a command directly into the buffer
+     *
+     * @param name The name of the command. Must outlive the line.
+     */
+    Line begin_line(std::string_view name)
+    {
+        return Line(*this, name);
+    }
+
+    /**
+     * @brief Writes everything that is buffered to the sink
+     *
+     */
+    void flush();
+
+    /**
+     * @brief Replace the commands that are flushed as soon as they are written
+     *
+     */
+    void set_flush_commands(std::vector<std::string> const &commands);
+
+    /**
+     * @brief Fills in the write latency, bytes out and commands out of a
+     *        snapshot. They stay zero without CHESSPP_INSTRUMENTATION.
+     *
+     */
+    void get_stats(StatsSnapshot &stats) const;
+
+    /**
+     * @brief Record every command written from now on, or stop recording if
+     *        `recorder` is `nullptr`
+     *
+     * @param recorder Must outlive the writer, or be replaced first
+     */
+    void set_recorder(Recorder *recorder);
+
+    /**
+     * @brief Get the writer for standard output
+     *
+     */
+    static OutputWriter &standard();
+};
+
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,501 @@
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <cerrno>
+#include <ctime>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "shared_ring.hpp"
+
+namespace
+{
+using Word = std::atomic<uint32_t>;
+
+static_assert(sizeof(Word) == sizeof(uint32_t) and Word::is_always_lock_free,
+              "futexes need a plain 32 bit word");
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "the counters are shared between processes");
+
+/**
+ * @brief Identifies the memory as a channel, and its layout version
+ *
+ */
+constexpr uint64_t channel_magic = 0x31474e4952494355; // "UCIRING1"
+
+/**
+ * @brief The start of a channel's memory, followed by the two rings
+ *
+ */
+struct alignas(64) ChannelHeader
+{
+    uint64_t magic;
+    uint64_t capacity;
+
+    /**
+     * @brief The ids of the processes that created and opened the channel,
+     *        0 until they have
+     *
+     */
+    std::atomic<int32_t> creator;
+    std::atomic<int32_t> opener;
+};
+
+static_assert(sizeof(ChannelHeader) == 64, "the rings start on the next cache line");
+
+constexpr size_t minimum_capacity = 4096;
+
+/**
+ * @brief How many times to check before sleeping. Spinning only helps if the
+ *        other side can run at the same time.
+ *
+ */
+int spin_limit()
+{
+    static int const limit = std::thread::hardware_concurrency() > 1 ? 2000 : 0;
+    return limit;
+}
+
+/**
+ * @brief How long to sleep before checking that the other side is alive
+ *
+ */
+constexpr long peer_check_nanoseconds = 100000000;
+
+/**
+ * @brief Sleeps until `word` changes from `expected` or is woken
+ *
+ * @return false If it timed out after `peer_check_nanoseconds`
+ */
+bool futex_wait(Word &word, uint32_t expected)
+{
+    // Shared between processes, so not FUTEX_PRIVATE_FLAG
+    timespec timeout = {0, peer_check_nanoseconds};
+    long const result = syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT,
+                                expected, &timeout, nullptr, 0);
+    return result == 0 or errno != ETIMEDOUT;
+}
+
+void futex_wake(Word &word)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, INT_MAX, nullptr,
+            nullptr, 0);
+}
+
+/**
+ * @brief Blocks until `ready` returns true. `sleeping` tells the waking side
+ *        to bump `sequence` and wake it.
+ *
+ * @return false If `alive` returned false after a sleep timed out
+ */
+template <typename Ready, typename Alive>
+bool wait_until(Word &sequence, Word &sleeping, Ready ready, Alive alive)
+{
+    for (int i = spin_limit(); i > 0; i--)
+    {
+        if (ready())
+        {
+            return true;
+        }
+    }
+
+    // Announce the sleep before the last check. The waking side publishes
+    // before it checks `sleeping`, so one of the two sees the other.
+    sleeping.store(1);
+    bool woken = true;
+    while (true)
+    {
+        uint32_t const value = sequence.load(std::memory_order_acquire);
+        if (ready())
+        {
+            break;
+        }
+        if (not futex_wait(sequence, value) and not alive())
+        {
+            woken = false;
+            break;
+        }
+    }
+    sleeping.store(0, std::memory_order_relaxed);
+    return woken;
+}
+
+/**
+ * @brief Wakes the other side if it is asleep. Call after publishing.
+ *
+ */
+void wake(Word &sequence, Word &sleeping)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_relaxed) != 0)
+    {
+        sequence.fetch_add(1, std::memory_order_release);
+        futex_wake(sequence);
+    }
+}
+
+size_t round_up_capacity(size_t capacity)
+{
+    size_t rounded = minimum_capacity;
+    while (rounded < capacity)
+    {
+        rounded *= 2;
+    }
+    return rounded;
+}
+} // namespace
+
+/**
+ * @brief Each side's counter and futex words are on their own cache line, so
+ *        the two sides only share a line when one reads the other's counter
+ *
+ */
+struct chesspp::SharedRing::Header
+{
+    /**
+     * @brief Written by the writer: the number of bytes ever written, the
+     *        word the reader sleeps on and whether the writer is asleep
+     *
+     */
+    alignas(64) std::atomic<uint64_t> head;
+    Word data_sequence;
+    Word writer_sleeping;
+
+    /**
+     * @brief Written by the reader: the number of bytes ever read, the word
+     *        the writer sleeps on and whether the reader is asleep
+     *
+     */
+    alignas(64) std::atomic<uint64_t> tail;
+    Word space_sequence;
+    Word reader_sleeping;
+
+    alignas(64) Word closed;
+};
+
+chesspp::SharedRing::SharedRing(void *memory, size_t capacity, std::atomic<int32_t> const *peer)
+    : header(static_cast<Header *>(memory)),
+      data(static_cast<char *>(memory) + sizeof(Header)),
+      capacity(capacity),
+      peer(peer)
+{
+}
+
+bool chesspp::SharedRing::peer_alive() const
+{
+    int32_t const pid = peer == nullptr ? 0 : peer->load();
+    if (pid <= 0)
+    {
+        return true;
+    }
+
+    // A pidfd is readable once the process has exited, even before it is
+    // reaped, which kill(pid, 0) can't tell
+    int const pidfd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+    if (pidfd == -1)
+    {
+        if (errno == ESRCH)
+        {
+            return false;
+        }
+        return kill(pid, 0) == 0 or errno != ESRCH;
+    }
+    pollfd exited = {pidfd, POLLIN, 0};
+    bool const alive = poll(&exited, 1, 0) == 0;
+    ::close(pidfd);
+    return alive;
+}
+
+size_t chesspp::SharedRing::required_size(size_t capacity)
+{
+    return sizeof(Header) + capacity;
+}
+
+bool chesspp::SharedRing::write(std::string_view bytes)
+{
+    uint64_t head = header->head.load(std::memory_order_relaxed);
+    while (not bytes.empty())
+    {
+        if (header->closed.load(std::memory_order_acquire) != 0)
+        {
+            return false;
+        }
+
+        uint64_t const tail = header->tail.load(std::memory_order_acquire);
+        size_t const room = capacity - static_cast<size_t>(head - tail);
+        if (room == 0)
+        {
+            auto const ready = [this, tail]() {
+                return header->tail.load() != tail or header->closed.load() != 0;
+            };
+            if (not wait_until(header->space_sequence, header->writer_sleeping, ready,
+                               [this]() { return peer_alive(); }))
+            {
+                close();
+            }
+            continue;
+        }
+
+        size_t const count = std::min(room, bytes.size());
+        size_t const offset = static_cast<size_t>(head) & (capacity - 1);
+        size_t const first = std::min(count, capacity - offset);
+        std::memcpy(data + offset, bytes.data(), first);
+        std::memcpy(data, bytes.data() + first, count - first);
+        head += count;
+        header->head.store(head, std::memory_order_release);
+        bytes.remove_prefix(count);
+        wake(header->data_sequence, header->reader_sleeping);
+    }
+    return true;
+}
+
+size_t chesspp::SharedRing::read(char *bytes, size_t size)
+{
+    uint64_t const tail = header->tail.load(std::memory_order_relaxed);
+    while (true)
+    {
+        uint64_t const head = header->head.load(std::memory_order_acquire);
+        if (head != tail)
+        {
+            size_t const count = std::min(size, static_cast<size_t>(head - tail));
+            size_t const offset = static_cast<size_t>(tail) & (capacity - 1);
+            size_t const first = std::min(count, capacity - offset);
+            std::memcpy(bytes, data + offset, first);
+            std::memcpy(bytes + first, data, count - first);
+            header->tail.store(tail + count, std::memory_order_release);
+            wake(header->space_sequence, header->writer_sleeping);
+            return count;
+        }
+
+        // Check the head again after seeing the ring closed, in case the
+        // last bytes were written just before it was
+        if (header->closed.load(std::memory_order_acquire) != 0)
+        {
+            if (header->head.load(std::memory_order_acquire) == tail)
+            {
+                return 0;
+            }
+            continue;
+        }
+
+        auto const ready = [this, tail]() {
+            return header->head.load() != tail or header->closed.load() != 0;
+        };
+        if (not wait_until(header->data_sequence, header->reader_sleeping, ready,
+                           [this]() { return peer_alive(); }))
+        {
+            close();
+        }
+    }
+}
+
+void chesspp::SharedRing::close()
+{
+    if (header == nullptr)
+    {
+        return;
+    }
+    header->closed.store(1);
+    header->data_sequence.fetch_add(1);
+    header->space_sequence.fetch_add(1);
+    futex_wake(header->data_sequence);
+    futex_wake(header->space_sequence);
+}
+
+chesspp::SharedChannel::~SharedChannel()
+{
+    reset();
+}
+
+chesspp::SharedChannel::SharedChannel(SharedChannel &&other) noexcept
+    : memory(std::exchange(other.memory, nullptr)),
+      size(std::exchange(other.size, 0)),
+      fd(std::exchange(other.fd, -1)),
+      name(std::move(other.name)),
+      to_engine_ring(std::exchange(other.to_engine_ring, SharedRing())),
+      to_interface_ring(std::exchange(other.to_interface_ring, SharedRing()))
+{
+    other.name.clear();
+}
+
+chesspp::SharedChannel &chesspp::SharedChannel::operator=(SharedChannel &&other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        memory = std::exchange(other.memory, nullptr);
+        size = std::exchange(other.size, 0);
+        fd = std::exchange(other.fd, -1);
+        name = std::move(other.name);
+        other.name.clear();
+        to_engine_ring = std::exchange(other.to_engine_ring, SharedRing());
+        to_interface_ring = std::exchange(other.to_interface_ring, SharedRing());
+    }
+    return *this;
+}
+
+void chesspp::SharedChannel::reset()
+{
+    if (memory != nullptr)
+    {
+        to_engine_ring.close();
+        to_interface_ring.close();
+        munmap(memory, size);
+        memory = nullptr;
+        size = 0;
+    }
+    to_engine_ring = SharedRing();
+    to_interface_ring = SharedRing();
+    if (fd != -1)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+    if (not name.empty())
+    {
+        shm_unlink(name.c_str());
+        name.clear();
+    }
+}
+
+bool chesspp::SharedChannel::map(size_t capacity)
+{
+    bool const creating = capacity != 0;
+    if (creating)
+    {
+        size = sizeof(ChannelHeader) + 2 * SharedRing::required_size(capacity);
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        struct stat status;
+        if (fstat(fd, &status) != 0 or
+            static_cast<size_t>(status.st_size) < sizeof(ChannelHeader))
+        {
+            return false;
+        }
+        size = static_cast<size_t>(status.st_size);
+    }
+
+    void *const mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    memory = mapping;
+
+    // ftruncate zeroes the memory, which is an empty, open ring
+    ChannelHeader *const channel = static_cast<ChannelHeader *>(memory);
+    if (creating)
+    {
+        channel->magic = channel_magic;
+        channel->capacity = capacity;
+    }
+    else
+    {
+        capacity = static_cast<size_t>(channel->capacity);
+        if (channel->magic != channel_magic or capacity < minimum_capacity or
+            (capacity & (capacity - 1)) != 0 or
+            size != sizeof(ChannelHeader) + 2 * SharedRing::required_size(capacity))
+        {
+            // Not a channel, so don't touch it any further
+            munmap(memory, size);
+            memory = nullptr;
+            return false;
+        }
+    }
+
+    // Each side watches the other
+    std::atomic<int32_t> &self = creating ? channel->creator : channel->opener;
+    std::atomic<int32_t> const &peer = creating ? channel->opener : channel->creator;
+    self.store(static_cast<int32_t>(getpid()));
+
+    char *const rings = static_cast<char *>(memory) + sizeof(ChannelHeader);
+    to_engine_ring = SharedRing(rings, capacity, &peer);
+    to_interface_ring = SharedRing(rings + SharedRing::required_size(capacity), capacity, &peer);
+    return true;
+}
+
+bool chesspp::SharedChannel::create(size_t capacity)
+{
+    reset();
+    fd = memfd_create("chesspp-uci", 0);
+    if (fd == -1 or not map(round_up_capacity(capacity)))
+    {
+        reset();
+        return false;
+    }
+    return true;
+}
+
+bool chesspp::SharedChannel::create(std::string const &name, size_t capacity)
+{
+    reset();
+    fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd == -1)
+    {
+        return false;
+    }
+    this->name = name;
+    if (not map(round_up_capacity(capacity)))
+    {
+        reset();
+        return false;
+    }
+    return true;
+}
+
+bool chesspp::SharedChannel::open(std::string_view address)
+{
+    reset();
+    if (not address.empty() and address[0] == '/')
+    {
+        fd = shm_open(std::string(address).c_str(), O_RDWR | O_CLOEXEC, 0);
+    }
+    else
+    {
+        // An inherited descriptor, which this channel now owns
+        int number = -1;
+        auto const result = std::from_chars(address.data(), address.data() + address.size(), number);
+        if (result.ec == std::errc() and result.ptr == address.data() + address.size() and
+            number >= 0)
+        {
+            fd = number;
+        }
+    }
+
+    if (fd == -1 or not map(0))
+    {
+        // A descriptor that turned out not to be a channel belongs to
+        // someone else
+        if (not address.empty() and address[0] != '/')
+        {
+            fd = -1;
+        }
+        reset();
+        return false;
+    }
+    return true;
+}
+
+std::string chesspp::SharedChannel::get_address() const
+{
+    return name.empty() ? std::to_string(fd) : name;
+}
@@ -0,0 +1,226 @@
+/**
+ * @file shared_ring.hpp
+ * @brief Byte rings in shared memory for talking to a process on the same
+ *        host without pipes
+ *
+ */
+
+#ifndef SRC_UCI_IO_SHARED_RING_H
+#define SRC_UCI_IO_SHARED_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace chesspp
+{
+/**
+ * @brief One direction of a SharedChannel: a single producer, single consumer
+ *        ring of bytes in memory shared by two processes (or threads).
+ *
+ * The writer copies bytes in and publishes them by advancing a counter, and
+ * the reader copies them out and advances its own. Neither takes a lock or
+ * makes a system call while the ring is neither empty nor full. A side that
+ * has to wait spins briefly on machines with more than one CPU, then sleeps
+ * on a futex that the other side only wakes if it knows someone is asleep.
+ *
+ * A sleeping side wakes up every so often to check that the process on the
+ * other side is still alive, and treats the ring as closed if it is not, so
+ * a peer that is killed before it can close the ring looks like a closed
+ * pipe rather than leaving the other side asleep for ever.
+ *
+ * A SharedRing is a view of memory owned by a SharedChannel.
+ */
+class SharedRing
+{
+private:
+    /**
+     * @brief The counters and futex words at the start of the ring
+     *
+     */
+    struct Header;
+
+    Header *header = nullptr;
+    char *data = nullptr;
+
+    /**
+     * @brief The size of `data`, a power of 2
+     *
+     */
+    size_t capacity = 0;
+
+    /**
+     * @brief The id of the process on the other side, 0 while it is not
+     *        known. In the shared memory. `nullptr` to never check.
+     *
+     */
+    std::atomic<int32_t> const *peer = nullptr;
+
+    /**
+     * @brief Check whether the process on the other side is still running
+     *
+     */
+    bool peer_alive() const;
+
+public:
+    SharedRing() = default;
+
+    /**
+     * @param memory The header followed by `capacity` bytes
+     * @param peer The id of the process on the other side, or `nullptr` to
+     *        never check it
+     */
+    SharedRing(void *memory, size_t capacity, std::atomic<int32_t> const *peer = nullptr);
+
+    /**
+     * @brief Get the bytes needed for a ring that holds `capacity` bytes
+     *
+     */
+    static size_t required_size(size_t capacity);
+
+    /**
+     * @brief Writes all of `bytes`, blocking while the ring is full
+     *
+     * @return false If the ring was closed before everything was written
+     */
+    bool write(std::string_view bytes);
+
+    /**
+     * @brief Reads at least one byte, blocking while the ring is empty
+     *
+     * @return size_t The number of bytes read, 0 once the ring is closed and
+     *         everything written before that has been read
+     */
+    size_t read(char *bytes, size_t size);
+
+    /**
+     * @brief Closes the ring and wakes whoever is waiting on it. Either side
+     *        can close it. Bytes already written can still be read.
+     *
+     */
+    void close();
+};
+
+/**
+ * @brief A pair of SharedRings, one each way, in a memfd or POSIX shared
+ *        memory object.
+ *
+ * The interface creates the channel and passes its address to the engine on
+ * the command line (eg. `--uci-shm=5`). The address is the number of an
+ * inherited memfd descriptor, or the name of a POSIX shared memory object,
+ * which starts with '/'. The engine opens the address to map the same
+ * memory.
+ *
+ * Destroying a channel closes both rings, so the other side reads the end of
+ * the input once it has read everything that was written. The ids of the
+ * creating and opening processes are kept in the channel, so if either dies
+ * without closing the rings the other treats them as closed.
+ */
+class SharedChannel
+{
+private:
+    void *memory = nullptr;
+    size_t size = 0;
+
+    /**
+     * @brief The memfd or shared memory object, -1 if none
+     *
+     */
+    int fd = -1;
+
+    /**
+     * @brief The name of a POSIX shared memory object this channel created,
+     *        so it is unlinked when the channel is destroyed
+     *
+     */
+    std::string name;
+
+    SharedRing to_engine_ring;
+    SharedRing to_interface_ring;
+
+    /**
+     * @brief Maps `fd`, laying out the rings if `capacity` is not 0
+     *
+     */
+    bool map(size_t capacity);
+
+    void reset();
+
+public:
+    /**
+     * @brief The bytes each ring holds unless told otherwise
+     *
+     */
+    static constexpr size_t default_capacity = 1 << 20;
+
+    SharedChannel() = default;
+    ~SharedChannel();
+
+    SharedChannel(SharedChannel &&other) noexcept;
+    SharedChannel &operator=(SharedChannel &&other) noexcept;
+    SharedChannel(SharedChannel const &) = delete;
+    SharedChannel &operator=(SharedChannel const &) = delete;
+
+    /**
+     * @brief Creates a channel in an anonymous memfd. The descriptor is not
+     *        close-on-exec, so engines spawned afterwards inherit it.
+     *
+     * @param capacity The bytes each ring holds, rounded up to a power of 2
+     * @return false If the memory could not be created or mapped
+     */
+    bool create(size_t capacity = default_capacity);
+
+    /**
+     * @brief Creates a channel in a new POSIX shared memory object, which is
+     *        unlinked when the channel is destroyed
+     *
+     * @param name The name of the object, starting with '/'
+     * @param capacity The bytes each ring holds, rounded up to a power of 2
+     * @return false If the object exists or could not be created or mapped
+     */
+    bool create(std::string const &name, size_t capacity = default_capacity);
+
+    /**
+     * @brief Opens a channel created by another process
+     *
+     * @param address A descriptor number or a shared memory object name, as
+     *        returned by get_address()
+     * @return false If the address does not name a channel
+     */
+    bool open(std::string_view address);
+
+    bool is_open() const
+    {
+        return memory != nullptr;
+    }
+
+    /**
+     * @brief Get what to pass to the engine to open this channel
+     *
+     */
+    std::string get_address() const;
+
+    /**
+     * @brief Get the ring the interface writes and the engine reads
+     *
+     */
+    SharedRing &to_engine()
+    {
+        return to_engine_ring;
+    }
+
+    /**
+     * @brief Get the ring the engine writes and the interface reads
+     *
+     */
+    SharedRing &to_interface()
+    {
+        return to_interface_ring;
+    }
+};
+
+} // namespace chesspp
+
+#endif
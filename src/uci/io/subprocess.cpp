@@ -0,0 +1,131 @@
+#include <cerrno>
+#include <csignal>
+#include <utility>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "subprocess.hpp"
+
+extern char **environ;
+
+chesspp::Subprocess::~Subprocess()
+{
+    kill();
+}
+
+chesspp::Subprocess::Subprocess(Subprocess &&other) noexcept
+    : pid(std::exchange(other.pid, -1)),
+      input_fd(std::exchange(other.input_fd, -1)),
+      output_fd(std::exchange(other.output_fd, -1))
+{
+}
+
+chesspp::Subprocess &chesspp::Subprocess::operator=(Subprocess &&other) noexcept
+{
+    if (this != &other)
+    {
+        kill();
+        pid = std::exchange(other.pid, -1);
+        input_fd = std::exchange(other.input_fd, -1);
+        output_fd = std::exchange(other.output_fd, -1);
+    }
+    return *this;
+}
+
+bool chesspp::Subprocess::spawn(std::string const &command)
+{
+    if (pid != -1)
+    {
+        return false;
+    }
+
+    // [0] is the read end, [1] the write end. Close-on-exec keeps the
+    // parent's ends out of this and any other child.
+    int to_child[2];
+    int from_child[2];
+    if (pipe2(to_child, O_CLOEXEC) != 0)
+    {
+        return false;
+    }
+    if (pipe2(from_child, O_CLOEXEC) != 0)
+    {
+        close(to_child[0]);
+        close(to_child[1]);
+        return false;
+    }
+
+    // dup2 clears close-on-exec on the copies the child keeps
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, to_child[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, from_child[1], STDOUT_FILENO);
+
+    char shell[] = "/bin/sh";
+    char flag[] = "-c";
+    std::string command_copy = command;
+    char *const argv[] = {shell, flag, command_copy.data(), nullptr};
+    int const result = posix_spawn(&pid, shell, &actions, nullptr, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+
+    close(to_child[0]);
+    close(from_child[1]);
+    if (result != 0)
+    {
+        pid = -1;
+        close(to_child[1]);
+        close(from_child[0]);
+        return false;
+    }
+
+    input_fd = to_child[1];
+    output_fd = from_child[0];
+    return true;
+}
+
+void chesspp::Subprocess::close_input()
+{
+    if (input_fd != -1)
+    {
+        close(input_fd);
+        input_fd = -1;
+    }
+}
+
+int chesspp::Subprocess::wait()
+{
+    // Before waiting, or a child blocked on a full pipe would never exit
+    close_input();
+    if (output_fd != -1)
+    {
+        close(output_fd);
+        output_fd = -1;
+    }
+    if (pid == -1)
+    {
+        return -1;
+    }
+
+    int status = -1;
+    while (waitpid(pid, &status, 0) == -1 and errno == EINTR)
+    {
+    }
+    pid = -1;
+    return status;
+}
+
+void chesspp::Subprocess::terminate()
+{
+    if (pid != -1)
+    {
+        ::kill(pid, SIGKILL);
+    }
+}
+
+void chesspp::Subprocess::kill()
+{
+    terminate();
+    wait();
+}
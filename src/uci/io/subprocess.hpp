@@ -0,0 +1,121 @@
+/**
+ * @file subprocess.hpp
+ * @brief Runs a local program with pipes for its standard input and output
+ *
+ */
+
+#ifndef SRC_UCI_IO_SUBPROCESS_H
+#define SRC_UCI_IO_SUBPROCESS_H
+
+#include <string>
+
+#include <sys/types.h>
+
+namespace chesspp
+{
+/**
+ * @brief A child process whose standard input and output are pipes to this
+ *        process, eg. a UCI engine. Standard error is inherited.
+ *
+ * The process is run through `/bin/sh -c`, so the command may contain
+ * arguments and redirections. Both pipe ends held here are close-on-exec.
+ * Destroying a Subprocess closes its pipes and kills and reaps the process if
+ * it is still running.
+ */
+class Subprocess
+{
+private:
+    pid_t pid = -1;
+
+    /**
+     * @brief Writes to the child's standard input
+     *
+     */
+    int input_fd = -1;
+
+    /**
+     * @brief Reads from the child's standard output
+     *
+     */
+    int output_fd = -1;
+
+public:
+    Subprocess() = default;
+    ~Subprocess();
+
+    Subprocess(Subprocess &&other) noexcept;
+    Subprocess &operator=(Subprocess &&other) noexcept;
+    Subprocess(Subprocess const &) = delete;
+    Subprocess &operator=(Subprocess const &) = delete;
+
+    /**
+     * @brief Starts the process. A Subprocess can only be spawned once.
+     *
+     * @param command The shell command to run
+     * @return true If the process was started
+     * @return false If the pipes or the process could not be created
+     */
+    bool spawn(std::string const &command);
+
+    /**
+     * @brief Get the descriptor that writes to the child's standard input
+     *
+     */
+    int input() const
+    {
+        return input_fd;
+    }
+
+    /**
+     * @brief Get the descriptor that reads from the child's standard output
+     *
+     */
+    int output() const
+    {
+        return output_fd;
+    }
+
+    /**
+     * @brief Get the process id, -1 if not running
+     *
+     */
+    pid_t get_pid() const
+    {
+        return pid;
+    }
+
+    /**
+     * @brief Closes the child's standard input, so it reads end of file
+     *
+     */
+    void close_input();
+
+    /**
+     * @brief Closes both pipes, then waits for the process to exit and
+     *        reaps it. Read everything needed from output() first, and do not
+     *        call this while another thread is still reading from it. A
+     *        process still writing gets SIGPIPE rather than blocking forever.
+     *
+     * @return int The exit status as returned by waitpid, or -1 if the
+     *         process is not running
+     */
+    int wait();
+
+    /**
+     * @brief Sends the process SIGKILL without closing the pipes or reaping
+     *        it, so a thread reading from output() sees end of file. Call
+     *        wait() once it has finished.
+     *
+     */
+    void terminate();
+
+    /**
+     * @brief Kills the process with SIGKILL and reaps it
+     *
+     */
+    void kill();
+};
+
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,50 @@
+#include <utility>
+
+#include <unistd.h>
+
+#include "transport.hpp"
+
+chesspp::StdioTransport::StdioTransport() : source(STDIN_FILENO)
+{
+}
+
+chesspp::SharedMemoryTransport::SharedMemoryTransport(SharedChannel channel, TransportSide side)
+    : channel(std::move(channel)),
+      source(side == TransportSide::engine ? this->channel.to_engine()
+                                           : this->channel.to_interface()),
+      sink(side == TransportSide::engine ? this->channel.to_interface()
+                                         : this->channel.to_engine()),
+      writer(sink)
+{
+}
+
+std::unique_ptr<chesspp::Transport> chesspp::open_transport(int argc, char const *const *argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view const argument = argv[i];
+        std::string_view address;
+        if (argument == shared_memory_option and i + 1 < argc)
+        {
+            address = argv[i + 1];
+        }
+        else if (argument.size() > shared_memory_option.size() and
+                 argument.substr(0, shared_memory_option.size()) == shared_memory_option and
+                 argument[shared_memory_option.size()] == '=')
+        {
+            address = argument.substr(shared_memory_option.size() + 1);
+        }
+        else if (argument != shared_memory_option)
+        {
+            continue;
+        }
+
+        SharedChannel channel;
+        if (not channel.open(address))
+        {
+            return nullptr;
+        }
+        return std::make_unique<SharedMemoryTransport>(std::move(channel), TransportSide::engine);
+    }
+    return std::make_unique<StdioTransport>();
+}
@@ -0,0 +1,160 @@
+/**
+ * @file transport.hpp
+ * @brief How UCI lines travel between the interface and the engine
+ *
+ */
+
+#ifndef SRC_UCI_IO_TRANSPORT_H
+#define SRC_UCI_IO_TRANSPORT_H
+
+#include <memory>
+#include <string_view>
+
+#include "line_reader.hpp"
+#include "output_writer.hpp"
+#include "shared_ring.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief Reads from a SharedRing
+ *
+ */
+class RingSource : public InputSource
+{
+private:
+    SharedRing &ring;
+
+public:
+    explicit RingSource(SharedRing &ring) : ring(ring)
+    {
+    }
+
+    size_t read(char *data, size_t size) override
+    {
+        return ring.read(data, size);
+    }
+};
+
+/**
+ * @brief Writes to a SharedRing. Anything written after the other side has
+ *        closed the ring is dropped, like a write to a closed pipe.
+ *
+ */
+class RingSink : public OutputSink
+{
+private:
+    SharedRing &ring;
+
+public:
+    explicit RingSink(SharedRing &ring) : ring(ring)
+    {
+    }
+
+    void write(std::string_view data) override
+    {
+        ring.write(data);
+    }
+};
+
+/**
+ * @brief A way for UCI lines to reach the other side: where lines are read
+ *        from, and the writer that sends them
+ *
+ */
+class Transport
+{
+public:
+    virtual ~Transport() = default;
+
+    virtual InputSource &input() = 0;
+    virtual OutputWriter &output() = 0;
+};
+
+/**
+ * @brief Standard input and output, which is how GUIs run engines
+ *
+ */
+class StdioTransport : public Transport
+{
+private:
+    FdSource source;
+
+public:
+    StdioTransport();
+
+    InputSource &input() override
+    {
+        return source;
+    }
+
+    OutputWriter &output() override
+    {
+        return OutputWriter::standard();
+    }
+};
+
+/**
+ * @brief Which end of a SharedChannel a SharedMemoryTransport is
+ *
+ */
+enum class TransportSide
+{
+    engine,
+    interface
+};
+
+/**
+ * @brief A SharedChannel, for an interface and an engine on the same host.
+ *        The lines are the same as over pipes, but they are copied through
+ *        shared memory and a side only makes a system call to wake the other
+ *        one up.
+ *
+ */
+class SharedMemoryTransport : public Transport
+{
+private:
+    SharedChannel channel;
+    RingSource source;
+    RingSink sink;
+    OutputWriter writer;
+
+public:
+    /**
+     * @param channel An open channel
+     * @param side Which end this is. The engine reads the ring the interface
+     *        writes, and the other way round.
+     */
+    SharedMemoryTransport(SharedChannel channel, TransportSide side);
+
+    InputSource &input() override
+    {
+        return source;
+    }
+
+    OutputWriter &output() override
+    {
+        return writer;
+    }
+};
+
+/**
+ * @brief The command line option that gives an engine a SharedChannel address
+ *
+ */
+inline constexpr std::string_view shared_memory_option = "--uci-shm";
+
+/**
+ * @brief Picks the engine's transport from its command line. With
+ *        `--uci-shm=<address>` or `--uci-shm <address>` it opens that
+ *        SharedChannel, otherwise it uses standard input and output.
+ *
+ * @return std::unique_ptr<Transport> The transport, or `nullptr` if an
+ *         address was given but could not be opened. Falling back to
+ *         standard input would leave the interface waiting forever.
+ */
+std::unique_ptr<Transport> open_transport(int argc, char const *const *argv);
+
+} // namespace chesspp
+
+#endif
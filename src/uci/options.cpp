@@ -0,0 +1,330 @@
+#include <algorithm>
+#include <charconv>
+#include <utility>
+
+#include "options.hpp"
+
+namespace
+{
+char lower(char character)
+{
+    return character >= 'A' and character <= 'Z' ? static_cast<char>(character - 'A' + 'a')
+                                                  : character;
+}
+
+bool equal_ignoring_case(std::string_view first, std::string_view second)
+{
+    if (first.size() != second.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < first.size(); i++)
+    {
+        if (lower(first[i]) != lower(second[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Removes and returns the first space separated word of `text`
+ *
+ */
+std::string_view next_word(std::string_view &text)
+{
+    size_t const start = text.find_first_not_of(" \t");
+    if (start == std::string_view::npos)
+    {
+        text = {};
+        return {};
+    }
+    text.remove_prefix(start);
+    size_t const end = std::min(text.find_first_of(" \t"), text.size());
+    std::string_view const word = text.substr(0, end);
+    text.remove_prefix(end);
+    return word;
+}
+
+/**
+ * @brief Checks whether the words of a name match a list of tokens
+ *
+ */
+bool name_matches(std::string_view name, chesspp::TokenSpan tokens)
+{
+    for (std::string_view const token : tokens)
+    {
+        if (not equal_ignoring_case(next_word(name), token))
+        {
+            return false;
+        }
+    }
+    return next_word(name).empty();
+}
+
+/**
+ * @brief How the specification writes an empty string value
+ *
+ */
+constexpr std::string_view empty_string = "<empty>";
+} // namespace
+
+void chesspp::CheckOption::announce(OutputWriter::Line &line) const
+{
+    line.append(" type check default ");
+    line.append(default_value ? "true" : "false");
+}
+
+bool chesspp::CheckOption::set(TokenSpan tokens)
+{
+    if (tokens.size() != 1)
+    {
+        return false;
+    }
+    if (equal_ignoring_case(tokens[0], "true"))
+    {
+        value.store(true, std::memory_order_relaxed);
+        return true;
+    }
+    if (equal_ignoring_case(tokens[0], "false"))
+    {
+        value.store(false, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void chesspp::SpinOption::announce(OutputWriter::Line &line) const
+{
+    line.append(" type spin default ");
+    line.append_integer(default_value);
+    line.append(" min ");
+    line.append_integer(min);
+    line.append(" max ");
+    line.append_integer(max);
+}
+
+bool chesspp::SpinOption::set(TokenSpan tokens)
+{
+    if (tokens.size() != 1)
+    {
+        return false;
+    }
+    std::string_view const text = tokens[0];
+    int64_t number = 0;
+    std::from_chars_result const result = std::from_chars(text.data(), text.data() + text.size(), number);
+    if (result.ec != std::errc() or result.ptr != text.data() + text.size() or number < min or
+        number > max)
+    {
+        return false;
+    }
+    value.store(number, std::memory_order_relaxed);
+    return true;
+}
+
+void chesspp::ComboOption::announce(OutputWriter::Line &line) const
+{
+    line.append(" type combo default ");
+    line.append(choices[default_index]);
+    for (std::string const &choice : choices)
+    {
+        line.append(" var ");
+        line.append(choice);
+    }
+}
+
+bool chesspp::ComboOption::set(TokenSpan tokens)
+{
+    // Choices are single words in practice, but match them like names
+    for (size_t i = 0; i < choices.size(); i++)
+    {
+        if (not tokens.empty() and name_matches(choices[i], tokens))
+        {
+            index.store(i, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void chesspp::ButtonOption::announce(OutputWriter::Line &line) const
+{
+    line.append(" type button");
+}
+
+bool chesspp::ButtonOption::set(TokenSpan tokens)
+{
+    return tokens.empty();
+}
+
+chesspp::StringOption::StringOption(
+    std::string name, std::string default_value, InplaceFunction<void()> on_change)
+    : Option(std::move(name), OptionType::string, std::move(on_change)),
+      default_value(std::move(default_value))
+{
+    values.push_back(std::make_unique<std::string const>(this->default_value));
+    value.store(values.back().get(), std::memory_order_release);
+}
+
+void chesspp::StringOption::announce(OutputWriter::Line &line) const
+{
+    line.append(" type string default ");
+    line.append(default_value.empty() ? empty_string : std::string_view(default_value));
+}
+
+bool chesspp::StringOption::set(TokenSpan tokens)
+{
+    // The tokens are views of one line, so the text between the first and
+    // the last is the value with its inner spacing intact
+    std::string_view text;
+    if (not tokens.empty())
+    {
+        std::string_view const first = tokens[0];
+        std::string_view const last = tokens[tokens.size() - 1];
+        text = std::string_view(first.data(), last.data() + last.size() - first.data());
+    }
+    if (text == empty_string)
+    {
+        text = {};
+    }
+    if (text == get())
+    {
+        return true;
+    }
+
+    values.push_back(std::make_unique<std::string const>(text));
+    value.store(values.back().get(), std::memory_order_release);
+    return true;
+}
+
+template <typename Type>
+Type *chesspp::OptionRegistry::add(std::unique_ptr<Type> option)
+{
+    if (find(option->get_name()) != nullptr)
+    {
+        return nullptr;
+    }
+    Type *const added = option.get();
+    options.push_back(std::move(option));
+    return added;
+}
+
+chesspp::CheckOption *chesspp::OptionRegistry::add_check(
+    std::string name, bool default_value, InplaceFunction<void()> on_change)
+{
+    return add(std::make_unique<CheckOption>(std::move(name), default_value, std::move(on_change)));
+}
+
+chesspp::SpinOption *chesspp::OptionRegistry::add_spin(
+    std::string name, int64_t default_value, int64_t min, int64_t max,
+    InplaceFunction<void()> on_change)
+{
+    if (default_value < min or default_value > max)
+    {
+        return nullptr;
+    }
+    return add(std::make_unique<SpinOption>(
+        std::move(name), default_value, min, max, std::move(on_change)));
+}
+
+chesspp::ComboOption *chesspp::OptionRegistry::add_combo(
+    std::string name, std::string_view default_value, std::vector<std::string> choices,
+    InplaceFunction<void()> on_change)
+{
+    for (size_t i = 0; i < choices.size(); i++)
+    {
+        if (choices[i] == default_value)
+        {
+            return add(std::make_unique<ComboOption>(
+                std::move(name), std::move(choices), i, std::move(on_change)));
+        }
+    }
+    return nullptr;
+}
+
+chesspp::ButtonOption *chesspp::OptionRegistry::add_button(
+    std::string name, InplaceFunction<void()> on_press)
+{
+    return add(std::make_unique<ButtonOption>(std::move(name), std::move(on_press)));
+}
+
+chesspp::StringOption *chesspp::OptionRegistry::add_string(
+    std::string name, std::string default_value, InplaceFunction<void()> on_change)
+{
+    return add(std::make_unique<StringOption>(
+        std::move(name), std::move(default_value), std::move(on_change)));
+}
+
+chesspp::Option *chesspp::OptionRegistry::find(TokenSpan name) const
+{
+    if (name.empty())
+    {
+        return nullptr;
+    }
+    for (std::unique_ptr<Option> const &option : options)
+    {
+        if (name_matches(option->get_name(), name))
+        {
+            return option.get();
+        }
+    }
+    return nullptr;
+}
+
+chesspp::Option *chesspp::OptionRegistry::find(std::string_view name) const
+{
+    // Split the name into words on the stack. Names are a few words long.
+    constexpr size_t max_words = 16;
+    std::string_view words[max_words];
+    size_t count = 0;
+    for (std::string_view word = next_word(name); not word.empty(); word = next_word(name))
+    {
+        if (count == max_words)
+        {
+            return nullptr;
+        }
+        words[count++] = word;
+    }
+    return find(TokenSpan(words, count));
+}
+
+bool chesspp::OptionRegistry::set(ArgumentSpan arguments)
+{
+    TokenSpan name;
+    TokenSpan value;
+    for (ArgumentView const &argument : arguments)
+    {
+        if (argument.value == "name")
+        {
+            name = argument.parameters;
+        }
+        else if (argument.value == "value")
+        {
+            value = argument.parameters;
+        }
+    }
+
+    Option *const option = find(name);
+    if (option == nullptr or not option->set(value))
+    {
+        return false;
+    }
+    if (option->on_change)
+    {
+        option->on_change();
+    }
+    return true;
+}
+
+void chesspp::OptionRegistry::announce(OutputWriter &output) const
+{
+    for (std::unique_ptr<Option> const &option : options)
+    {
+        OutputWriter::Line line = output.begin_line("option");
+        line.append(" name ");
+        line.append(option->get_name());
+        option->announce(line);
+        line.finish();
+    }
+}
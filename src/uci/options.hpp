@@ -0,0 +1,390 @@
+/**
+ * @file options.hpp
+ * @brief The engine's settings, announced with `option` and changed with
+ *        `setoption`
+ *
+ */
+
+#ifndef SRC_UCI_OPTIONS_H
+#define SRC_UCI_OPTIONS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chesspp/argument.hpp"
+#include "chesspp/inplace_function.hpp"
+#include "io/output_writer.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief The types of option in the UCI specification
+ *
+ */
+enum class OptionType
+{
+    check,
+    spin,
+    combo,
+    button,
+    string
+};
+
+/**
+ * @brief An engine setting. Values are published atomically, so any thread
+ *        (eg. a search thread) can read them at any time without a lock,
+ *        while `setoption` changes them on the engine thread.
+ *
+ */
+class Option
+{
+private:
+    std::string name;
+    OptionType type;
+
+    /**
+     * @brief Run on the engine thread after the value changes
+     *
+     */
+    InplaceFunction<void()> on_change;
+
+protected:
+    Option(std::string name, OptionType type, InplaceFunction<void()> on_change)
+        : name(std::move(name)), type(type), on_change(std::move(on_change))
+    {
+    }
+
+    /**
+     * @brief Appends the type and its details to an `option` line
+     *
+     */
+    virtual void announce(OutputWriter::Line &line) const = 0;
+
+    /**
+     * @brief Checks and publishes the value of a `setoption`
+     *
+     * @param value The tokens after `value`, empty if there were none. Views
+     *        of one line, in order (see OptionRegistry::set()).
+     * @return false If the value is not valid for the option
+     */
+    virtual bool set(TokenSpan value) = 0;
+
+    friend class OptionRegistry;
+
+public:
+    virtual ~Option() = default;
+
+    Option(Option const &) = delete;
+    Option &operator=(Option const &) = delete;
+
+    std::string_view get_name() const
+    {
+        return name;
+    }
+
+    OptionType get_type() const
+    {
+        return type;
+    }
+};
+
+/**
+ * @brief A true or false option
+ *
+ */
+class CheckOption : public Option
+{
+private:
+    bool default_value;
+    std::atomic<bool> value;
+
+protected:
+    void announce(OutputWriter::Line &line) const override;
+    bool set(TokenSpan value) override;
+
+public:
+    CheckOption(std::string name, bool default_value, InplaceFunction<void()> on_change = {})
+        : Option(std::move(name), OptionType::check, std::move(on_change)),
+          default_value(default_value),
+          value(default_value)
+    {
+    }
+
+    bool get() const
+    {
+        return value.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief A whole number between a minimum and a maximum. Values outside of
+ *        the range are refused.
+ *
+ */
+class SpinOption : public Option
+{
+private:
+    int64_t default_value;
+    int64_t min;
+    int64_t max;
+    std::atomic<int64_t> value;
+
+protected:
+    void announce(OutputWriter::Line &line) const override;
+    bool set(TokenSpan value) override;
+
+public:
+    SpinOption(
+        std::string name, int64_t default_value, int64_t min, int64_t max,
+        InplaceFunction<void()> on_change = {})
+        : Option(std::move(name), OptionType::spin, std::move(on_change)),
+          default_value(default_value),
+          min(min),
+          max(max),
+          value(default_value)
+    {
+    }
+
+    int64_t get() const
+    {
+        return value.load(std::memory_order_relaxed);
+    }
+
+    int64_t get_min() const
+    {
+        return min;
+    }
+
+    int64_t get_max() const
+    {
+        return max;
+    }
+};
+
+/**
+ * @brief One of a fixed list of words. The value is published as its index
+ *        in the list.
+ *
+ */
+class ComboOption : public Option
+{
+private:
+    std::vector<std::string> choices;
+    size_t default_index;
+    std::atomic<size_t> index;
+
+protected:
+    void announce(OutputWriter::Line &line) const override;
+    bool set(TokenSpan value) override;
+
+public:
+    /**
+     * @param default_index The index of the default in `choices`
+     */
+    ComboOption(
+        std::string name, std::vector<std::string> choices, size_t default_index,
+        InplaceFunction<void()> on_change = {})
+        : Option(std::move(name), OptionType::combo, std::move(on_change)),
+          choices(std::move(choices)),
+          default_index(default_index),
+          index(default_index)
+    {
+    }
+
+    /**
+     * @brief Get the index of the value in the list of choices
+     *
+     */
+    size_t get_index() const
+    {
+        return index.load(std::memory_order_relaxed);
+    }
+
+    std::string_view get() const
+    {
+        return choices[get_index()];
+    }
+};
+
+/**
+ * @brief An action with no value, eg. "Clear Hash". `setoption` runs its
+ *        callback.
+ *
+ */
+class ButtonOption : public Option
+{
+protected:
+    void announce(OutputWriter::Line &line) const override;
+    bool set(TokenSpan value) override;
+
+public:
+    ButtonOption(std::string name, InplaceFunction<void()> on_press)
+        : Option(std::move(name), OptionType::button, std::move(on_press))
+    {
+    }
+};
+
+/**
+ * @brief Any text, eg. a path. Each value is a separate immutable string
+ *        that is published by swapping a pointer, read-copy-update style. A
+ *        value stays valid until the option is destroyed, so a reader never
+ *        has to wait or copy.
+ *
+ */
+class StringOption : public Option
+{
+private:
+    std::string default_value;
+
+    /**
+     * @brief Every value the option has had. Only changed on the engine
+     *        thread. Interfaces set options a handful of times, so keeping
+     *        them is cheaper than working out when readers are done.
+     *
+     */
+    std::vector<std::unique_ptr<std::string const>> values;
+
+    std::atomic<std::string const *> value;
+
+protected:
+    void announce(OutputWriter::Line &line) const override;
+    bool set(TokenSpan value) override;
+
+public:
+    StringOption(
+        std::string name, std::string default_value, InplaceFunction<void()> on_change = {});
+
+    /**
+     * @brief Get the current value. It stays valid for as long as the option
+     *        does.
+     *
+     */
+    std::string_view get() const
+    {
+        return *value.load(std::memory_order_acquire);
+    }
+};
+
+/**
+ * @brief The options an engine supports, declared once with their types,
+ *        defaults and ranges.
+ *
+ * The engine writes an `option` line for each of them in reply to `uci`, and
+ * handles `setoption` by finding the option by name (case insensitively, as
+ * the specification asks, and with names of several words matched token by
+ * token) and checking and converting the value. Only a new value for a
+ * string option allocates.
+ *
+ * Options must be added before the engine starts. They are never removed, so
+ * the pointers returned by the add functions stay valid for as long as the
+ * registry.
+ */
+class OptionRegistry
+{
+private:
+    std::vector<std::unique_ptr<Option>> options;
+
+    /**
+     * @brief Takes ownership of an option unless one by the same name exists
+     *
+     */
+    template <typename Type>
+    Type *add(std::unique_ptr<Type> option);
+
+public:
+    /**
+     * @brief Adds a check option
+     *
+     * @return CheckOption* The option, or `nullptr` if there already is one
+     *         by that name
+     */
+    CheckOption *add_check(
+        std::string name, bool default_value, InplaceFunction<void()> on_change = {});
+
+    /**
+     * @brief Adds a spin option
+     *
+     * @return SpinOption* The option, or `nullptr` if there already is one by
+     *         that name or `default_value` is not between `min` and `max`
+     */
+    SpinOption *add_spin(
+        std::string name, int64_t default_value, int64_t min, int64_t max,
+        InplaceFunction<void()> on_change = {});
+
+    /**
+     * @brief Adds a combo option
+     *
+     * @return ComboOption* The option, or `nullptr` if there already is one
+     *         by that name or `default_value` is not one of `choices`
+     */
+    ComboOption *add_combo(
+        std::string name, std::string_view default_value, std::vector<std::string> choices,
+        InplaceFunction<void()> on_change = {});
+
+    /**
+     * @brief Adds a button option
+     *
+     * @return ButtonOption* The option, or `nullptr` if there already is one
+     *         by that name
+     */
+    ButtonOption *add_button(std::string name, InplaceFunction<void()> on_press);
+
+    /**
+     * @brief Adds a string option
+     *
+     * @return StringOption* The option, or `nullptr` if there already is one
+     *         by that name
+     */
+    StringOption *add_string(
+        std::string name, std::string default_value, InplaceFunction<void()> on_change = {});
+
+    /**
+     * @brief Find an option by its name, ignoring case
+     *
+     * @param name The tokens of the name, eg. {"Clear", "Hash"}
+     * @return Option* The option, or `nullptr` if there is none by that name
+     */
+    Option *find(TokenSpan name) const;
+
+    /**
+     * @brief Find an option by its name, ignoring case and extra whitespace
+     *
+     */
+    Option *find(std::string_view name) const;
+
+    /**
+     * @brief Handles the arguments of a `setoption`, running the option's
+     *        callback if its value was set
+     *
+     * The parameters of `value` must be views of one line, in order, as
+     * they are when parsed by the engine: a string option's value is taken
+     * from the start of the first to the end of the last, so the spacing
+     * inside it is kept. Tokens from separate strings would take in
+     * unrelated memory.
+     *
+     * @return false If there is no such option or the value is not valid
+     *         for it
+     */
+    bool set(ArgumentSpan arguments);
+
+    /**
+     * @brief Writes an `option` line for every option, in the order they
+     *        were added
+     *
+     */
+    void announce(OutputWriter &output) const;
+
+    size_t size() const
+    {
+        return options.size();
+    }
+};
+
+} // namespace chesspp
+
+#endif
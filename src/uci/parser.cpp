@@ -1,32 +1,253 @@
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+#define CHESSPP_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
 #include "parser.hpp"
 
-std::vector<std::string> chesspp::Parser::tokenise(std::string const &input)
+namespace
+{
+/**
+ * @brief The number of bytes the tokeniser classifies at a time.
+ *
+ */
+constexpr size_t block_size = 32;
+
+/**
+ * @brief Checks whether a character is whitespace in the "C" locale, which is
+ *        what UCI means by whitespace. Unlike `isspace` this does not look up
+ *        the current locale.
+ *
+ */
+inline bool is_whitespace(char const letter)
 {
+    return letter == ' ' or
+           static_cast<unsigned char>(letter - '\t') <= '\r' - '\t';
+}
+
+#ifdef CHESSPP_X86_SIMD
+/**
+ * @brief Classifies 16 characters at a time using SSE2
+ *
+ */
+struct Sse2Mask
+{
+    __attribute__((target("sse2"))) static uint32_t whitespace16(char const *block)
+    {
+        __m128i const letters = _mm_loadu_si128(reinterpret_cast<__m128i const *>(block));
+
+        // ' ' or any of '\t', '\n', '\v', '\f', '\r' (which are 9 to 13)
+        __m128i const spaces = _mm_cmpeq_epi8(letters, _mm_set1_epi8(' '));
+        __m128i const offset = _mm_sub_epi8(letters, _mm_set1_epi8('\t'));
+        __m128i const controls = _mm_cmpeq_epi8(
+            _mm_min_epu8(offset, _mm_set1_epi8('\r' - '\t')), offset);
 
-    std::vector<std::string> result;
-    std::string token = "";
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(spaces, controls)));
+    }
 
-    for (size_t i = 0; i < input.length(); i++)
+    __attribute__((target("sse2"))) static uint32_t whitespace(char const *block)
+    {
+        return whitespace16(block) | (whitespace16(block + 16) << 16);
+    }
+};
+
+/**
+ * @brief Classifies 32 characters at a time using AVX2
+ *
+ */
+struct Avx2Mask
+{
+    __attribute__((target("avx2"))) static uint32_t whitespace(char const *block)
     {
-        char const letter = input[i];
-        if (isspace(letter) and token.length() > 0)
+        __m256i const letters = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(block));
+
+        __m256i const spaces = _mm256_cmpeq_epi8(letters, _mm256_set1_epi8(' '));
+        __m256i const offset = _mm256_sub_epi8(letters, _mm256_set1_epi8('\t'));
+        __m256i const controls = _mm256_cmpeq_epi8(
+            _mm256_min_epu8(offset, _mm256_set1_epi8('\r' - '\t')), offset);
+
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(spaces, controls)));
+    }
+};
+#endif
+
+/**
+ * @brief Splits `input` into tokens a block at a time. `Mask` turns a block of
+ *        characters into a bitmask with a bit set for every whitespace
+ *        character, and token boundaries are then found with bit tricks on
+ *        that mask rather than by branching on each character.
+ *
+ */
+template <typename Mask>
+inline __attribute__((always_inline)) void tokenise_blocks(
+    std::string_view input, std::vector<std::string_view> &tokens)
+{
+    // Whether the character before the current block was whitespace. The
+    // start of the input counts as whitespace.
+    uint32_t previous_whitespace = 1;
+    size_t token_start = 0;
+
+    for (size_t offset = 0; offset < input.length(); offset += block_size)
+    {
+        uint32_t whitespace;
+        if (input.length() - offset >= block_size)
         {
-            result.push_back(token);
-            token = "";
+            whitespace = Mask::whitespace(input.data() + offset);
         }
-        else if (not isspace(letter))
+        else
         {
-            token.push_back(letter);
+            // Pad the last partial block with spaces so that we never read
+            // past the end of the input.
+            char block[block_size];
+            std::memset(block, ' ', block_size);
+            std::memcpy(block, input.data() + offset, input.length() - offset);
+            whitespace = Mask::whitespace(block);
+        }
 
-            // Save to result if last iteration
-            if (i == input.length() - 1)
+        // A token starts at a non whitespace character that follows whitespace
+        // and ends at a whitespace character that follows a non whitespace one.
+        uint32_t const shifted = (whitespace << 1) | previous_whitespace;
+        uint32_t const starts = ~whitespace & shifted;
+        uint32_t boundaries = starts | (whitespace & ~shifted);
+        previous_whitespace = whitespace >> (block_size - 1);
+
+        while (boundaries != 0)
+        {
+            uint32_t const bit = boundaries & (0 - boundaries);
+            size_t const position = offset + __builtin_ctz(boundaries);
+            if (starts & bit)
             {
-                result.push_back(token);
-                token = "";
+                token_start = position;
             }
+            else
+            {
+                tokens.push_back(input.substr(token_start, position - token_start));
+            }
+            boundaries ^= bit;
         }
     }
-    return result;
+
+    // The last token runs until the end of the input if there was no trailing
+    // whitespace (or padding) to end it.
+    if (previous_whitespace == 0)
+    {
+        tokens.push_back(input.substr(token_start));
+    }
+}
+
+void tokenise_scalar(std::string_view input, std::vector<std::string_view> &tokens)
+{
+    size_t i = 0;
+    while (i < input.length())
+    {
+        // Skip any whitespace before the token
+        while (i < input.length() and is_whitespace(input[i]))
+        {
+            i++;
+        }
+
+        // Find the end of the token
+        size_t const start = i;
+        while (i < input.length() and not is_whitespace(input[i]))
+        {
+            i++;
+        }
+
+        if (i > start)
+        {
+            tokens.push_back(input.substr(start, i - start));
+        }
+    }
+}
+
+#ifdef CHESSPP_X86_SIMD
+__attribute__((target("sse2"))) void tokenise_sse2(
+    std::string_view input, std::vector<std::string_view> &tokens)
+{
+    tokenise_blocks<Sse2Mask>(input, tokens);
+}
+
+__attribute__((target("avx2"))) void tokenise_avx2(
+    std::string_view input, std::vector<std::string_view> &tokens)
+{
+    tokenise_blocks<Avx2Mask>(input, tokens);
+}
+#endif
+
+} // namespace
+
+std::vector<std::string> chesspp::Parser::tokenise(std::string const &input)
+{
+    std::vector<std::string_view> tokens;
+    tokenise(input, tokens);
+
+    // Copy the tokens out of the input so that the result owns its strings.
+    return std::vector<std::string>(tokens.begin(), tokens.end());
+}
+
+std::vector<std::string_view> &chesspp::Parser::tokenise(
+    std::string_view input, std::vector<std::string_view> &tokens)
+{
+    // Detect the fastest path the CPU supports once, on first use.
+    static TokeniserPath const path = fastest_tokeniser_path();
+    return tokenise(input, tokens, path);
+}
+
+std::vector<std::string_view> &chesspp::Parser::tokenise(
+    std::string_view input, std::vector<std::string_view> &tokens,
+    TokeniserPath path)
+{
+    // Reuse the caller's storage. clear() keeps the capacity so once the
+    // vector has grown to fit the longest line no more allocations happen.
+    tokens.clear();
+
+    switch (path)
+    {
+#ifdef CHESSPP_X86_SIMD
+    case TokeniserPath::avx2:
+        tokenise_avx2(input, tokens);
+        break;
+    case TokeniserPath::sse2:
+        tokenise_sse2(input, tokens);
+        break;
+#endif
+    default:
+        tokenise_scalar(input, tokens);
+        break;
+    }
+    return tokens;
+}
+
+bool chesspp::Parser::supports_tokeniser_path(TokeniserPath path)
+{
+    switch (path)
+    {
+#ifdef CHESSPP_X86_SIMD
+    case TokeniserPath::avx2:
+        return __builtin_cpu_supports("avx2");
+    case TokeniserPath::sse2:
+        return __builtin_cpu_supports("sse2");
+#endif
+    case TokeniserPath::scalar:
+        return true;
+    default:
+        return false;
+    }
+}
+
+chesspp::TokeniserPath chesspp::Parser::fastest_tokeniser_path()
+{
+    for (TokeniserPath path : {TokeniserPath::avx2, TokeniserPath::sse2})
+    {
+        if (supports_tokeniser_path(path))
+        {
+            return path;
+        }
+    }
+    return TokeniserPath::scalar;
 }
 
 std::string chesspp::Parser::tolower(std::string const& text) {
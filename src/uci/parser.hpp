@@ -11,12 +11,38 @@
 #define SRC_UCI_PARSER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "command/command.hpp"
 
 namespace chesspp
 {
+/**
+ * @brief The implementations the tokeniser can use to find whitespace
+ *
+ */
+enum class TokeniserPath
+{
+    /**
+     * @brief Classifies one character at a time. Always available.
+     *
+     */
+    scalar,
+
+    /**
+     * @brief Classifies 16 characters at a time using SSE2 (x86 only)
+     *
+     */
+    sse2,
+
+    /**
+     * @brief Classifies 32 characters at a time using AVX2 (x86 only)
+     *
+     */
+    avx2
+};
+
 /**
  * @brief Parses strings into UCI commands
  *
@@ -40,6 +66,47 @@ public:
      * @return A vector of strings containing the tokens in the command string
      */
     static std::vector<std::string> tokenise(std::string const &input);
+
+    /**
+     * @brief Splits a string on whitespace without copying it. The tokens are
+     *        views into `input` and are only valid for as long as it is.
+     *
+     * @param input A string containing the command to be parsed
+     * @param tokens Storage for the tokens. It is cleared and refilled, so
+     *        passing the same vector for every line avoids any allocation once
+     *        it has grown large enough.
+     * @return A reference to `tokens`
+     */
+    static std::vector<std::string_view> &tokenise(
+        std::string_view input, std::vector<std::string_view> &tokens);
+
+    /**
+     * @brief Splits a string on whitespace without copying it, using a
+     *        specific implementation. Every path gives the same result, this
+     *        exists for testing and benchmarking. The path must be supported by
+     *        the CPU (see supports_tokeniser_path).
+     *
+     * @param input A string containing the command to be parsed
+     * @param tokens Storage for the tokens. It is cleared and refilled.
+     * @param path The implementation to use
+     * @return A reference to `tokens`
+     */
+    static std::vector<std::string_view> &tokenise(
+        std::string_view input, std::vector<std::string_view> &tokens,
+        TokeniserPath path);
+
+    /**
+     * @brief Checks whether the current CPU can run a tokeniser path
+     *
+     */
+    static bool supports_tokeniser_path(TokeniserPath path);
+
+    /**
+     * @brief Gets the fastest tokeniser path the current CPU can run. This is
+     *        what tokenise uses by default.
+     *
+     */
+    static TokeniserPath fastest_tokeniser_path();
 };
 
 } // namespace chesspp
@@ -0,0 +1,99 @@
+#include <string_view>
+
+#include "position_tracker.hpp"
+
+bool chesspp::PositionTracker::equals_joined(std::string const &joined, TokenSpan tokens)
+{
+    if (tokens.empty())
+    {
+        return joined.empty();
+    }
+
+    // The tokens point into one line, so if they are separated by single
+    // spaces the whole range can be compared at once.
+    std::string_view const &last = tokens[tokens.size() - 1];
+    std::string_view const raw(
+        tokens[0].data(), static_cast<size_t>(last.data() + last.size() - tokens[0].data()));
+    if (raw == joined)
+    {
+        return true;
+    }
+
+    // Otherwise compare token by token, ignoring how they were separated
+    size_t offset = 0;
+    for (std::string_view const &token : tokens)
+    {
+        if (offset != 0)
+        {
+            if (offset >= joined.size() or joined[offset] != ' ')
+            {
+                return false;
+            }
+            offset++;
+        }
+        if (joined.compare(offset, token.size(), token.data(), token.size()) != 0)
+        {
+            return false;
+        }
+        offset += token.size();
+    }
+    return offset == joined.size();
+}
+
+void chesspp::PositionTracker::append_joined(std::string &joined, TokenSpan tokens)
+{
+    for (std::string_view const &token : tokens)
+    {
+        if (not joined.empty())
+        {
+            joined.push_back(' ');
+        }
+        joined.append(token.data(), token.size());
+    }
+}
+
+chesspp::PositionDelta chesspp::PositionTracker::update(std::vector<ArgumentView> const &arguments)
+{
+    PositionDelta delta;
+    for (ArgumentView const &argument : arguments)
+    {
+        if (argument.value == "fen")
+        {
+            delta.fen = argument.parameters;
+        }
+        else if (argument.value == "moves")
+        {
+            delta.moves = argument.parameters;
+        }
+    }
+
+    bool const same_start = has_position and equals_joined(fen, delta.fen);
+    bool const extends = same_start and delta.moves.size() >= num_moves and
+                         equals_joined(moves, TokenSpan(delta.moves.begin(), num_moves));
+    if (extends)
+    {
+        TokenSpan const new_moves = delta.moves.subspan(num_moves);
+        append_joined(moves, new_moves);
+        num_moves = delta.moves.size();
+        delta.reset = false;
+        delta.moves = new_moves;
+        return delta;
+    }
+
+    // Start again from the new position. The strings keep their capacity.
+    has_position = true;
+    fen.clear();
+    append_joined(fen, delta.fen);
+    moves.clear();
+    append_joined(moves, delta.moves);
+    num_moves = delta.moves.size();
+    return delta;
+}
+
+void chesspp::PositionTracker::reset()
+{
+    has_position = false;
+    fen.clear();
+    moves.clear();
+    num_moves = 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file position_tracker.hpp
+ * @brief Turns repeated `position` commands into the moves that are new
+ *
+ */
+
+#ifndef SRC_UCI_POSITION_TRACKER_H
+#define SRC_UCI_POSITION_TRACKER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "chesspp/argument.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief What changed since the previous `position` command. The spans point
+ *        into the tokens of the command, so they are only valid for as long as
+ *        its arguments are.
+ *
+ */
+struct PositionDelta
+{
+    /**
+     * @brief Whether the engine has to set up the position from scratch. If
+     *        false `moves` are to be played on top of the current position.
+     *
+     */
+    bool reset = true;
+
+    /**
+     * @brief The fields of the FEN to start from, empty for the start position.
+     *        Only meaningful if `reset` is set.
+     *
+     */
+    TokenSpan fen;
+
+    /**
+     * @brief The moves to play
+     *
+     */
+    TokenSpan moves;
+};
+
+/**
+ * @brief Remembers the last `position` command so that a command that only
+ *        appends moves to it can be turned into just the appended moves.
+ *
+ * Over a game the interface resends the whole game with every move. The
+ * tracker keeps a copy of the previous starting position and move list, and
+ * when the new command starts from the same position and its moves extend the
+ * previous ones it reports only the new moves. If the history diverges (eg.
+ * after a takeback) or a different starting position is sent the delta is a
+ * full reset.
+ *
+ * When the interface separates moves with single spaces the previous moves
+ * are compared with one memcmp, otherwise move by move.
+ */
+class PositionTracker
+{
+private:
+    /**
+     * @brief Whether a position has been seen since construction or reset()
+     *
+     */
+    bool has_position = false;
+
+    /**
+     * @brief The FEN fields of the previous position joined by single spaces,
+     *        empty for the start position
+     *
+     */
+    std::string fen;
+
+    /**
+     * @brief The moves of the previous position joined by single spaces
+     *
+     */
+    std::string moves;
+
+    /**
+     * @brief The number of moves in `moves`
+     *
+     */
+    size_t num_moves = 0;
+
+    /**
+     * @brief Check whether `tokens` joined by single spaces equals `joined`
+     *
+     */
+    static bool equals_joined(std::string const &joined, TokenSpan tokens);
+
+    /**
+     * @brief Appends `tokens` to `joined`, separated by single spaces
+     *
+     */
+    static void append_joined(std::string &joined, TokenSpan tokens);
+
+public:
+    /**
+     * @brief Works out what changed since the previous `position` command
+     *
+     * @param arguments The parsed arguments of the command. A command without
+     *        `fen` starts from the start position.
+     * @return PositionDelta What the engine has to do to reach the new position
+     */
+    PositionDelta update(std::vector<ArgumentView> const &arguments);
+
+    /**
+     * @brief Forgets the previous position, so that the next update is a full
+     *        reset. Called for `ucinewgame`.
+     *
+     */
+    void reset();
+};
+
+} // namespace chesspp
+
+#endif
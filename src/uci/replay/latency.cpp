@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <numeric>
+
+#include "latency.hpp"
+#include "../parser.hpp"
+
+std::string_view chesspp::exchange_name(Exchange exchange)
+{
+    switch (exchange)
+    {
+    case Exchange::uciok:
+        return "uci-uciok";
+    case Exchange::readyok:
+        return "isready-readyok";
+    case Exchange::bestmove:
+        return "go-bestmove";
+    case Exchange::stop:
+        return "stop-bestmove";
+    }
+    return "";
+}
+
+void chesspp::ResponseMatcher::await(Exchange exchange, uint64_t time)
+{
+    size_t const index = static_cast<size_t>(exchange);
+    awaiting[index] = true;
+    started[index] = time;
+    timed[index] = true;
+}
+
+bool chesspp::ResponseMatcher::is_response(std::string_view line)
+{
+    size_t const start = line.find_first_not_of(" \t");
+    if (start == std::string_view::npos)
+    {
+        return false;
+    }
+    std::string_view const name = line.substr(start, line.find_first_of(" \t", start) - start);
+    return name == "bestmove" or name == "readyok" or name == "uciok";
+}
+
+bool chesspp::ResponseMatcher::observe(
+    uint64_t time, Direction direction, std::string_view line, LatencySample &sample)
+{
+    Parser::tokenise(line, tokens);
+    if (tokens.empty())
+    {
+        return false;
+    }
+    std::string_view const name = tokens[0];
+    size_t const search = static_cast<size_t>(Exchange::bestmove);
+
+    if (direction == Direction::to_engine)
+    {
+        if (name == "uci")
+        {
+            await(Exchange::uciok, time);
+        }
+        else if (name == "isready")
+        {
+            await(Exchange::readyok, time);
+        }
+        else if (name == "go")
+        {
+            bool const unlimited =
+                std::find(tokens.begin() + 1, tokens.end(), "infinite") != tokens.end() or
+                std::find(tokens.begin() + 1, tokens.end(), "ponder") != tokens.end();
+            await(Exchange::bestmove, time);
+            timed[search] = not unlimited;
+            search_exchange = Exchange::bestmove;
+        }
+        else if (name == "ponderhit" and awaiting[search] and not timed[search])
+        {
+            await(Exchange::bestmove, time);
+        }
+        else if (name == "stop" and awaiting[search])
+        {
+            await(Exchange::bestmove, time);
+            search_exchange = Exchange::stop;
+        }
+        return false;
+    }
+
+    size_t index;
+    Exchange exchange;
+    if (name == "uciok")
+    {
+        exchange = Exchange::uciok;
+        index = static_cast<size_t>(exchange);
+    }
+    else if (name == "readyok")
+    {
+        exchange = Exchange::readyok;
+        index = static_cast<size_t>(exchange);
+    }
+    else if (name == "bestmove")
+    {
+        exchange = search_exchange;
+        index = search;
+    }
+    else
+    {
+        return false;
+    }
+
+    bool const measured = awaiting[index] and timed[index];
+    awaiting[index] = false;
+    if (measured)
+    {
+        sample = LatencySample{exchange, time > started[index] ? time - started[index] : 0};
+    }
+    return measured;
+}
+
+void chesspp::LatencySummary::add(LatencySample const &sample)
+{
+    size_t const index = static_cast<size_t>(sample.exchange);
+    samples[index].push_back(sample.latency);
+    sorted[index] = false;
+}
+
+std::vector<uint64_t> const &chesspp::LatencySummary::sorted_samples(Exchange exchange) const
+{
+    size_t const index = static_cast<size_t>(exchange);
+    std::vector<uint64_t> &values = samples[index];
+    if (not sorted[index])
+    {
+        std::sort(values.begin(), values.end());
+        sorted[index] = true;
+    }
+    return values;
+}
+
+uint64_t chesspp::LatencySummary::percentile(Exchange exchange, double quantile) const
+{
+    std::vector<uint64_t> const &values = sorted_samples(exchange);
+    if (values.empty())
+    {
+        return 0;
+    }
+    size_t const rank = static_cast<size_t>(quantile * static_cast<double>(values.size() - 1) + 0.5);
+    return values[std::min(rank, values.size() - 1)];
+}
+
+uint64_t chesspp::LatencySummary::mean(Exchange exchange) const
+{
+    std::vector<uint64_t> const &values = samples[static_cast<size_t>(exchange)];
+    if (values.empty())
+    {
+        return 0;
+    }
+    return std::accumulate(values.begin(), values.end(), uint64_t(0)) / values.size();
+}
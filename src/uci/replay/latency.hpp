@@ -0,0 +1,184 @@
+/**
+ * @file latency.hpp
+ * @brief Measures how long an engine takes to answer the commands that
+ *        expect an answer
+ *
+ */
+
+#ifndef SRC_UCI_REPLAY_LATENCY_H
+#define SRC_UCI_REPLAY_LATENCY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "log.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief The exchanges whose latency is measured
+ *
+ */
+enum class Exchange : uint8_t
+{
+    /**
+     * @brief `uci` to `uciok`
+     *
+     */
+    uciok,
+
+    /**
+     * @brief `isready` to `readyok`
+     *
+     */
+    readyok,
+
+    /**
+     * @brief `go` with a time limit, or `ponderhit`, to `bestmove`
+     *
+     */
+    bestmove,
+
+    /**
+     * @brief `stop` to `bestmove`
+     *
+     */
+    stop
+};
+
+inline constexpr size_t num_exchanges = 4;
+
+/**
+ * @brief Get the name of an exchange for reports
+ *
+ */
+std::string_view exchange_name(Exchange exchange);
+
+/**
+ * @brief One measured exchange
+ *
+ */
+struct LatencySample
+{
+    Exchange exchange = Exchange::uciok;
+
+    /**
+     * @brief Nanoseconds from the request to the response
+     *
+     */
+    uint64_t latency = 0;
+};
+
+/**
+ * @brief Follows a session line by line and pairs requests with their
+ *        responses.
+ *
+ * A `go ponder` or `go infinite` only starts the clock for its `bestmove`
+ * when `ponderhit` or `stop` arrives, since until then the engine is not
+ * expected to answer. `stop` restarts the clock, so a `bestmove` that
+ * follows it measures how quickly the engine stops.
+ */
+class ResponseMatcher
+{
+private:
+    /**
+     * @brief Whether a response to each exchange is awaited
+     *
+     */
+    std::array<bool, num_exchanges> awaiting = {};
+
+    /**
+     * @brief When the clock started for each exchange. A `bestmove` that is
+     *        awaited without a start time is for a search with no limit.
+     *
+     */
+    std::array<uint64_t, num_exchanges> started = {};
+    std::array<bool, num_exchanges> timed = {};
+
+    /**
+     * @brief Which of `bestmove` and `stop` the awaited `bestmove` answers
+     *
+     */
+    Exchange search_exchange = Exchange::bestmove;
+
+    /**
+     * @brief Storage for the tokens of each line
+     *
+     */
+    std::vector<std::string_view> tokens;
+
+    void await(Exchange exchange, uint64_t time);
+
+public:
+    /**
+     * @brief Follows one line of the session
+     *
+     * @param time When the line was sent or received, in nanoseconds
+     * @param direction Which way it went
+     * @param line The line
+     * @param sample Set to the measured exchange, if the line completes one
+     * @return true If the line completed an exchange
+     */
+    bool observe(uint64_t time, Direction direction, std::string_view line, LatencySample &sample);
+
+    /**
+     * @brief Check whether `bestmove`, `readyok` or `uciok` is a response
+     *        the replay has to wait for
+     *
+     */
+    static bool is_response(std::string_view line);
+};
+
+/**
+ * @brief Collects latency samples by exchange
+ *
+ */
+class LatencySummary
+{
+private:
+    /**
+     * @brief The latencies of each exchange, sorted lazily for percentiles
+     *
+     */
+    mutable std::array<std::vector<uint64_t>, num_exchanges> samples;
+    mutable std::array<bool, num_exchanges> sorted = {};
+
+    /**
+     * @brief Sorts the samples of an exchange if needed
+     *
+     */
+    std::vector<uint64_t> const &sorted_samples(Exchange exchange) const;
+
+public:
+    void add(LatencySample const &sample);
+
+    /**
+     * @brief Get the number of samples of an exchange
+     *
+     */
+    size_t count(Exchange exchange) const
+    {
+        return samples[static_cast<size_t>(exchange)].size();
+    }
+
+    /**
+     * @brief Get a quantile of the samples of an exchange (nearest rank), 0
+     *        if there are none
+     *
+     * @param quantile Between 0 and 1, eg. 0.5 for the median
+     */
+    uint64_t percentile(Exchange exchange, double quantile) const;
+
+    /**
+     * @brief Get the mean of the samples of an exchange, 0 if there are none
+     *
+     */
+    uint64_t mean(Exchange exchange) const;
+};
+
+} // namespace chesspp
+
+#endif
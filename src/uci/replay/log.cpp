@@ -0,0 +1,85 @@
+#include <cstring>
+
+#include "log.hpp"
+
+namespace
+{
+void append_varint(std::string &buffer, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        buffer.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+} // namespace
+
+void chesspp::session_log::append_header(std::string &buffer)
+{
+    buffer.append(magic, header_size);
+}
+
+void chesspp::session_log::append_entry(
+    std::string &buffer, uint64_t delta, Direction direction, std::string_view line)
+{
+    append_varint(buffer, delta << 1 | static_cast<uint64_t>(direction));
+    append_varint(buffer, line.size());
+    buffer.append(line);
+}
+
+chesspp::LogReader::LogReader(std::string_view log) : remaining(log)
+{
+    if (log.size() < session_log::header_size or
+        std::memcmp(log.data(), session_log::magic, session_log::header_size) != 0)
+    {
+        malformed = true;
+        remaining = {};
+        return;
+    }
+    remaining.remove_prefix(session_log::header_size);
+}
+
+bool chesspp::LogReader::read_varint(uint64_t &value)
+{
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        if (remaining.empty())
+        {
+            return false;
+        }
+        uint8_t const byte = static_cast<uint8_t>(remaining.front());
+        remaining.remove_prefix(1);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool chesspp::LogReader::next(LogRecord &record)
+{
+    if (remaining.empty())
+    {
+        return false;
+    }
+
+    uint64_t tagged_delta = 0;
+    uint64_t length = 0;
+    if (not read_varint(tagged_delta) or not read_varint(length) or length > remaining.size())
+    {
+        malformed = true;
+        remaining = {};
+        return false;
+    }
+
+    time += tagged_delta >> 1;
+    record.time = time;
+    record.direction = static_cast<Direction>(tagged_delta & 1);
+    record.line = remaining.substr(0, length);
+    remaining.remove_prefix(length);
+    return true;
+}
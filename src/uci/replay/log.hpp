@@ -0,0 +1,155 @@
+/**
+ * @file log.hpp
+ * @brief The binary format of recorded UCI sessions
+ *
+ */
+
+#ifndef SRC_UCI_REPLAY_LOG_H
+#define SRC_UCI_REPLAY_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace chesspp
+{
+/**
+ * @brief Which way a line went
+ *
+ */
+enum class Direction : uint8_t
+{
+    /**
+     * @brief From the interface to the engine
+     *
+     */
+    to_engine = 0,
+
+    /**
+     * @brief From the engine to the interface
+     *
+     */
+    to_interface = 1
+};
+
+/**
+ * @brief One line of a recorded session
+ *
+ */
+struct LogRecord
+{
+    /**
+     * @brief Nanoseconds since the recording started
+     *
+     */
+    uint64_t time = 0;
+
+    Direction direction = Direction::to_engine;
+
+    /**
+     * @brief The line, without its newline
+     *
+     */
+    std::string_view line;
+};
+
+/**
+ * @brief The layout of a session log.
+ *
+ * A log is an 8 byte header, "CPPREC" followed by the format version and a
+ * zero byte, then one entry per line:
+ *
+ *     varint  (nanoseconds since the previous entry) << 1 | direction
+ *     varint  length of the line
+ *     bytes   the line, without its newline
+ *
+ * Varints are little endian base 128, so a typical entry costs 3 to 5 bytes
+ * on top of the line itself.
+ */
+namespace session_log
+{
+inline constexpr char magic[] = {'C', 'P', 'P', 'R', 'E', 'C', 1, 0};
+
+inline constexpr size_t header_size = sizeof(magic);
+
+/**
+ * @brief Appends the header to a buffer
+ *
+ */
+void append_header(std::string &buffer);
+
+/**
+ * @brief Appends an entry to a buffer
+ *
+ * @param buffer The buffer to append to
+ * @param delta Nanoseconds since the previous entry
+ * @param direction Which way the line went
+ * @param line The line, without its newline
+ */
+void append_entry(std::string &buffer, uint64_t delta, Direction direction, std::string_view line);
+} // namespace session_log
+
+/**
+ * @brief Reads the entries of a session log held in memory, without copying
+ *        them
+ *
+ */
+class LogReader
+{
+private:
+    /**
+     * @brief The entries that have not been read yet
+     *
+     */
+    std::string_view remaining;
+
+    /**
+     * @brief The time of the last entry read
+     *
+     */
+    uint64_t time = 0;
+
+    /**
+     * @brief Set if the header or an entry is malformed
+     *
+     */
+    bool malformed = false;
+
+    /**
+     * @brief Reads a varint from the front of `remaining`
+     *
+     */
+    bool read_varint(uint64_t &value);
+
+public:
+    /**
+     * @brief Construct a new LogReader object
+     *
+     * @param log The whole log, header included. Must outlive the reader.
+     */
+    explicit LogReader(std::string_view log);
+
+    /**
+     * @brief Reads the next entry
+     *
+     * @param record Set to the entry. Its line points into the log.
+     * @return true If an entry was read
+     * @return false At the end of the log, or if it is malformed
+     */
+    bool next(LogRecord &record);
+
+    /**
+     * @brief Check whether reading stopped because the log is malformed (eg.
+     *        truncated in the middle of an entry)
+     *
+     */
+    bool is_malformed() const
+    {
+        return malformed;
+    }
+};
+
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,45 @@
+#include "recorder.hpp"
+
+chesspp::Recorder::Recorder(OutputSink &sink, size_t flush_size)
+    : sink(sink), flush_size(flush_size), last(Clock::now())
+{
+    buffer.reserve(flush_size);
+    session_log::append_header(buffer);
+}
+
+chesspp::Recorder::~Recorder()
+{
+    flush();
+}
+
+void chesspp::Recorder::record(Direction direction, std::string_view line)
+{
+    Clock::time_point const now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    // Threads may take the time in one order and the lock in the other, so
+    // keep the log in order rather than going back in time
+    uint64_t delta = 0;
+    if (now > last)
+    {
+        delta = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count();
+        last = now;
+    }
+    session_log::append_entry(buffer, delta, direction, line);
+
+    if (buffer.size() >= flush_size)
+    {
+        sink.write(buffer);
+        buffer.clear();
+    }
+}
+
+void chesspp::Recorder::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (not buffer.empty())
+    {
+        sink.write(buffer);
+        buffer.clear();
+    }
+}
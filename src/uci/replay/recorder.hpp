@@ -0,0 +1,94 @@
+/**
+ * @file recorder.hpp
+ * @brief Records every line an engine reads and writes
+ *
+ */
+
+#ifndef SRC_UCI_REPLAY_RECORDER_H
+#define SRC_UCI_REPLAY_RECORDER_H
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "log.hpp"
+#include "../io/output_writer.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief Writes a session log (see session_log) of the lines an engine reads
+ *        and writes, with nanosecond timestamps, so the session can be
+ *        replayed later with `chesspp-replay`.
+ *
+ * Attach it with Engine::set_recorder. Lines read are stamped as soon as the
+ * reader has them, lines written as soon as they are finished. Entries are
+ * buffered and handed to the sink whenever the engine runs out of input, once
+ * `flush_size` bytes are waiting, and when the recorder is destroyed.
+ *
+ * All member functions are thread safe.
+ */
+class Recorder
+{
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Where the log goes
+     *
+     */
+    OutputSink &sink;
+
+    /**
+     * @brief Entries that have not been handed to the sink yet
+     *
+     */
+    std::string buffer;
+
+    size_t flush_size;
+
+    /**
+     * @brief When the last entry was made, or the recording started
+     *
+     */
+    Clock::time_point last;
+
+    std::mutex mutex;
+
+public:
+    /**
+     * @brief Starts a recording
+     *
+     * @param sink Where to write the log, eg. an FdSink on a file. Must
+     *        outlive the recorder.
+     * @param flush_size Hand entries to the sink once this many bytes wait
+     */
+    explicit Recorder(OutputSink &sink, size_t flush_size = 64 * 1024);
+
+    /**
+     * @brief Writes anything still buffered
+     *
+     */
+    ~Recorder();
+
+    Recorder(Recorder const &) = delete;
+    Recorder &operator=(Recorder const &) = delete;
+
+    /**
+     * @brief Records a line, stamped with the current time
+     *
+     */
+    void record(Direction direction, std::string_view line);
+
+    /**
+     * @brief Hands everything buffered to the sink
+     *
+     */
+    void flush();
+};
+
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,213 @@
+#include <algorithm>
+
+#include "search_controller.hpp"
+
+namespace
+{
+void record(chesspp::HistogramSnapshot &histogram, uint64_t nanoseconds)
+{
+    histogram.counts[chesspp::histogram::bucket(nanoseconds)]++;
+    histogram.count++;
+    histogram.sum += nanoseconds;
+    histogram.max = std::max(histogram.max, nanoseconds);
+}
+} // namespace
+
+chesspp::SearchController::SearchController(Engine &engine, Clock::duration fallback_after)
+    : engine(engine), fallback_after(fallback_after)
+{
+    engine.register_signal_callback([this](Signal signal) { on_signal(signal); });
+    if (fallback_after > Clock::duration::zero())
+    {
+        watchdog = std::thread(&SearchController::watch, this);
+    }
+}
+
+chesspp::SearchController::~SearchController()
+{
+    engine.register_signal_callback({});
+    if (watchdog.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shutting_down = true;
+        }
+        changed.notify_one();
+        watchdog.join();
+    }
+}
+
+void chesspp::SearchController::on_signal(Signal signal)
+{
+    switch (signal)
+    {
+    case Signal::stop:
+    {
+        // The engine has already raised its flag for the search
+        Clock::time_point const now = Clock::now();
+        uint64_t const search = engine.get_searches_read();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stops.empty() or stops.back().search != search)
+        {
+            stops.push_back(StopTime{search, now});
+        }
+        break;
+    }
+    case Signal::ucinewgame:
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        new_game_from = engine.get_searches_read() + 1;
+        return;
+    }
+    case Signal::ponderhit:
+    case Signal::go:
+    case Signal::quit:
+        return;
+    }
+    changed.notify_one();
+}
+
+void chesspp::SearchController::start_search()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        searches_started = engine.get_running_search();
+        while (not stops.empty() and stops.front().search < searches_started)
+        {
+            stops.pop_front();
+        }
+        if (new_game_from != 0 and searches_started >= new_game_from)
+        {
+            game_latency = HistogramSnapshot();
+            new_game_from = 0;
+        }
+        searching = true;
+        deadline = Clock::time_point::max();
+        pv_move.clear();
+        pv_ponder.clear();
+    }
+    changed.notify_one();
+}
+
+void chesspp::SearchController::set_deadline(Clock::time_point time)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        deadline = time;
+    }
+    changed.notify_one();
+}
+
+void chesspp::SearchController::report_pv(std::string_view move, std::string_view ponder)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pv_move.assign(move);
+        pv_ponder.assign(ponder);
+    }
+    // The watchdog may be past a deadline with nothing to answer yet
+    changed.notify_one();
+}
+
+void chesspp::SearchController::send_bestmove(std::string_view move, std::string_view ponder)
+{
+    std::string_view const arguments[] = {move, "ponder", ponder};
+    engine.get_output().write("bestmove", TokenSpan(arguments, ponder.empty() ? 1 : 3));
+    searching = false;
+    Clock::time_point stopped_at;
+    if (stop_time(stopped_at))
+    {
+        uint64_t const latency = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - stopped_at)
+                .count());
+        record(game_latency, latency);
+        record(total_latency, latency);
+    }
+}
+
+bool chesspp::SearchController::bestmove(std::string_view move, std::string_view ponder)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (not searching)
+        {
+            return false;
+        }
+        send_bestmove(move, ponder);
+    }
+    changed.notify_one();
+    return true;
+}
+
+bool chesspp::SearchController::stop_time(Clock::time_point &time) const
+{
+    if (stops.empty() or stops.front().search != searches_started)
+    {
+        return false;
+    }
+    time = stops.front().time;
+    return true;
+}
+
+chesspp::SearchController::Clock::time_point chesspp::SearchController::next_deadline() const
+{
+    if (not searching)
+    {
+        return Clock::time_point::max();
+    }
+    Clock::time_point next = deadline;
+    Clock::time_point stopped_at;
+    if (stop_time(stopped_at))
+    {
+        next = std::min(next, stopped_at + fallback_after);
+    }
+    return next;
+}
+
+void chesspp::SearchController::watch()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (not shutting_down)
+    {
+        Clock::time_point const next = next_deadline();
+        if (next == Clock::time_point::max())
+        {
+            changed.wait(lock);
+            continue;
+        }
+        if (Clock::now() < next)
+        {
+            changed.wait_until(lock, next);
+            continue;
+        }
+
+        // Without a move there is nothing sensible to answer with, so keep
+        // waiting for the search
+        if (pv_move.empty())
+        {
+            changed.wait(lock);
+            continue;
+        }
+        send_bestmove(pv_move, pv_ponder);
+        fallbacks++;
+        abort_search.store(searches_started + 1, std::memory_order_relaxed);
+    }
+}
+
+chesspp::HistogramSnapshot chesspp::SearchController::get_game_latency() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return game_latency;
+}
+
+chesspp::HistogramSnapshot chesspp::SearchController::get_total_latency() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return total_latency;
+}
+
+uint64_t chesspp::SearchController::get_fallbacks() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return fallbacks;
+}
@@ -0,0 +1,279 @@
+/**
+ * @file search_controller.hpp
+ * @brief Tells a search when to stop, and makes sure `bestmove` is sent in
+ *        time
+ *
+ */
+
+#ifndef SRC_UCI_SEARCH_CONTROLLER_H
+#define SRC_UCI_SEARCH_CONTROLLER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "chesspp/stats.hpp"
+#include "engine.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief Sits between an Engine and its search to cut the time from `stop`
+ *        to `bestmove`, and to measure it.
+ *
+ * should_stop() and ponderhit_received() build on the engine's own flags
+ * (see Engine::stop_requested()), which the reader thread raises the moment
+ * `stop` or `ponderhit` is read, and add only the watchdog's answer. They are
+ * a few relaxed loads that only miss the cache when something has just
+ * changed.
+ *
+ * The search calls start_search() before it begins, report_pv() whenever
+ * its best line changes and bestmove() when it is done. The time from
+ * `stop` arriving to `bestmove` being written is recorded, per game (reset
+ * by `ucinewgame`) and in total. Commands are numbered by the engine's count
+ * of the search they follow, so a `stop` or `ucinewgame` that is read while an earlier search
+ * is still running is counted against the right one.
+ *
+ * With a fallback deadline, a watchdog thread writes `bestmove` itself from
+ * the last reported pv if the search has not answered that long after
+ * `stop`, or by the deadline set with set_deadline(). The search is then
+ * told to stop, and its own bestmove() is dropped so the interface never
+ * gets two answers.
+ *
+ * A search must have returned (or its threads joined) before the next
+ * start_search(). This is the case when it runs inside the `go` callback.
+ * The controller must outlive the engine's start().
+ */
+class SearchController
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    /**
+     * @brief One more than the number of the search the watchdog last
+     *        answered for, 0 if none
+     *
+     */
+    alignas(64) std::atomic<uint64_t> abort_search{0};
+
+    Engine &engine;
+
+    /**
+     * @brief How long after `stop` to wait before answering for the search,
+     *        zero to never
+     *
+     */
+    Clock::duration fallback_after;
+
+    /**
+     * @brief Guards everything below
+     *
+     */
+    alignas(64) mutable std::mutex mutex;
+
+    /**
+     * @brief Wakes the watchdog when a deadline changes
+     *
+     */
+    std::condition_variable changed;
+
+    /**
+     * @brief Set between start_search() and the search's `bestmove` being
+     *        written, by the search or the watchdog
+     *
+     */
+    bool searching = false;
+
+    /**
+     * @brief When the first `stop` after a `go` arrived
+     *
+     */
+    struct StopTime
+    {
+        /**
+         * @brief The number of the search, counting `go` commands from 1
+         *
+         */
+        uint64_t search;
+
+        Clock::time_point time;
+    };
+
+    /**
+     * @brief The number of the search running, or that ran last, as numbered
+     *        by the engine. Input is read ahead of the search, so this can be
+     *        behind the engine's count of searches read.
+     *
+     */
+    uint64_t searches_started = 0;
+
+    /**
+     * @brief The stops of the searches from `searches_started` on, oldest
+     *        first
+     *
+     */
+    std::deque<StopTime> stops;
+
+    /**
+     * @brief The number of the first search of a new game, 0 if no
+     *        `ucinewgame` is waiting for its search to start
+     *
+     */
+    uint64_t new_game_from = 0;
+
+    /**
+     * @brief The deadline set with set_deadline(), `time_point::max()` if
+     *        none
+     *
+     */
+    Clock::time_point deadline = Clock::time_point::max();
+
+    /**
+     * @brief The first two moves of the last pv reported
+     *
+     */
+    std::string pv_move;
+    std::string pv_ponder;
+
+    HistogramSnapshot game_latency;
+    HistogramSnapshot total_latency;
+    uint64_t fallbacks = 0;
+
+    bool shutting_down = false;
+    std::thread watchdog;
+
+    /**
+     * @brief Runs on the reader thread for each Signal
+     *
+     */
+    void on_signal(Signal signal);
+
+    /**
+     * @brief Writes `bestmove` and records the latency. The caller must
+     *        hold `mutex`.
+     *
+     */
+    void send_bestmove(std::string_view move, std::string_view ponder);
+
+    /**
+     * @brief Get when `stop` arrived for the running search
+     *
+     * @return false If it hasn't. The caller must hold `mutex`.
+     */
+    bool stop_time(Clock::time_point &time) const;
+
+    /**
+     * @brief Get when the watchdog should answer for the search, or
+     *        `time_point::max()`. The caller must hold `mutex`.
+     *
+     */
+    Clock::time_point next_deadline() const;
+
+    /**
+     * @brief The watchdog thread
+     *
+     */
+    void watch();
+
+public:
+    /**
+     * @brief Construct a new SearchController object. Takes over the
+     *        engine's signal callback, so must be constructed before the
+     *        engine starts.
+     *
+     * @param engine The engine, whose output `bestmove` is written to
+     * @param fallback_after How long after `stop` to answer for the search
+     *        if it hasn't, zero to always wait for it
+     */
+    explicit SearchController(Engine &engine, Clock::duration fallback_after = Clock::duration::zero());
+
+    ~SearchController();
+
+    SearchController(SearchController const &) = delete;
+    SearchController &operator=(SearchController const &) = delete;
+
+    /**
+     * @brief Check whether the search should stop, because of `stop` or
+     *        because the watchdog has answered for it. Cheap enough to poll
+     *        from every node of every search thread.
+     *
+     */
+    bool should_stop() const
+    {
+        return engine.stop_requested() or
+               abort_search.load(std::memory_order_relaxed) == engine.get_running_search() + 1;
+    }
+
+    /**
+     * @brief Check whether `ponderhit` has been received for the search
+     *
+     */
+    bool ponderhit_received() const
+    {
+        return engine.ponderhit_received();
+    }
+
+    /**
+     * @brief Call when a search starts, before reporting anything. Takes the
+     *        number of the search from the engine, so must be called from
+     *        the `go` callback, or from a search it started before the next
+     *        `go` is dispatched.
+     *
+     */
+    void start_search();
+
+    /**
+     * @brief Set a time by which `bestmove` must be written even without
+     *        `stop`, eg. the hard limit from a time manager. Only has an
+     *        effect with a fallback deadline.
+     *
+     */
+    void set_deadline(Clock::time_point time);
+
+    /**
+     * @brief Record the start of the search's best line, the fallback answer
+     *
+     * @param move The first move of the pv
+     * @param ponder The second move, empty if there is none
+     */
+    void report_pv(std::string_view move, std::string_view ponder = {});
+
+    /**
+     * @brief Writes the search's `bestmove`
+     *
+     * @return false If the watchdog has already answered for the search, so
+     *         nothing was written
+     */
+    bool bestmove(std::string_view move, std::string_view ponder = {});
+
+    /**
+     * @brief Get the times from `stop` to `bestmove` in nanoseconds since
+     *        the last `ucinewgame`
+     *
+     */
+    HistogramSnapshot get_game_latency() const;
+
+    /**
+     * @brief Get the times from `stop` to `bestmove` in nanoseconds since
+     *        the controller was made
+     *
+     */
+    HistogramSnapshot get_total_latency() const;
+
+    /**
+     * @brief Get the number of times the watchdog answered for a search
+     *
+     */
+    uint64_t get_fallbacks() const;
+};
+
+} // namespace chesspp
+
+#endif
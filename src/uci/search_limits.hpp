@@ -0,0 +1,100 @@
+/**
+ * @file search_limits.hpp
+ * @brief The typed arguments of the `go` command
+ *
+ */
+
+#ifndef SRC_UCI_SEARCH_LIMITS_H
+#define SRC_UCI_SEARCH_LIMITS_H
+
+#include <cstdint>
+#include <limits>
+
+#include "command/schema.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief The limits of a search, decoded from the arguments of `go`. Flat and
+ *        trivially copyable.
+ *
+ * Numbers that were not sent are `unset`. Times are in milliseconds.
+ */
+struct SearchLimits
+{
+    /**
+     * @brief The value of a number that was not sent
+     *
+     */
+    static constexpr int64_t unset = std::numeric_limits<int64_t>::min();
+
+    /**
+     * @brief More than the number of legal moves in any position
+     *
+     */
+    static constexpr size_t max_searchmoves = 256;
+
+    /**
+     * @brief Only search these moves, all if empty
+     *
+     */
+    MoveList<max_searchmoves> searchmoves;
+
+    bool ponder = false;
+    bool infinite = false;
+
+    int64_t wtime = unset;
+    int64_t btime = unset;
+    int64_t winc = unset;
+    int64_t binc = unset;
+    int64_t movestogo = unset;
+    int64_t depth = unset;
+    int64_t nodes = unset;
+    int64_t mate = unset;
+    int64_t movetime = unset;
+
+    /**
+     * @brief Check whether a number was sent
+     *
+     */
+    static constexpr bool is_set(int64_t value)
+    {
+        return value != unset;
+    }
+};
+
+/**
+ * @brief Binds the arguments of grammar::go to the fields of SearchLimits
+ *
+ */
+inline constexpr auto go_schema = make_schema<SearchLimits>({
+    field<&SearchLimits::searchmoves>("searchmoves"),
+    field<&SearchLimits::ponder>("ponder"),
+    field<&SearchLimits::wtime>("wtime"),
+    field<&SearchLimits::btime>("btime"),
+    field<&SearchLimits::winc>("winc"),
+    field<&SearchLimits::binc>("binc"),
+    field<&SearchLimits::movestogo>("movestogo"),
+    field<&SearchLimits::depth>("depth"),
+    field<&SearchLimits::nodes>("nodes"),
+    field<&SearchLimits::mate>("mate"),
+    field<&SearchLimits::movetime>("movetime"),
+    field<&SearchLimits::infinite>("infinite")});
+
+/**
+ * @brief Decodes the parsed arguments of `go`
+ *
+ * @param arguments The parsed arguments
+ * @param limits Reset and filled with the limits
+ * @return DecodeResult What went wrong, if anything
+ */
+inline DecodeResult decode_search_limits(
+    std::vector<ArgumentView> const &arguments, SearchLimits &limits)
+{
+    limits = SearchLimits();
+    return go_schema.decode(arguments, limits);
+}
+
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * @file spsc_queue.hpp
+ * @brief A lock-free single producer, single consumer ring buffer
+ *
+ */
+
+#ifndef SRC_UCI_SPSC_QUEUE_H
+#define SRC_UCI_SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace chesspp
+{
+/**
+ * @brief A bounded lock-free queue for handing items from exactly one producer
+ *        thread to exactly one consumer thread.
+ *
+ * Items live in the ring itself and are written and read in place: the
+ * producer fills the slot returned by acquire() and then publish()es it, the
+ * consumer processes the slot returned by front() and then release()s it.
+ * Slots are never destroyed, so an item that owns buffers (eg. a LineArena)
+ * keeps them from one use to the next.
+ *
+ * @tparam T The item type. Must be default constructible.
+ * @tparam Capacity The number of slots. Must be a power of two.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 and (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+private:
+    /**
+     * @brief The slots of the ring
+     *
+     */
+    std::array<T, Capacity> slots;
+
+    /**
+     * @brief The number of items the consumer has released. Only written by
+     *        the consumer.
+     *
+     */
+    alignas(64) std::atomic<size_t> head{0};
+
+    /**
+     * @brief The number of items the producer has published. Only written by
+     *        the producer.
+     *
+     */
+    alignas(64) std::atomic<size_t> tail{0};
+
+public:
+    /**
+     * @brief Get the next free slot to write into. Producer only.
+     *
+     * @return T* The slot, or `nullptr` if the queue is full
+     */
+    T *acquire()
+    {
+        size_t const position = tail.load(std::memory_order_relaxed);
+        if (position - head.load(std::memory_order_acquire) == Capacity)
+        {
+            return nullptr;
+        }
+        return &slots[position & (Capacity - 1)];
+    }
+
+    /**
+     * @brief Makes the slot returned by acquire() visible to the consumer.
+     *        Producer only.
+     *
+     */
+    void publish()
+    {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Get the oldest published item. Consumer only.
+     *
+     * @return T* The item, or `nullptr` if the queue is empty
+     */
+    T *front()
+    {
+        size_t const position = head.load(std::memory_order_relaxed);
+        if (position == tail.load(std::memory_order_seq_cst))
+        {
+            return nullptr;
+        }
+        return &slots[position & (Capacity - 1)];
+    }
+
+    /**
+     * @brief Hands the slot returned by front() back to the producer.
+     *        Consumer only.
+     *
+     */
+    void release()
+    {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
+
+} // namespace chesspp
+
+#endif
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <utility>
+
+#include "time_manager.hpp"
+
+chesspp::TimeManager::TimeManager(TimeSettings settings, ClockFunction clock)
+    : settings(settings), clock(std::move(clock))
+{
+}
+
+chesspp::TimeManager::Clock::time_point chesspp::TimeManager::now() const
+{
+    return clock ? clock() : Clock::now();
+}
+
+chesspp::TimeSettings const &chesspp::TimeManager::get_settings() const
+{
+    return settings;
+}
+
+void chesspp::TimeManager::set_overhead(std::chrono::milliseconds overhead)
+{
+    settings.overhead = overhead;
+}
+
+void chesspp::TimeManager::add_extension(Extension extension)
+{
+    extensions.push_back(std::move(extension));
+}
+
+chesspp::TimeBudget chesspp::TimeManager::budget(
+    SearchLimits const &limits, bool black_to_move, Clock::time_point start) const
+{
+    TimeBudget result;
+    result.start = start;
+
+    int64_t const overhead = settings.overhead.count();
+    int64_t const time = black_to_move ? limits.btime : limits.wtime;
+    int64_t soft = -1;
+    int64_t hard = -1;
+    if (SearchLimits::is_set(time))
+    {
+        int64_t const increment =
+            SearchLimits::is_set(black_to_move ? limits.binc : limits.winc)
+                ? std::max<int64_t>(0, black_to_move ? limits.binc : limits.winc)
+                : 0;
+        int64_t const moves_to_go = std::clamp<int64_t>(
+            SearchLimits::is_set(limits.movestogo) ? limits.movestogo : settings.moves_to_go, 1,
+            std::max<int64_t>(1, settings.max_moves_to_go));
+
+        int64_t const reserve = time - settings.safety_margin.count();
+        int64_t const usable = std::max<int64_t>(0, reserve - overhead);
+        int64_t const share =
+            (reserve + increment * (moves_to_go - 1)) / moves_to_go - overhead;
+        soft = std::clamp<int64_t>(share, 0, usable);
+        hard = std::min<int64_t>(
+            usable, static_cast<int64_t>(static_cast<double>(soft) * settings.hard_ratio));
+        if (moves_to_go > 1)
+        {
+            hard = std::min(hard, usable / 2);
+        }
+        soft = std::min(soft, hard);
+    }
+    if (SearchLimits::is_set(limits.movetime))
+    {
+        int64_t const movetime = std::max<int64_t>(0, limits.movetime - overhead);
+        soft = soft < 0 ? movetime : std::min(soft, movetime);
+        hard = hard < 0 ? movetime : std::min(hard, movetime);
+    }
+
+    if (hard >= 0)
+    {
+        result.soft = start + std::chrono::milliseconds(soft);
+        result.hard = start + std::chrono::milliseconds(hard);
+    }
+    return result;
+}
+
+chesspp::TimeBudget chesspp::TimeManager::allocate(SearchLimits const &limits, bool black_to_move) const
+{
+    return allocate(limits, black_to_move, now());
+}
+
+chesspp::TimeBudget chesspp::TimeManager::allocate(
+    SearchLimits const &limits, bool black_to_move, Clock::time_point start) const
+{
+    if (limits.infinite or limits.ponder)
+    {
+        TimeBudget result;
+        result.start = start;
+        return result;
+    }
+    return budget(limits, black_to_move, start);
+}
+
+chesspp::TimeBudget chesspp::TimeManager::ponderhit(SearchLimits const &limits, bool black_to_move) const
+{
+    if (limits.infinite)
+    {
+        return allocate(limits, black_to_move);
+    }
+    return budget(limits, black_to_move, now());
+}
+
+double chesspp::TimeManager::extension(Iteration const &iteration) const
+{
+    double factor = 1.0;
+    for (Extension const &extension : extensions)
+    {
+        factor *= extension(iteration);
+    }
+    return std::max(0.0, factor);
+}
+
+chesspp::TimeManager::Clock::time_point chesspp::TimeManager::soft_deadline(
+    TimeBudget const &budget, Iteration const &iteration) const
+{
+    if (not budget.is_limited())
+    {
+        return budget.soft;
+    }
+    Clock::duration const base = budget.soft - budget.start;
+    double const scaled = static_cast<double>(base.count()) * extension(iteration);
+    double const limit = static_cast<double>((budget.hard - budget.start).count());
+    return budget.start + Clock::duration(static_cast<Clock::rep>(std::min(scaled, limit)));
+}
+
+bool chesspp::TimeManager::should_stop(TimeBudget const &budget, Iteration const &iteration) const
+{
+    return budget.is_limited() and now() >= soft_deadline(budget, iteration);
+}
+
+bool chesspp::TimeManager::hard_limit_reached(TimeBudget const &budget) const
+{
+    return budget.is_limited() and now() >= budget.hard;
+}
+
+chesspp::TimeManager::Extension chesspp::TimeManager::instability_extension(double per_change)
+{
+    return [per_change](Iteration const &iteration) {
+        return 1.0 + per_change * static_cast<double>(iteration.best_move_changes);
+    };
+}
+
+std::chrono::milliseconds chesspp::TimeManager::measured_overhead(StatsSnapshot const &stats)
+{
+    uint64_t const nanoseconds = stats.dispatch.percentile(0.99) + stats.write.percentile(0.99);
+    return std::chrono::milliseconds(static_cast<int64_t>((nanoseconds + 999999) / 1000000));
+}
@@ -0,0 +1,266 @@
+/**
+ * @file time_manager.hpp
+ * @brief Turns the clock arguments of `go` into deadlines for a search
+ *
+ */
+
+#ifndef SRC_UCI_TIME_MANAGER_H
+#define SRC_UCI_TIME_MANAGER_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "chesspp/inplace_function.hpp"
+#include "chesspp/stats.hpp"
+#include "search_limits.hpp"
+
+namespace chesspp
+{
+/**
+ * @brief How a TimeManager shares out the time on the clock
+ *
+ */
+struct TimeSettings
+{
+    /**
+     * @brief The time lost on every move between the interface's clock and
+     *        the engine, eg. from measured_overhead()
+     *
+     */
+    std::chrono::milliseconds overhead{10};
+
+    /**
+     * @brief The time always left on the clock
+     *
+     */
+    std::chrono::milliseconds safety_margin{50};
+
+    /**
+     * @brief The number of moves the time has to last when `movestogo` is
+     *        not sent
+     *
+     */
+    int64_t moves_to_go = 30;
+
+    /**
+     * @brief The most moves the time is shared between, even if `movestogo`
+     *        is larger
+     *
+     */
+    int64_t max_moves_to_go = 50;
+
+    /**
+     * @brief How many times the soft limit the hard limit may be
+     *
+     */
+    double hard_ratio = 4.0;
+};
+
+/**
+ * @brief The deadlines of one search, on the steady clock. Both are
+ *        `time_point::max()` if the search is not limited by time.
+ *
+ */
+struct TimeBudget
+{
+    /**
+     * @brief When the search started, or `ponderhit` arrived
+     *
+     */
+    std::chrono::steady_clock::time_point start;
+
+    /**
+     * @brief When to stop starting new iterations, before any extension
+     *
+     */
+    std::chrono::steady_clock::time_point soft = std::chrono::steady_clock::time_point::max();
+
+    /**
+     * @brief When `bestmove` must be sent, eg. for
+     *        SearchController::set_deadline()
+     *
+     */
+    std::chrono::steady_clock::time_point hard = std::chrono::steady_clock::time_point::max();
+
+    /**
+     * @brief Check whether the search has a deadline
+     *
+     */
+    bool is_limited() const
+    {
+        return hard != std::chrono::steady_clock::time_point::max();
+    }
+};
+
+/**
+ * @brief What a search knows after finishing an iteration, for extensions
+ *
+ */
+struct Iteration
+{
+    /**
+     * @brief The depth just finished
+     *
+     */
+    int64_t depth = 0;
+
+    /**
+     * @brief The number of times the best move changed during it
+     *
+     */
+    uint64_t best_move_changes = 0;
+
+    /**
+     * @brief How many centipawns the score fell since the iteration before,
+     *        negative if it rose
+     *
+     */
+    int64_t score_drop = 0;
+};
+
+/**
+ * @brief Works out the soft and hard deadlines of a search from its decoded
+ *        `go` arguments.
+ *
+ * The time on the clock, less the safety margin, is shared between the moves
+ * to go, each of which also gets its increment and loses the overhead. The
+ * hard limit is a multiple of that share, but never more than half of what
+ * is left unless this is the last move before the time control. `movetime`
+ * caps both. Searches without a clock or `movetime`, and `go infinite` or
+ * `go ponder`, are not limited. After `ponderhit`, call ponderhit() for the
+ * real budget.
+ *
+ * Extensions scale the soft limit after each iteration, eg. to think longer
+ * while the best move keeps changing. Their factors are multiplied, and the
+ * result is never later than the hard limit.
+ *
+ * The clock is injectable, and everything else is integer arithmetic on its
+ * readings, so games can be simulated faster than real time and give the
+ * same deadlines every run.
+ */
+class TimeManager
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Reads the current time
+     *
+     */
+    using ClockFunction = InplaceFunction<Clock::time_point()>;
+
+    /**
+     * @brief Gives the factor to scale the soft limit by after an iteration,
+     *        1 to leave it alone
+     *
+     */
+    using Extension = InplaceFunction<double(Iteration const &)>;
+
+private:
+    TimeSettings settings;
+    ClockFunction clock;
+    std::vector<Extension> extensions;
+
+    /**
+     * @brief The budget from the clock arguments alone, ignoring `infinite`
+     *        and `ponder`
+     *
+     */
+    TimeBudget budget(SearchLimits const &limits, bool black_to_move, Clock::time_point start) const;
+
+public:
+    /**
+     * @brief Construct a new TimeManager object
+     *
+     * @param settings How to share out the time
+     * @param clock Reads the current time, the steady clock if empty
+     */
+    explicit TimeManager(TimeSettings settings = TimeSettings(), ClockFunction clock = {});
+
+    /**
+     * @brief Get the current time from the clock
+     *
+     */
+    Clock::time_point now() const;
+
+    TimeSettings const &get_settings() const;
+
+    /**
+     * @brief Set the overhead, eg. as measured since the last game
+     *
+     */
+    void set_overhead(std::chrono::milliseconds overhead);
+
+    /**
+     * @brief Adds a factor for the soft limit
+     *
+     */
+    void add_extension(Extension extension);
+
+    /**
+     * @brief Get the deadlines of a search starting now
+     *
+     * @param limits The decoded arguments of `go`
+     * @param black_to_move Whose clock to use
+     */
+    TimeBudget allocate(SearchLimits const &limits, bool black_to_move) const;
+
+    /**
+     * @brief Get the deadlines of a search that started at `start`
+     *
+     */
+    TimeBudget allocate(SearchLimits const &limits, bool black_to_move, Clock::time_point start) const;
+
+    /**
+     * @brief Get the deadlines of a `go ponder` search after `ponderhit`,
+     *        from now
+     *
+     */
+    TimeBudget ponderhit(SearchLimits const &limits, bool black_to_move) const;
+
+    /**
+     * @brief Get the product of the extensions' factors for an iteration
+     *
+     */
+    double extension(Iteration const &iteration) const;
+
+    /**
+     * @brief Get the soft limit after an iteration, with the extensions
+     *        applied
+     *
+     */
+    Clock::time_point soft_deadline(TimeBudget const &budget, Iteration const &iteration) const;
+
+    /**
+     * @brief Check whether the search should not start another iteration
+     *
+     */
+    bool should_stop(TimeBudget const &budget, Iteration const &iteration) const;
+
+    /**
+     * @brief Check whether the hard limit has passed
+     *
+     */
+    bool hard_limit_reached(TimeBudget const &budget) const;
+
+    /**
+     * @brief Get an extension that adds `per_change` to the factor for each
+     *        change of the best move
+     *
+     */
+    static Extension instability_extension(double per_change = 0.5);
+
+    /**
+     * @brief Get the overhead the library itself measured: the 99th
+     *        percentiles from a line arriving to its callback, and from a
+     *        command being written to it leaving, rounded up to a
+     *        millisecond. Zero without CHESSPP_INSTRUMENTATION.
+     *
+     */
+    static std::chrono::milliseconds measured_overhead(StatsSnapshot const &stats);
+};
+
+} // namespace chesspp
+
+#endif
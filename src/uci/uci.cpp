@@ -0,0 +1,157 @@
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "chesspp/uci.hpp"
+#include "command/command_table.hpp"
+#include "command/grammar.hpp"
+#include "engine.hpp"
+#include "io/transport.hpp"
+#include "replay/recorder.hpp"
+
+namespace
+{
+/**
+ * @brief Every standard UCI command, for checking the commands the engine
+ *        issues
+ *
+ */
+chesspp::CommandTable const &standard_commands()
+{
+    static chesspp::CommandTable const table = []() {
+        chesspp::CommandTable commands;
+        for (chesspp::Command command : {
+                 chesspp::grammar::uci.to_command(),
+                 chesspp::grammar::debug.to_command(),
+                 chesspp::grammar::isready.to_command(),
+                 chesspp::grammar::setoption.to_command(),
+                 chesspp::grammar::register_.to_command(),
+                 chesspp::grammar::ucinewgame.to_command(),
+                 chesspp::grammar::position.to_command(),
+                 chesspp::grammar::go.to_command(),
+                 chesspp::grammar::stop.to_command(),
+                 chesspp::grammar::ponderhit.to_command(),
+                 chesspp::grammar::quit.to_command(),
+                 chesspp::grammar::id.to_command(),
+                 chesspp::grammar::uciok.to_command(),
+                 chesspp::grammar::readyok.to_command(),
+                 chesspp::grammar::bestmove.to_command(),
+                 chesspp::grammar::copyprotection.to_command(),
+                 chesspp::grammar::registration.to_command(),
+                 chesspp::grammar::info.to_command(),
+                 chesspp::grammar::option.to_command(),
+             })
+        {
+            commands.add(std::move(command));
+        }
+        return commands;
+    }();
+    return table;
+}
+} // namespace
+
+chesspp::UCI::UCI(int input_fd) : engine(std::make_unique<Engine>(input_fd))
+{
+}
+
+chesspp::UCI::UCI(int input_fd, OutputWriter &output)
+    : engine(std::make_unique<Engine>(input_fd, output))
+{
+}
+
+chesspp::UCI::UCI(Transport &transport)
+    : engine(std::make_unique<Engine>(transport.input(), transport.output()))
+{
+}
+
+/**
+ * @brief A recorder and the file it writes to
+ *
+ */
+struct chesspp::UCI::Recording
+{
+    int fd;
+    FdSink sink;
+    Recorder recorder;
+
+    explicit Recording(int fd) : fd(fd), sink(fd), recorder(sink)
+    {
+    }
+
+    ~Recording()
+    {
+        recorder.flush();
+        close(fd);
+    }
+};
+
+chesspp::UCI::~UCI()
+{
+    if (recording)
+    {
+        engine->set_recorder(nullptr);
+    }
+}
+
+bool chesspp::UCI::record_to(std::string const &path)
+{
+    int const fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1)
+    {
+        return false;
+    }
+    if (recording)
+    {
+        engine->set_recorder(nullptr);
+    }
+    recording = std::make_unique<Recording>(fd);
+    engine->set_recorder(&recording->recorder);
+    return true;
+}
+
+bool chesspp::UCI::register_command(std::string_view name, CommandCallback callback)
+{
+    return engine->register_command(name, std::move(callback));
+}
+
+bool chesspp::UCI::register_command(
+    std::string_view name, void (*callback)(std::vector<Argument>))
+{
+    return engine->register_command(name, callback);
+}
+
+bool chesspp::UCI::issue_command(
+    std::string_view name, std::vector<std::string> const &arguments)
+{
+    Command const *command = standard_commands().find(name);
+    if (command == nullptr)
+    {
+        return false;
+    }
+
+    std::vector<std::string_view> const tokens(arguments.begin(), arguments.end());
+    std::vector<ArgumentView> views;
+    if (not command->try_parse_arguments(tokens, views))
+    {
+        return false;
+    }
+
+    engine->get_output().write(command->get_name(), arguments);
+    return true;
+}
+
+chesspp::StatsSnapshot chesspp::UCI::get_stats() const
+{
+    return engine->get_stats();
+}
+
+bool chesspp::UCI::start(std::string_view mode)
+{
+    if (mode != "engine")
+    {
+        return false;
+    }
+    engine->start();
+    return true;
+}
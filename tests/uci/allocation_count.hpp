@@ -0,0 +1,22 @@
+/**
+ * @file allocation_count.hpp
+ * @brief Counts the heap allocations made by the test program. operator new
+ *        is replaced in test_arena.cpp.
+ *
+ */
+
+#ifndef TESTS_UCI_ALLOCATION_COUNT_H
+#define TESTS_UCI_ALLOCATION_COUNT_H
+
+#include <cstddef>
+
+namespace test_support
+{
+/**
+ * @brief Get the number of times operator new has been called so far
+ *
+ */
+size_t allocation_count();
+} // namespace test_support
+
+#endif
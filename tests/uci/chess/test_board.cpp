@@ -0,0 +1,61 @@
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "uci/chess/board.hpp"
+
+TEST(Board, parse_fen_test_start_position)
+{
+    chesspp::Board const board = chesspp::Board::start_position();
+    EXPECT_EQ(chesspp::piece::rook, board.squares[chesspp::make_square(0, 0)]);
+    EXPECT_EQ(chesspp::piece::king, board.squares[chesspp::make_square(4, 0)]);
+    EXPECT_EQ(chesspp::piece::pawn, board.squares[chesspp::make_square(3, 1)]);
+    EXPECT_EQ(chesspp::piece::none, board.squares[chesspp::make_square(3, 4)]);
+    EXPECT_EQ(chesspp::piece::queen | chesspp::piece::black, board.squares[chesspp::make_square(3, 7)]);
+    EXPECT_FALSE(board.black_to_move);
+    EXPECT_EQ(15, board.castling);
+    EXPECT_EQ(chesspp::Board::no_square, board.en_passant);
+    EXPECT_EQ(0, board.halfmove_clock);
+    EXPECT_EQ(1, board.fullmove_number);
+}
+
+TEST(Board, parse_fen_test_fields)
+{
+    chesspp::Board board;
+    ASSERT_TRUE(chesspp::parse_fen(
+        "rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w Kq c6 0 2", board));
+    EXPECT_EQ(chesspp::piece::pawn | chesspp::piece::black, board.squares[chesspp::make_square(2, 4)]);
+    EXPECT_EQ(chesspp::piece::pawn, board.squares[chesspp::make_square(4, 3)]);
+    EXPECT_EQ(chesspp::castling::white_king | chesspp::castling::black_queen, board.castling);
+    EXPECT_EQ(chesspp::make_square(2, 5), board.en_passant);
+    EXPECT_EQ(2, board.fullmove_number);
+
+    // The move counters are optional
+    ASSERT_TRUE(chesspp::parse_fen("8/8/8/4k3/8/8/8/4K3 b - -", board));
+    EXPECT_TRUE(board.black_to_move);
+    EXPECT_EQ(0, board.castling);
+    EXPECT_EQ(1, board.fullmove_number);
+    EXPECT_EQ(chesspp::piece::king | chesspp::piece::black, board.squares[chesspp::make_square(4, 4)]);
+}
+
+TEST(Board, parse_fen_test_invalid)
+{
+    chesspp::Board board = chesspp::Board::start_position();
+    for (std::string_view const fen : {
+             "",
+             "8/8/8/8/8/8/8 w - - 0 1",
+             "8/8/8/8/8/8/8/8/8 w - - 0 1",
+             "9/8/8/8/8/8/8/8 w - - 0 1",
+             "7/8/8/8/8/8/8/8 w - - 0 1",
+             "ppppppppp/8/8/8/8/8/8/8 w - - 0 1",
+             "8/8/8/8/8/8/8/7x w - - 0 1",
+             "8/8/8/8/8/8/8/8 x - - 0 1",
+             "8/8/8/8/8/8/8/8 w KX - 0 1",
+             "8/8/8/8/8/8/8/8 w - e4 0 1",
+             "8/8/8/8/8/8/8/8 w - - a 1",
+             "8/8/8/8/8/8/8/8 w - - 0",
+             "8/8/8/8/8/8/8/8 w - - 0 1 1"})
+    {
+        EXPECT_FALSE(chesspp::parse_fen(fen, board)) << fen;
+    }
+    EXPECT_EQ(chesspp::Board::start_position().squares, board.squares);
+}
@@ -0,0 +1,103 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "uci/chess/decode.hpp"
+#include "uci/command/grammar.hpp"
+#include "uci/parser.hpp"
+
+namespace
+{
+template <auto const &Grammar>
+std::vector<chesspp::ArgumentView> &parse(
+    std::string const &line,
+    std::vector<std::string_view> &tokens,
+    std::vector<chesspp::ArgumentView> &arguments)
+{
+    chesspp::Parser::tokenise(line, tokens);
+    return chesspp::StaticCommand<Grammar>::parse_arguments(tokens, arguments);
+}
+} // namespace
+
+TEST(Decode, decode_position_test_startpos)
+{
+    std::vector<std::string_view> tokens;
+    std::vector<chesspp::ArgumentView> arguments;
+    std::string const line = "startpos moves e2e4 e7e5 e1g1 0000";
+    parse<chesspp::grammar::position>(line, tokens, arguments);
+
+    chesspp::Board board;
+    std::vector<chesspp::Move> moves;
+    ASSERT_TRUE(chesspp::decode_position(arguments, board, moves));
+    EXPECT_EQ(chesspp::Board::start_position().squares, board.squares);
+    ASSERT_EQ(4, moves.size());
+    EXPECT_EQ("e7e5", moves[1].to_uci());
+    EXPECT_TRUE(moves[3].is_null());
+}
+
+TEST(Decode, decode_position_test_fen)
+{
+    std::vector<std::string_view> tokens;
+    std::vector<chesspp::ArgumentView> arguments;
+    std::string const line = "fen 8/P7/8/8/8/8/8/k6K w - - 0 60 moves a7a8q";
+    parse<chesspp::grammar::position>(line, tokens, arguments);
+
+    chesspp::Board board;
+    std::vector<chesspp::Move> moves;
+    ASSERT_TRUE(chesspp::decode_position(arguments, board, moves));
+    EXPECT_EQ(60, board.fullmove_number);
+    ASSERT_EQ(1, moves.size());
+    EXPECT_EQ(chesspp::Promotion::queen, moves[0].promotion());
+}
+
+TEST(Decode, decode_position_test_invalid_move)
+{
+    std::vector<std::string_view> tokens;
+    std::vector<chesspp::ArgumentView> arguments;
+    std::string const line = "startpos moves e2e4 e7e9";
+    parse<chesspp::grammar::position>(line, tokens, arguments);
+
+    chesspp::Board board;
+    std::vector<chesspp::Move> moves;
+    EXPECT_FALSE(chesspp::decode_position(arguments, board, moves));
+    EXPECT_TRUE(moves.empty());
+}
+
+TEST(Decode, decode_position_test_delta_keeps_board)
+{
+    std::vector<std::string_view> const tokens = {"g1f3"};
+    chesspp::PositionDelta delta;
+    delta.reset = false;
+    delta.moves = tokens;
+
+    chesspp::Board board;
+    board.fullmove_number = 40;
+    std::vector<chesspp::Move> moves;
+    ASSERT_TRUE(chesspp::decode_position(delta, board, moves));
+    EXPECT_EQ(40, board.fullmove_number);
+    EXPECT_EQ(1, moves.size());
+}
+
+TEST(Decode, decode_bestmove_test)
+{
+    std::vector<std::string_view> tokens;
+    std::vector<chesspp::ArgumentView> arguments;
+    chesspp::BestMove best;
+
+    std::string line = "e2e4 ponder e7e5";
+    parse<chesspp::grammar::bestmove>(line, tokens, arguments);
+    ASSERT_TRUE(chesspp::decode_bestmove(arguments, best));
+    EXPECT_EQ("e2e4", best.move.to_uci());
+    EXPECT_EQ("e7e5", best.ponder.to_uci());
+
+    line = "0000";
+    parse<chesspp::grammar::bestmove>(line, tokens, arguments);
+    ASSERT_TRUE(chesspp::decode_bestmove(arguments, best));
+    EXPECT_TRUE(best.move.is_null());
+    EXPECT_TRUE(best.ponder.is_null());
+
+    line = "e2e4 ponder xx";
+    parse<chesspp::grammar::bestmove>(line, tokens, arguments);
+    EXPECT_FALSE(chesspp::decode_bestmove(arguments, best));
+}
@@ -0,0 +1,80 @@
+#include <string>
+
+#include "gtest/gtest.h"
+#include "uci/chess/move.hpp"
+
+// Decoding works at compile time
+static_assert([] {
+    chesspp::Move move;
+    return chesspp::Move::from_uci("e2e4", move) and move.from() == 12 and move.to() == 28;
+}());
+
+TEST(Move, from_uci_test_squares)
+{
+    chesspp::Move move;
+    ASSERT_TRUE(chesspp::Move::from_uci("a1h8", move));
+    EXPECT_EQ(0, move.from());
+    EXPECT_EQ(63, move.to());
+    EXPECT_EQ(chesspp::Promotion::none, move.promotion());
+    EXPECT_FALSE(move.is_null());
+
+    ASSERT_TRUE(chesspp::Move::from_uci("g1f3", move));
+    EXPECT_EQ(chesspp::make_square(6, 0), move.from());
+    EXPECT_EQ(chesspp::make_square(5, 2), move.to());
+}
+
+TEST(Move, from_uci_test_promotion)
+{
+    chesspp::Move move;
+    ASSERT_TRUE(chesspp::Move::from_uci("e7e8q", move));
+    EXPECT_EQ(chesspp::Promotion::queen, move.promotion());
+    ASSERT_TRUE(chesspp::Move::from_uci("b2a1n", move));
+    EXPECT_EQ(chesspp::Promotion::knight, move.promotion());
+    EXPECT_EQ(chesspp::make_square(0, 0), move.to());
+}
+
+TEST(Move, from_uci_test_null_move)
+{
+    chesspp::Move move(12, 28);
+    ASSERT_TRUE(chesspp::Move::from_uci("0000", move));
+    EXPECT_TRUE(move.is_null());
+    EXPECT_EQ(chesspp::Move(), move);
+    EXPECT_EQ("0000", move.to_uci());
+}
+
+TEST(Move, from_uci_test_invalid)
+{
+    chesspp::Move move(12, 28);
+    for (char const *text : {"", "e2e", "e2e4qq", "i2e4", "e9e4", "e0e4", "E2E4",
+                             "e7e8k", "e7e8Q", "e2e4 ", "000", "00000", "a1`1"})
+    {
+        EXPECT_FALSE(chesspp::Move::from_uci(text, move)) << text;
+    }
+    EXPECT_EQ(chesspp::Move(12, 28), move);
+}
+
+TEST(Move, to_uci_test_round_trip)
+{
+    char const promotions[] = {'n', 'b', 'r', 'q'};
+    for (char from_file = 'a'; from_file <= 'h'; from_file++)
+    {
+        for (char to_rank = '1'; to_rank <= '8'; to_rank++)
+        {
+            std::string text = {from_file, '7', 'h', to_rank};
+            chesspp::Move move;
+            ASSERT_TRUE(chesspp::Move::from_uci(text, move));
+            EXPECT_EQ(text, move.to_uci());
+
+            text.push_back(promotions[to_rank % 4]);
+            ASSERT_TRUE(chesspp::Move::from_uci(text, move));
+            EXPECT_EQ(text, move.to_uci());
+        }
+    }
+}
+
+TEST(Move, raw_test_fits_16_bits)
+{
+    EXPECT_EQ(2, sizeof(chesspp::Move));
+    chesspp::Move const move(63, 63, chesspp::Promotion::queen);
+    EXPECT_EQ(63 | (63 << 6) | (4 << 12), move.raw());
+}
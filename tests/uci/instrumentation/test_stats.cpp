@@ -0,0 +1,192 @@
+#include <cstdint>
+#include <string>
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "chesspp/stats.hpp"
+#include "uci/engine.hpp"
+#include "uci/instrumentation/probes.hpp"
+#include "uci/instrumentation/report.hpp"
+
+/*******************************************************************************
+ *                          Test the histogram layout
+*******************************************************************************/
+
+static_assert(chesspp::histogram::bucket(0) == 0);
+static_assert(chesspp::histogram::bucket(7) == 7);
+static_assert(chesspp::histogram::bucket(8) == 8);
+static_assert(chesspp::histogram::bucket(16) == 16);
+static_assert(chesspp::histogram::bucket(17) == 16);
+static_assert(chesspp::histogram::bucket(UINT64_MAX) == chesspp::histogram::num_buckets - 1);
+static_assert(chesspp::histogram::lower_bound(16) == 16);
+static_assert(chesspp::histogram::upper_bound(16) == 17);
+
+TEST(Histogram, bucket_test_bounds_contain_value)
+{
+    for (uint64_t value = 0; value < 100000; value += 1 + value / 64)
+    {
+        size_t const bucket = chesspp::histogram::bucket(value);
+        EXPECT_LE(chesspp::histogram::lower_bound(bucket), value);
+        EXPECT_GE(chesspp::histogram::upper_bound(bucket), value);
+    }
+    for (unsigned shift = 3; shift < 64; shift++)
+    {
+        uint64_t const value = (uint64_t(1) << shift) + 1;
+        size_t const bucket = chesspp::histogram::bucket(value);
+        EXPECT_LE(chesspp::histogram::lower_bound(bucket), value);
+        EXPECT_GE(chesspp::histogram::upper_bound(bucket), value);
+        // Buckets are at most 1/8th of their value wide
+        EXPECT_LE(chesspp::histogram::upper_bound(bucket) - chesspp::histogram::lower_bound(bucket),
+                  value / 8);
+    }
+}
+
+TEST(Histogram, percentile_test)
+{
+    chesspp::HistogramSnapshot snapshot;
+    EXPECT_EQ(0, snapshot.percentile(0.5));
+
+    // 90 values of 1000ns and 10 of 50000ns
+    snapshot.counts[chesspp::histogram::bucket(1000)] = 90;
+    snapshot.counts[chesspp::histogram::bucket(50000)] = 10;
+    snapshot.count = 100;
+    snapshot.sum = 90 * 1000 + 10 * 50000;
+    snapshot.max = 50000;
+
+    EXPECT_GE(snapshot.percentile(0.5), 1000);
+    EXPECT_LE(snapshot.percentile(0.5), 1000 + 1000 / 8);
+    EXPECT_EQ(50000, snapshot.percentile(0.99));
+    EXPECT_EQ(5900, snapshot.mean());
+}
+
+/*******************************************************************************
+ *                          Test the live statistics
+*******************************************************************************/
+
+namespace
+{
+/**
+ * @brief Runs an engine on `text` and returns it for inspection
+ *
+ */
+void run_engine(std::string const &text, chesspp::Engine &engine, int fds[2])
+{
+    EXPECT_EQ(text.size(), write(fds[1], text.data(), text.size()));
+    close(fds[1]);
+    engine.start();
+    close(fds[0]);
+}
+} // namespace
+
+#if CHESSPP_INSTRUMENTATION
+
+TEST(Stats, histogram_test_record)
+{
+    chesspp::instrumentation::LatencyHistogram histogram;
+    histogram.record(100);
+    histogram.record(100);
+    histogram.record(3000);
+
+    chesspp::HistogramSnapshot snapshot;
+    histogram.snapshot(snapshot);
+    EXPECT_EQ(3, snapshot.count);
+    EXPECT_EQ(3200, snapshot.sum);
+    EXPECT_EQ(3000, snapshot.max);
+    EXPECT_EQ(2, snapshot.counts[chesspp::histogram::bucket(100)]);
+}
+
+TEST(Stats, get_stats_test_counts_commands)
+{
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::Engine engine(fds[0], output);
+    engine.register_command("isready", [&output](chesspp::ArgumentSpan) {
+        output.write("readyok", chesspp::TokenSpan());
+    });
+
+    std::string const text = "isready\ngo depth 3\nnonsense\nisready\n";
+    run_engine(text, engine, fds);
+
+    chesspp::StatsSnapshot const stats = engine.get_stats();
+    EXPECT_EQ(text.size(), stats.bytes_in);
+    EXPECT_EQ(std::string("readyok\nreadyok\n").size(), stats.bytes_out);
+    EXPECT_EQ(3, stats.parse.count);
+    EXPECT_EQ(3, stats.dispatch.count);
+    EXPECT_EQ(2, stats.write.count);
+
+    ASSERT_EQ(2, stats.commands_in.size());
+    EXPECT_EQ("isready", stats.commands_in[0].name);
+    EXPECT_EQ(2, stats.commands_in[0].count);
+    EXPECT_EQ("go", stats.commands_in[1].name);
+    EXPECT_EQ(1, stats.commands_in[1].count);
+
+    ASSERT_EQ(1, stats.commands_out.size());
+    EXPECT_EQ("readyok", stats.commands_out[0].name);
+    EXPECT_EQ(2, stats.commands_out[0].count);
+}
+
+TEST(Stats, stats_command_test_only_in_debug_mode)
+{
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::Engine engine(fds[0], output);
+
+    run_engine("stats\ndebug on\nisready\nstats\ndebug off\nstats\n", engine, fds);
+    output.flush();
+
+    EXPECT_EQ(0, sink.data.find("info string stats bytes in "));
+    // The reader thread counts commands as it parses them, so how many it has
+    // counted by the time `stats` runs depends on how far ahead it is
+    EXPECT_NE(std::string::npos, sink.data.find(" commands in debug="));
+    EXPECT_NE(std::string::npos, sink.data.find(" isready=1 other="));
+    EXPECT_EQ(sink.data.find('\n'), sink.data.size() - 1);
+}
+
+#else
+
+TEST(Stats, get_stats_test_disabled)
+{
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::Engine engine(fds[0], output);
+    EXPECT_FALSE(engine.register_command("stats", [](chesspp::ArgumentSpan) {}));
+
+    run_engine("isready\ngo depth 3\n", engine, fds);
+
+    chesspp::StatsSnapshot const stats = engine.get_stats();
+    EXPECT_EQ(0, stats.bytes_in);
+    EXPECT_EQ(0, stats.parse.count);
+    EXPECT_EQ(0, stats.dispatch.count);
+    EXPECT_TRUE(stats.commands_in.empty());
+}
+
+#endif
+
+TEST(Stats, write_stats_test)
+{
+    chesspp::StatsSnapshot stats;
+    stats.bytes_in = 120;
+    stats.bytes_out = 3400;
+    stats.commands_in = {{"go", 2}};
+    stats.commands_out = {{"bestmove", 2}, {"info", 30}};
+
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::write_stats(output, stats);
+    output.flush();
+
+    EXPECT_EQ(
+        "info string stats bytes in 120 out 3400"
+        " parse n=0 p50=0ns p99=0ns max=0ns"
+        " dispatch n=0 p50=0ns p99=0ns max=0ns"
+        " write n=0 p50=0ns p99=0ns max=0ns"
+        " commands in go=2 out bestmove=2 info=30\n",
+        sink.data);
+}
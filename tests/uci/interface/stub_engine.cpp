@@ -0,0 +1,53 @@
+/**
+ * @file stub_engine.cpp
+ * @brief A UCI engine that answers instantly, for testing the interface side.
+ *        It answers `go` with one info line and a bestmove that repeats the
+ *        last token of the current position (the last move, or the fullmove
+ *        number of a FEN), so a test can tell which position an answer
+ *        belongs to. Talks over a shared memory channel if given
+ *        `--uci-shm`.
+ *
+ */
+
+#include <memory>
+#include <string>
+
+#include "chesspp/uci.hpp"
+#include "uci/io/transport.hpp"
+
+int main(int argc, char **argv)
+{
+    std::unique_ptr<chesspp::Transport> const transport = chesspp::open_transport(argc, argv);
+    if (transport == nullptr)
+    {
+        return 1;
+    }
+    chesspp::UCI uci(*transport);
+    std::string last_token = "0000";
+
+    uci.register_command("uci", [&uci](chesspp::ArgumentSpan) {
+        uci.issue_command("id", {"name", "Stub"});
+        uci.issue_command("id", {"author", "Chess++"});
+        uci.issue_command("uciok", {});
+    });
+    uci.register_command("isready", [&uci](chesspp::ArgumentSpan) {
+        uci.issue_command("readyok", {});
+    });
+    uci.register_command("position", [&last_token](chesspp::ArgumentSpan arguments) {
+        last_token = "0000";
+        for (chesspp::ArgumentView const &argument : arguments)
+        {
+            if (not argument.parameters.empty())
+            {
+                last_token = std::string(argument.parameters[argument.parameters.size() - 1]);
+            }
+        }
+    });
+    uci.register_command("go", [&uci, &last_token](chesspp::ArgumentSpan) {
+        uci.issue_command("info", {"depth", "1", "score", "cp", "17", "nodes", "1", "pv", last_token});
+        uci.issue_command("bestmove", {last_token});
+    });
+
+    uci.start();
+    return 0;
+}
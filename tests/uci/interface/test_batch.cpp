@@ -0,0 +1,139 @@
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "uci/interface/batch.hpp"
+
+namespace
+{
+/**
+ * @brief A suite of positions whose fullmove numbers are 1 to `count`. The
+ *        stub engine answers with the fullmove number.
+ *
+ */
+std::string make_suite(int count)
+{
+    std::string suite;
+    for (int i = 1; i <= count; i++)
+    {
+        suite += "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 " + std::to_string(i) + "\n";
+    }
+    return suite;
+}
+
+/**
+ * @brief Runs a batch and checks that every answer is for its own position
+ *
+ * @return std::vector<int> How many times each position was reported
+ */
+std::vector<int> run_batch(chesspp::Batch &batch, std::string const &suite, int count, bool &finished)
+{
+    std::vector<int> seen(count + 1);
+    chesspp::EpdReader reader(suite);
+    finished = batch.run(reader, [&seen](chesspp::BatchResult const &result) {
+        EXPECT_EQ(result.position->fields[5], result.bestmove);
+        EXPECT_EQ("cp 17", result.score);
+        EXPECT_EQ(1, result.depth);
+        seen[std::stoi(std::string(result.bestmove))]++;
+    });
+    return seen;
+}
+} // namespace
+
+TEST(Batch, run_test_analyses_every_position_once)
+{
+    constexpr int count = 500;
+    for (size_t pipeline_depth : {1, 3})
+    {
+        chesspp::BatchOptions options;
+        options.engines.assign(3, CHESSPP_STUB_ENGINE);
+        options.go_arguments = {"depth", "1"};
+        options.pipeline_depth = pipeline_depth;
+        chesspp::Batch batch(options);
+
+        std::string const suite = make_suite(count);
+        bool finished = false;
+        std::vector<int> const seen = run_batch(batch, suite, count, finished);
+
+        EXPECT_TRUE(finished);
+        for (int i = 1; i <= count; i++)
+        {
+            EXPECT_EQ(1, seen[i]) << "position " << i;
+        }
+
+        chesspp::BatchReport const &report = batch.get_report();
+        EXPECT_EQ(count, report.positions);
+        EXPECT_EQ(0, report.unanalysed);
+        ASSERT_EQ(3, report.engines.size());
+        uint64_t total = 0;
+        for (size_t i = 0; i < report.engines.size(); i++)
+        {
+            total += report.engines[i].positions;
+            EXPECT_GT(report.engines[i].positions, 0);
+            EXPECT_LE(report.utilisation(i), 1.0);
+        }
+        EXPECT_EQ(count, total);
+        EXPECT_GT(report.positions_per_second(), 0);
+    }
+}
+
+TEST(Batch, run_test_survives_engines_exiting)
+{
+    constexpr int count = 50;
+    chesspp::BatchOptions options;
+    // The last engine dies on its first search, which goes back to the pool
+    options.engines = {
+        "exit 0",
+        CHESSPP_STUB_ENGINE,
+        "while read line; do case $line in uci) echo uciok;; isready) echo readyok;; go*) exit 0;; esac; done"};
+    options.go_arguments = {"depth", "1"};
+    chesspp::Batch batch(options);
+
+    std::string const suite = make_suite(count);
+    bool finished = false;
+    std::vector<int> const seen = run_batch(batch, suite, count, finished);
+
+    EXPECT_TRUE(finished);
+    for (int i = 1; i <= count; i++)
+    {
+        EXPECT_EQ(1, seen[i]) << "position " << i;
+    }
+    EXPECT_EQ(count, batch.get_report().engines[1].positions);
+}
+
+TEST(Batch, run_test_without_engines)
+{
+    constexpr int count = 10;
+    chesspp::BatchOptions options;
+    options.engines = {"exit 0"};
+    chesspp::Batch batch(options);
+
+    std::string const suite = make_suite(count);
+    bool finished = true;
+    std::vector<int> const seen = run_batch(batch, suite, count, finished);
+
+    EXPECT_FALSE(finished);
+    EXPECT_EQ(0, batch.get_report().positions);
+    EXPECT_EQ(count, batch.get_report().unanalysed);
+}
+
+TEST(Batch, append_result_test)
+{
+    chesspp::EpdPosition position;
+    position.fields = {"8/8/8/8/8/8/8/K6k", "w", "-", "-", "0", "1"};
+    position.line = 7;
+
+    chesspp::BatchResult result;
+    result.position = &position;
+    result.bestmove = "a1b1";
+    result.score = "mate 3";
+    result.depth = 12;
+
+    std::string buffer;
+    chesspp::append_result(buffer, result);
+    position.id = "endgame";
+    chesspp::append_result(buffer, result);
+    EXPECT_EQ("7\t8/8/8/8/8/8/8/K6k w - - 0 1\ta1b1\tmate 3\t12\n"
+              "endgame\t8/8/8/8/8/8/8/K6k w - - 0 1\ta1b1\tmate 3\t12\n",
+              buffer);
+}
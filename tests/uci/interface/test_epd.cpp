@@ -0,0 +1,49 @@
+#include "gtest/gtest.h"
+#include "uci/interface/epd.hpp"
+
+TEST(EpdReader, next_test_fen_and_epd)
+{
+    chesspp::EpdReader reader(
+        "# A comment\n"
+        "\n"
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1\n"
+        "2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - bm Qg6; id \"WAC.001\";\r\n"
+        "not a position\n"
+        "8/8/8/8/8/8/8/K6k b - - hmvc 12; fmvn 40; id \"semi;colon\"");
+    chesspp::EpdPosition position;
+
+    ASSERT_TRUE(reader.next(position));
+    EXPECT_EQ("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR", position.fields[0]);
+    EXPECT_EQ("w", position.fields[1]);
+    EXPECT_EQ("KQkq", position.fields[2]);
+    EXPECT_EQ("-", position.fields[3]);
+    EXPECT_EQ("0", position.fields[4]);
+    EXPECT_EQ("1", position.fields[5]);
+    EXPECT_EQ("", position.id);
+    EXPECT_EQ(3, position.line);
+
+    ASSERT_TRUE(reader.next(position));
+    EXPECT_EQ("2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1", position.fields[0]);
+    EXPECT_EQ("0", position.fields[4]);
+    EXPECT_EQ("1", position.fields[5]);
+    EXPECT_EQ("WAC.001", position.id);
+    EXPECT_EQ(4, position.line);
+
+    ASSERT_TRUE(reader.next(position));
+    EXPECT_EQ("b", position.fields[1]);
+    EXPECT_EQ("12", position.fields[4]);
+    EXPECT_EQ("40", position.fields[5]);
+    EXPECT_EQ("semi;colon", position.id);
+    EXPECT_EQ(6, position.line);
+
+    EXPECT_FALSE(reader.next(position));
+    EXPECT_EQ(1, reader.get_malformed());
+}
+
+TEST(EpdReader, next_test_empty)
+{
+    chesspp::EpdReader reader("");
+    chesspp::EpdPosition position;
+    EXPECT_FALSE(reader.next(position));
+    EXPECT_EQ(0, reader.get_malformed());
+}
@@ -0,0 +1,186 @@
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "uci/interface/multiplexer.hpp"
+
+namespace
+{
+/**
+ * @brief A move that is different for every session up to 4096
+ *
+ */
+std::string session_move(int session)
+{
+    int const from = session % 64;
+    int const to = session / 64 % 64;
+    return {static_cast<char>('a' + from % 8), static_cast<char>('1' + from / 8),
+            static_cast<char>('a' + to % 8), static_cast<char>('1' + to / 8)};
+}
+
+/**
+ * @brief What a test has seen from each session
+ *
+ */
+struct SessionState
+{
+    int uciok = 0;
+    int readyok = 0;
+    int infos = 0;
+    int bestmoves = 0;
+    int wrong_bestmoves = 0;
+    bool closed = false;
+};
+
+/**
+ * @brief Runs `searches` searches on each of `engines` stub engines, then
+ *        quits them
+ *
+ */
+void run_searches(chesspp::Multiplexer &multiplexer, std::vector<SessionState> &states, int searches)
+{
+    for (size_t i = 0; i < states.size(); i++)
+    {
+        int const session = multiplexer.add_engine(CHESSPP_STUB_ENGINE);
+        ASSERT_EQ(static_cast<int>(i), session);
+        EXPECT_TRUE(multiplexer.send(session, "uci"));
+        EXPECT_TRUE(multiplexer.send(session, "isready"));
+    }
+
+    auto const search = [&multiplexer](int session) {
+        multiplexer.send(session, "position", {"startpos", "moves", "e2e4", session_move(session)});
+        multiplexer.send(session, "go", {"depth", "1"});
+    };
+    multiplexer.register_command("uciok", [&states](int session, chesspp::ArgumentSpan) {
+        states[session].uciok++;
+    });
+    multiplexer.register_command("readyok", [&states, &search](int session, chesspp::ArgumentSpan) {
+        states[session].readyok++;
+        search(session);
+    });
+    multiplexer.register_command("info", [&states](int session, chesspp::ArgumentSpan) {
+        states[session].infos++;
+    });
+    multiplexer.register_command(
+        "bestmove", [&states, &search, &multiplexer, searches](int session, chesspp::ArgumentSpan arguments) {
+            SessionState &state = states[session];
+            state.bestmoves++;
+            if (arguments[0].value != session_move(session))
+            {
+                state.wrong_bestmoves++;
+            }
+            if (state.bestmoves < searches)
+            {
+                search(session);
+            }
+            else
+            {
+                multiplexer.send(session, "quit");
+            }
+        });
+    multiplexer.register_close_callback([&states](int session) { states[session].closed = true; });
+
+    multiplexer.run();
+}
+} // namespace
+
+TEST(Multiplexer, send_test_checks_grammar)
+{
+    chesspp::Multiplexer multiplexer;
+    EXPECT_FALSE(multiplexer.send(0, "isready"));
+
+    int const session = multiplexer.add_engine("exec cat");
+    ASSERT_EQ(0, session);
+    EXPECT_TRUE(multiplexer.is_open(session));
+    EXPECT_TRUE(multiplexer.send(session, "go", {"depth", "3"}));
+    EXPECT_TRUE(multiplexer.send(session, "debug", {"on"}));
+    EXPECT_FALSE(multiplexer.send(session, "debug", {"maybe"}));
+    EXPECT_FALSE(multiplexer.send(session, "bestmove", {"e2e4"}));
+    EXPECT_FALSE(multiplexer.send(session, "joho"));
+    EXPECT_FALSE(multiplexer.send(1, "isready"));
+
+    EXPECT_TRUE(multiplexer.register_command("bestmove", [](int, chesspp::ArgumentSpan) {}));
+    EXPECT_FALSE(multiplexer.register_command("go", [](int, chesspp::ArgumentSpan) {}));
+}
+
+TEST(Multiplexer, stop_test_from_another_thread)
+{
+    chesspp::Multiplexer multiplexer;
+    ASSERT_EQ(0, multiplexer.add_engine("exec cat"));
+
+    std::thread stopper([&multiplexer]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        multiplexer.stop();
+    });
+    multiplexer.run();
+    stopper.join();
+
+    EXPECT_TRUE(multiplexer.is_open(0));
+}
+
+TEST(Multiplexer, run_test_joins_split_lines)
+{
+    chesspp::Multiplexer multiplexer;
+    ASSERT_EQ(0, multiplexer.add_engine(
+                     "printf 'bestm'; sleep 0.05; printf 'ove e2e4\\r\\nnonsense\\ninfo depth 2\\n'"));
+
+    std::vector<std::string> received;
+    multiplexer.register_command("bestmove", [&received](int, chesspp::ArgumentSpan arguments) {
+        received.push_back("bestmove " + std::string(arguments[0].value));
+    });
+    multiplexer.register_command("info", [&received](int, chesspp::ArgumentSpan arguments) {
+        received.push_back("info " + std::string(arguments[0].parameters[0]));
+    });
+    bool closed = false;
+    multiplexer.register_close_callback([&closed](int) { closed = true; });
+
+    multiplexer.run();
+
+    EXPECT_EQ((std::vector<std::string>{"bestmove e2e4", "info 2"}), received);
+    EXPECT_TRUE(closed);
+    EXPECT_FALSE(multiplexer.is_open(0));
+    EXPECT_EQ(-1, multiplexer.get_pid(0));
+}
+
+TEST(Multiplexer, run_test_routes_answers_to_sessions)
+{
+    chesspp::Multiplexer multiplexer;
+    std::vector<SessionState> states(8);
+    run_searches(multiplexer, states, 5);
+
+    for (SessionState const &state : states)
+    {
+        EXPECT_EQ(1, state.uciok);
+        EXPECT_EQ(1, state.readyok);
+        EXPECT_EQ(5, state.infos);
+        EXPECT_EQ(5, state.bestmoves);
+        EXPECT_EQ(0, state.wrong_bestmoves);
+        EXPECT_TRUE(state.closed);
+    }
+}
+
+TEST(Multiplexer, run_test_throughput)
+{
+    // Hundreds of engines on the one thread
+    constexpr int engines = 200;
+    constexpr int searches = 25;
+
+    chesspp::Multiplexer multiplexer;
+    std::vector<SessionState> states(engines);
+    auto const start = std::chrono::steady_clock::now();
+    run_searches(multiplexer, states, searches);
+    double const seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int total = 0;
+    for (SessionState const &state : states)
+    {
+        EXPECT_EQ(searches, state.bestmoves);
+        EXPECT_EQ(0, state.wrong_bestmoves);
+        EXPECT_TRUE(state.closed);
+        total += state.bestmoves;
+    }
+    RecordProperty("searches_per_second", static_cast<int>(total / seconds));
+}
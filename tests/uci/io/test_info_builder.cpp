@@ -0,0 +1,116 @@
+#include <array>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "uci/command/grammar.hpp"
+#include "uci/io/info_builder.hpp"
+#include "uci/parser.hpp"
+
+namespace
+{
+/**
+ * @brief Whether lowerbound() can be called on an InfoBuilder
+ *
+ */
+template <typename Builder, typename = void>
+struct has_lowerbound : std::false_type
+{
+};
+
+template <typename Builder>
+struct has_lowerbound<Builder, std::void_t<decltype(std::declval<Builder>().lowerbound())>> : std::true_type
+{
+};
+
+using Started = decltype(chesspp::info(std::declval<chesspp::OutputWriter &>()));
+using Scored = decltype(std::declval<Started>().depth(1).score_cp(0));
+} // namespace
+
+// A bound can only come straight after the score
+static_assert(has_lowerbound<Scored>::value);
+static_assert(not has_lowerbound<Started>::value);
+static_assert(not has_lowerbound<decltype(std::declval<Scored>().nodes(1))>::value);
+static_assert(not has_lowerbound<decltype(std::declval<Scored>().upperbound())>::value);
+
+TEST(InfoBuilder, send_test_search_info)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    std::vector<std::string> const pv = {"e2e4", "e7e5", "g1f3"};
+
+    chesspp::info(output)
+        .depth(12)
+        .seldepth(20)
+        .multipv(1)
+        .score_cp(-35)
+        .lowerbound()
+        .nodes(123456789012ull)
+        .nps(1000000)
+        .time(1242)
+        .hashfull(500)
+        .tbhits(0)
+        .pv(pv)
+        .send();
+    output.flush();
+
+    EXPECT_EQ(
+        "info depth 12 seldepth 20 multipv 1 score cp -35 lowerbound nodes 123456789012 "
+        "nps 1000000 time 1242 hashfull 500 tbhits 0 pv e2e4 e7e5 g1f3\n",
+        sink.data);
+}
+
+TEST(InfoBuilder, send_test_other_fields)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    std::array<std::string_view, 2> const line = {"d1h5", "g6h5"};
+
+    chesspp::info(output).currmove("e2e4").currmovenumber(1).send();
+    chesspp::info(output).score_mate(-3).upperbound().send();
+    chesspp::info(output).refutation(line).sbhits(7).cpuload(950).send();
+    chesspp::info(output).currline(2, line).send();
+    chesspp::info(output).depth(3).string("hello world").send();
+    output.flush();
+
+    EXPECT_EQ(
+        "info currmove e2e4 currmovenumber 1\n"
+        "info score mate -3 upperbound\n"
+        "info refutation d1h5 g6h5 sbhits 7 cpuload 950\n"
+        "info currline 2 d1h5 g6h5\n"
+        "info depth 3 string hello world\n",
+        sink.data);
+}
+
+TEST(InfoBuilder, send_test_unsent_line_is_discarded)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+
+    chesspp::info(output).depth(1).send();
+    {
+        auto unsent = chesspp::info(output).depth(2).nodes(100);
+    }
+    chesspp::info(output).depth(3).send();
+    output.flush();
+
+    EXPECT_EQ("info depth 1\ninfo depth 3\n", sink.data);
+}
+
+TEST(InfoBuilder, send_test_output_parses_as_info)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    std::vector<std::string> const pv = {"e2e4", "e7e5"};
+    chesspp::info(output).depth(5).score_cp(20).nodes(1000).pv(pv).send();
+    output.flush();
+
+    std::vector<std::string_view> tokens;
+    chesspp::Parser::tokenise(sink.data, tokens);
+    std::vector<chesspp::ArgumentView> arguments;
+    chesspp::StaticCommand<chesspp::grammar::info>::parse_arguments(chesspp::TokenSpan(tokens).subspan(1), arguments);
+    EXPECT_EQ(5, arguments.size());
+}
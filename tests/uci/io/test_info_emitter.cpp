@@ -0,0 +1,205 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "uci/io/info_emitter.hpp"
+
+namespace
+{
+std::chrono::steady_clock::time_point fake_time;
+
+std::chrono::steady_clock::time_point fake_now()
+{
+    return fake_time;
+}
+} // namespace
+
+TEST(InfoEmitter, update_test_coalesces_within_interval)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::InfoEmitter emitter(output, std::chrono::milliseconds(100), &fake_now);
+
+    // The first update is due straight away
+    emitter.nodes(100);
+    for (int i = 1; i <= 10; i++)
+    {
+        emitter.nodes(100 + i);
+        emitter.currmove("e2e4", i);
+    }
+    emitter.nps(5000);
+    output.flush();
+    EXPECT_EQ("info nodes 100\n", sink.data);
+
+    fake_time += std::chrono::milliseconds(100);
+    emitter.poll();
+    output.flush();
+    EXPECT_EQ("info nodes 100\ninfo nodes 110 nps 5000 currmove e2e4 currmovenumber 10\n", sink.data);
+
+    chesspp::InfoEmitterStats const stats = emitter.get_stats();
+    EXPECT_EQ(22, stats.updates);
+    EXPECT_EQ(18, stats.coalesced);
+    EXPECT_EQ(2, stats.lines);
+}
+
+TEST(InfoEmitter, update_test_emits_at_next_update_after_interval)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::InfoEmitter emitter(output, std::chrono::milliseconds(50), &fake_now);
+
+    emitter.nodes(1);
+    emitter.hashfull(10);
+    fake_time += std::chrono::milliseconds(50);
+    emitter.time(50);
+    output.flush();
+
+    EXPECT_EQ("info nodes 1\ninfo time 50 hashfull 10\n", sink.data);
+}
+
+TEST(InfoEmitter, pv_test_new_depth_is_not_delayed)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::InfoEmitter emitter(output, std::chrono::hours(1), &fake_now);
+    std::vector<std::string> const pv = {"e2e4", "e7e5"};
+
+    emitter.nodes(10);
+
+    // Pending values are merged into the pv line
+    emitter.nodes(20);
+    emitter.pv(chesspp::PvInfo{1, 0, 0, 15}, pv);
+    emitter.pv(chesspp::PvInfo{2, 3, 0, 20}, pv);
+
+    // Same depth, waits for the interval and replaces the pending pv
+    emitter.pv(chesspp::PvInfo{2, 3, 0, 25, false, chesspp::PvInfo::Bound::lower}, pv);
+    emitter.pv(chesspp::PvInfo{2, 4, 0, 30}, std::vector<std::string>{"d2d4"});
+    output.flush();
+    EXPECT_EQ(
+        "info nodes 10\n"
+        "info depth 1 score cp 15 nodes 20 pv e2e4 e7e5\n"
+        "info depth 2 seldepth 3 score cp 20 pv e2e4 e7e5\n",
+        sink.data);
+
+    emitter.flush();
+    output.flush();
+    EXPECT_EQ(
+        "info nodes 10\n"
+        "info depth 1 score cp 15 nodes 20 pv e2e4 e7e5\n"
+        "info depth 2 seldepth 3 score cp 20 pv e2e4 e7e5\n"
+        "info depth 2 seldepth 4 score cp 30 pv d2d4\n",
+        sink.data);
+    EXPECT_EQ(1, emitter.get_stats().coalesced);
+}
+
+TEST(InfoEmitter, pv_test_multipv_lines_are_not_dropped)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::InfoEmitter emitter(output, std::chrono::hours(1), &fake_now);
+
+    emitter.pv(chesspp::PvInfo{5, 0, 1, 40}, std::vector<std::string>{"e2e4"});
+    emitter.pv(chesspp::PvInfo{5, 0, 2, 30}, std::vector<std::string>{"d2d4"});
+    emitter.pv(chesspp::PvInfo{6, 0, 1, 2, true}, std::vector<std::string>{"e2e4"});
+    output.flush();
+
+    EXPECT_EQ(
+        "info depth 5 multipv 1 score cp 40 pv e2e4\n"
+        "info depth 5 multipv 2 score cp 30 pv d2d4\n"
+        "info depth 6 multipv 1 score mate 2 pv e2e4\n",
+        sink.data);
+}
+
+TEST(InfoEmitter, pv_test_pending_pv_keeps_its_moves)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::InfoEmitter emitter(output, std::chrono::hours(1), &fake_now);
+
+    emitter.pv(chesspp::PvInfo{5, 0, 1, 40}, std::vector<std::string>{"e2e4"});
+    emitter.pv(chesspp::PvInfo{5, 0, 1, 45}, std::vector<std::string>{"e2e4", "e7e5"});
+    emitter.pv(chesspp::PvInfo{5, 0, 2, 30}, std::vector<std::string>{"d2d4"});
+    emitter.flush();
+
+    // The pending line goes out before one at a new depth
+    emitter.pv(chesspp::PvInfo{5, 0, 1, 50}, std::vector<std::string>{"g1f3"});
+    emitter.pv(chesspp::PvInfo{6, 0, 2, 35}, std::vector<std::string>{"c2c4"});
+    output.flush();
+
+    EXPECT_EQ(
+        "info depth 5 multipv 1 score cp 40 pv e2e4\n"
+        "info depth 5 multipv 1 score cp 45 pv e2e4 e7e5\n"
+        "info depth 5 multipv 2 score cp 30 pv d2d4\n"
+        "info depth 5 multipv 1 score cp 50 pv g1f3\n"
+        "info depth 6 multipv 2 score cp 35 pv c2c4\n",
+        sink.data);
+}
+
+TEST(InfoEmitter, pv_test_coalesces_multipv_lines)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::InfoEmitter emitter(output, std::chrono::milliseconds(100), &fake_now);
+
+    emitter.pv(chesspp::PvInfo{8, 0, 1, 10}, std::vector<std::string>{"e2e4"});
+    for (int i = 1; i <= 10; i++)
+    {
+        emitter.pv(chesspp::PvInfo{8, 0, 1, 10 + i}, std::vector<std::string>{"e2e4"});
+        emitter.pv(chesspp::PvInfo{8, 0, 2, i}, std::vector<std::string>{"d2d4"});
+    }
+    output.flush();
+    EXPECT_EQ("info depth 8 multipv 1 score cp 10 pv e2e4\n", sink.data);
+
+    // Each line gets its own, with the other fields on the first
+    emitter.nodes(5000);
+    fake_time += std::chrono::milliseconds(100);
+    emitter.poll();
+    output.flush();
+    EXPECT_EQ(
+        "info depth 8 multipv 1 score cp 10 pv e2e4\n"
+        "info depth 8 multipv 1 score cp 20 nodes 5000 pv e2e4\n"
+        "info depth 8 multipv 2 score cp 10 pv d2d4\n",
+        sink.data);
+
+    chesspp::InfoEmitterStats const stats = emitter.get_stats();
+    EXPECT_EQ(22, stats.updates);
+    EXPECT_EQ(18, stats.coalesced);
+    EXPECT_EQ(3, stats.lines);
+}
+
+TEST(InfoEmitter, string_test_keeps_order)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::InfoEmitter emitter(output, std::chrono::hours(1), &fake_now);
+
+    emitter.nodes(1);
+    emitter.nodes(2);
+    emitter.string("hello world");
+    output.flush();
+
+    EXPECT_EQ("info nodes 1\ninfo nodes 2\ninfo string hello world\n", sink.data);
+}
+
+TEST(InfoEmitter, bestmove_test_flushes_pending)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::InfoEmitter emitter(output, std::chrono::hours(1), &fake_now);
+
+    emitter.pv(chesspp::PvInfo{1, 0, 0, 15}, std::vector<std::string>{"e2e4"});
+    emitter.nodes(400);
+    emitter.bestmove("e2e4", "e7e5");
+
+    // bestmove is flushed by the writer without an explicit flush
+    EXPECT_EQ("info depth 1 score cp 15 pv e2e4\ninfo nodes 400\nbestmove e2e4 ponder e7e5\n", sink.data);
+
+    // A new search starts again at depth 1, which is a new depth
+    emitter.pv(chesspp::PvInfo{1, 0, 0, 10}, std::vector<std::string>{"d2d4"});
+    emitter.bestmove("d2d4");
+    EXPECT_EQ(
+        "info depth 1 score cp 15 pv e2e4\ninfo nodes 400\nbestmove e2e4 ponder e7e5\n"
+        "info depth 1 score cp 10 pv d2d4\nbestmove d2d4\n",
+        sink.data);
+}
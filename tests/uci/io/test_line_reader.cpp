@@ -0,0 +1,104 @@
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "uci/io/line_reader.hpp"
+
+namespace
+{
+/**
+ * @brief Reads every line from a reader
+ *
+ */
+std::vector<std::string> read_lines(chesspp::LineReader &reader)
+{
+    std::vector<std::string> lines;
+    std::string_view line;
+    while (reader.next_line(line))
+    {
+        lines.emplace_back(line);
+    }
+    return lines;
+}
+
+/**
+ * @brief Writes text into a new pipe and closes its write end
+ *
+ * @return int The read end of the pipe
+ */
+int pipe_with(std::string const &text)
+{
+    int fds[2];
+    EXPECT_EQ(0, pipe(fds));
+    EXPECT_EQ(text.size(), write(fds[1], text.data(), text.size()));
+    close(fds[1]);
+    return fds[0];
+}
+} // namespace
+
+TEST(LineReader, next_line_test_line_endings)
+{
+    int const fd = pipe_with("uci\r\nisready\n\n  debug on  \r\nquit");
+    chesspp::LineReader reader(fd);
+
+    std::vector<std::string> const expected = {"uci", "isready", "", "  debug on  ", "quit"};
+    EXPECT_EQ(expected, read_lines(reader));
+    close(fd);
+}
+
+TEST(LineReader, next_line_test_empty_input)
+{
+    int const fd = pipe_with("");
+    chesspp::LineReader reader(fd);
+    std::string_view line;
+    EXPECT_FALSE(reader.next_line(line));
+    EXPECT_FALSE(reader.next_line(line));
+    close(fd);
+}
+
+TEST(LineReader, next_line_test_lines_longer_than_buffer)
+{
+    std::string position = "position startpos moves";
+    for (int i = 0; i < 500; i++)
+    {
+        position += " e2e4";
+    }
+    int const fd = pipe_with("isready\n" + position + "\r\ngo infinite\n");
+
+    // Start with a tiny buffer so lines span many reads and the buffer grows
+    chesspp::LineReader reader(fd, 4);
+    std::vector<std::string> const expected = {"isready", position, "go infinite"};
+    EXPECT_EQ(expected, read_lines(reader));
+    close(fd);
+}
+
+TEST(LineReader, next_line_test_partial_lines_over_socket)
+{
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+    // Send lines in pieces that split them at awkward places
+    std::vector<std::string> const pieces = {
+        "posi", "tion startpos moves e2e4\r", "\ngo wtime 1000", "0\n", "stop\nqu", "it\n"};
+    std::thread writer([&pieces, fd = fds[1]]() {
+        for (std::string const &piece : pieces)
+        {
+            EXPECT_EQ(piece.size(), write(fd, piece.data(), piece.size()));
+            std::this_thread::yield();
+        }
+        close(fd);
+    });
+
+    chesspp::LineReader reader(fds[0], 8);
+    std::vector<std::string> const expected = {
+        "position startpos moves e2e4", "go wtime 10000", "stop", "quit"};
+    EXPECT_EQ(expected, read_lines(reader));
+
+    writer.join();
+    close(fds[0]);
+}
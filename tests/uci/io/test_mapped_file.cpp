@@ -0,0 +1,34 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "uci/io/mapped_file.hpp"
+
+TEST(MappedFile, data_test)
+{
+    std::string const path = testing::TempDir() + "chesspp_mapped_file.txt";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "8/8/8/8/8/8/8/K6k w - - 0 1\n";
+    }
+
+    chesspp::MappedFile mapped(path);
+    ASSERT_TRUE(mapped.is_open());
+    EXPECT_EQ("8/8/8/8/8/8/8/K6k w - - 0 1\n", mapped.data());
+
+    chesspp::MappedFile moved(std::move(mapped));
+    EXPECT_FALSE(mapped.is_open());
+    EXPECT_EQ("8/8/8/8/8/8/8/K6k w - - 0 1\n", moved.data());
+
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    }
+    chesspp::MappedFile empty(path);
+    EXPECT_TRUE(empty.is_open());
+    EXPECT_EQ("", empty.data());
+    std::remove(path.c_str());
+
+    chesspp::MappedFile missing("/nonexistent/positions.epd");
+    EXPECT_FALSE(missing.is_open());
+}
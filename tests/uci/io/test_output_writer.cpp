@@ -0,0 +1,152 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "uci/command/grammar.hpp"
+#include "uci/io/output_writer.hpp"
+
+namespace
+{
+/**
+ * @brief Counts the writes to it, and records when the first one happened.
+ *        Safe to check from another thread while it is written to.
+ *
+ */
+struct TimedSink : chesspp::OutputSink
+{
+    std::atomic<int> writes{0};
+    std::chrono::steady_clock::time_point first_write;
+
+    void write(std::string_view) override
+    {
+        if (writes.load() == 0)
+        {
+            first_write = std::chrono::steady_clock::now();
+        }
+        writes.fetch_add(1);
+    }
+};
+} // namespace
+
+TEST(OutputWriter, write_test_batches_commands)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink, 4096, std::chrono::hours(1));
+
+    output.write("info", std::vector<std::string>{"depth", "1", "nodes", "20"});
+    output.write("info", std::vector<std::string>{"depth", "2", "nodes", "400"});
+    EXPECT_EQ(0, sink.writes);
+
+    output.flush();
+    EXPECT_EQ("info depth 1 nodes 20\ninfo depth 2 nodes 400\n", sink.data);
+    EXPECT_EQ(1, sink.writes);
+
+    // Nothing to flush
+    output.flush();
+    EXPECT_EQ(1, sink.writes);
+}
+
+TEST(OutputWriter, write_test_flushes_critical_commands)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink, 4096, std::chrono::hours(1));
+
+    output.write("info", std::vector<std::string>{"depth", "12"});
+    output.write("bestmove", std::vector<std::string>{"e2e4", "ponder", "e7e5"});
+    EXPECT_EQ("info depth 12\nbestmove e2e4 ponder e7e5\n", sink.data);
+    EXPECT_EQ(1, sink.writes);
+
+    output.write("readyok", std::vector<std::string>());
+    output.write("uciok", std::vector<std::string>());
+    EXPECT_EQ(3, sink.writes);
+
+    output.set_flush_commands({"id"});
+    output.write("readyok", std::vector<std::string>());
+    EXPECT_EQ(3, sink.writes);
+    output.write("id", std::vector<std::string>{"name", "Chess++"});
+    EXPECT_EQ(4, sink.writes);
+}
+
+TEST(OutputWriter, write_test_flushes_at_size)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink, 32, std::chrono::hours(1));
+
+    output.write("info", std::vector<std::string>{"nodes", "1000"});
+    EXPECT_EQ(0, sink.writes);
+    output.write("info", std::vector<std::string>{"nodes", "2000"});
+    EXPECT_EQ(1, sink.writes);
+    EXPECT_EQ("info nodes 1000\ninfo nodes 2000\n", sink.data);
+}
+
+TEST(OutputWriter, write_test_flushes_after_interval)
+{
+    TimedSink sink;
+    chesspp::OutputWriter output(sink, 4096, std::chrono::milliseconds(20));
+
+    auto const written = std::chrono::steady_clock::now();
+    output.write("info", std::vector<std::string>{"nodes", "1000"});
+    EXPECT_EQ(0, sink.writes.load());
+
+    // Nothing else is written, but the line still goes out when it is due
+    auto const give_up = written + std::chrono::seconds(5);
+    while (sink.writes.load() == 0 and std::chrono::steady_clock::now() < give_up)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(1, sink.writes.load());
+    EXPECT_GE(sink.first_write - written, std::chrono::milliseconds(20));
+    EXPECT_LT(sink.first_write - written, std::chrono::milliseconds(500));
+
+    // The next line waits for its own interval
+    output.write("info", std::vector<std::string>{"nodes", "2000"});
+    EXPECT_EQ(1, sink.writes.load());
+}
+
+TEST(OutputWriter, destructor_test_flushes)
+{
+    chesspp::StringSink sink;
+    {
+        chesspp::OutputWriter output(sink);
+        output.write("info", std::vector<std::string>{"string", "bye"});
+    }
+    EXPECT_EQ("info string bye\n", sink.data);
+}
+
+TEST(OutputWriter, write_test_fd_sink)
+{
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    {
+        chesspp::FdSink sink(fds[1]);
+        chesspp::OutputWriter output(sink);
+        output.write("readyok", std::vector<std::string>());
+    }
+    close(fds[1]);
+
+    char data[16] = {};
+    EXPECT_EQ(8, read(fds[0], data, sizeof(data)));
+    EXPECT_EQ("readyok\n", std::string(data));
+    close(fds[0]);
+}
+
+TEST(OutputWriter, issue_test_writes_validated_command)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::Command const bestmove = chesspp::grammar::bestmove.to_command();
+
+    bestmove.issue({"e2e4", "ponder", "e7e5"}, output);
+    EXPECT_EQ("bestmove e2e4 ponder e7e5\n", sink.data);
+
+#if CHESSPP_HAS_EXCEPTIONS
+    EXPECT_THROW(bestmove.issue({"e2e4", "ponder"}, output), chesspp::ArgumentParseException);
+#endif
+    EXPECT_EQ("bestmove e2e4 ponder e7e5\n", sink.data);
+}
@@ -0,0 +1,241 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "uci/io/shared_ring.hpp"
+
+namespace
+{
+/**
+ * @brief Reads until `size` bytes have arrived or the ring is closed
+ *
+ */
+std::string read_all(chesspp::SharedRing &ring, size_t size)
+{
+    std::string text;
+    char buffer[1000];
+    while (text.size() < size)
+    {
+        size_t const count = ring.read(buffer, sizeof(buffer));
+        if (count == 0)
+        {
+            break;
+        }
+        text.append(buffer, count);
+    }
+    return text;
+}
+
+/**
+ * @brief Reads from a ring until it is closed
+ *
+ * @return true If that happened within a few seconds. Otherwise the ring is
+ *         closed from here so the test can't hang.
+ */
+bool reads_to_end(chesspp::SharedRing &ring)
+{
+    auto const start = std::chrono::steady_clock::now();
+    std::atomic<bool> done{false};
+    std::thread watchdog([&ring, &done, start]() {
+        while (not done.load() and std::chrono::steady_clock::now() < start + std::chrono::seconds(5))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (not done.load())
+        {
+            ring.close();
+        }
+    });
+    char buffer[64];
+    while (ring.read(buffer, sizeof(buffer)) != 0)
+    {
+    }
+    bool const in_time = std::chrono::steady_clock::now() - start < std::chrono::seconds(3);
+    done.store(true);
+    watchdog.join();
+    return in_time;
+}
+} // namespace
+
+TEST(SharedChannel, create_test_round_trip)
+{
+    chesspp::SharedChannel channel;
+    ASSERT_TRUE(channel.create());
+    ASSERT_TRUE(channel.is_open());
+
+    EXPECT_TRUE(channel.to_engine().write("uci\n"));
+    EXPECT_TRUE(channel.to_interface().write("uciok\n"));
+    EXPECT_EQ("uci\n", read_all(channel.to_engine(), 4));
+    EXPECT_EQ("uciok\n", read_all(channel.to_interface(), 6));
+}
+
+TEST(SharedChannel, write_test_wraps_and_waits_for_room)
+{
+    // Much more than the ring holds, in pieces that don't divide its size
+    chesspp::SharedChannel channel;
+    ASSERT_TRUE(channel.create(4096));
+    std::string text;
+    for (int i = 0; text.size() < 1000000; i++)
+    {
+        text += "info depth " + std::to_string(i) + " nodes " + std::to_string(i * 977) + "\n";
+    }
+
+    std::thread writer([&channel, &text]() {
+        for (size_t written = 0; written < text.size(); written += 333)
+        {
+            EXPECT_TRUE(channel.to_interface().write(std::string_view(text).substr(written, 333)));
+        }
+    });
+    std::string const received = read_all(channel.to_interface(), text.size());
+    writer.join();
+    EXPECT_EQ(text, received);
+}
+
+TEST(SharedChannel, close_test)
+{
+    chesspp::SharedChannel channel;
+    ASSERT_TRUE(channel.create());
+    chesspp::SharedRing &ring = channel.to_engine();
+
+    // What was written before the close can still be read
+    EXPECT_TRUE(ring.write("quit\n"));
+    ring.close();
+    EXPECT_FALSE(ring.write("isready\n"));
+    EXPECT_EQ("quit\n", read_all(ring, 100));
+    char byte;
+    EXPECT_EQ(0, ring.read(&byte, 1));
+}
+
+TEST(SharedChannel, close_test_wakes_reader)
+{
+    chesspp::SharedChannel channel;
+    ASSERT_TRUE(channel.create());
+    std::thread closer([&channel]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        channel.to_engine().close();
+    });
+    char byte;
+    EXPECT_EQ(0, channel.to_engine().read(&byte, 1));
+    closer.join();
+}
+
+TEST(SharedChannel, open_test_descriptor)
+{
+    chesspp::SharedChannel channel;
+    ASSERT_TRUE(channel.create());
+
+    // The engine's end, as if it had inherited a copy of the descriptor
+    chesspp::SharedChannel engine;
+    ASSERT_TRUE(engine.open(std::to_string(dup(std::stoi(channel.get_address())))));
+    EXPECT_TRUE(channel.to_engine().write("isready\n"));
+    EXPECT_EQ("isready\n", read_all(engine.to_engine(), 8));
+    EXPECT_TRUE(engine.to_interface().write("readyok\n"));
+    EXPECT_EQ("readyok\n", read_all(channel.to_interface(), 8));
+
+    // The engine going away closes the rings
+    engine = chesspp::SharedChannel();
+    char byte;
+    EXPECT_EQ(0, channel.to_interface().read(&byte, 1));
+}
+
+TEST(SharedChannel, open_test_name)
+{
+    std::string const name = "/chesspp-test-" + std::to_string(getpid());
+    {
+        chesspp::SharedChannel channel;
+        ASSERT_TRUE(channel.create(name));
+        EXPECT_EQ(name, channel.get_address());
+        EXPECT_FALSE(chesspp::SharedChannel().create(name));
+
+        chesspp::SharedChannel engine;
+        ASSERT_TRUE(engine.open(name));
+        EXPECT_TRUE(channel.to_engine().write("go infinite\n"));
+        EXPECT_EQ("go infinite\n", read_all(engine.to_engine(), 12));
+    }
+
+    // Unlinked by its creator
+    EXPECT_FALSE(chesspp::SharedChannel().open(name));
+}
+
+TEST(SharedChannel, open_test_not_a_channel)
+{
+    chesspp::SharedChannel channel;
+    EXPECT_FALSE(channel.open(""));
+    EXPECT_FALSE(channel.open("five"));
+    EXPECT_FALSE(channel.open("/chesspp-test-does-not-exist"));
+
+    // A descriptor that is not a channel is left open for its owner
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    EXPECT_FALSE(channel.open(std::to_string(fds[0])));
+    EXPECT_FALSE(channel.is_open());
+    EXPECT_NE(-1, fcntl(fds[0], F_GETFD));
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(SharedChannel, read_test_engine_killed)
+{
+    chesspp::SharedChannel channel;
+    ASSERT_TRUE(channel.create());
+    std::string const address = channel.get_address();
+
+    pid_t const child = fork();
+    ASSERT_NE(-1, child);
+    if (child == 0)
+    {
+        // The engine dies without closing anything
+        chesspp::SharedChannel engine;
+        if (engine.open(std::to_string(dup(std::stoi(address)))))
+        {
+            engine.to_interface().write("readyok\n");
+        }
+        raise(SIGKILL);
+    }
+
+    // Noticed before the engine is reaped
+    EXPECT_EQ("readyok\n", read_all(channel.to_interface(), 8));
+    EXPECT_TRUE(reads_to_end(channel.to_interface()));
+    int status = 0;
+    EXPECT_EQ(child, waitpid(child, &status, 0));
+}
+
+TEST(SharedChannel, read_test_interface_killed)
+{
+    std::string const name = "/chesspp-test-killed-" + std::to_string(getpid());
+    int ready[2];
+    ASSERT_EQ(0, pipe(ready));
+    pid_t const child = fork();
+    ASSERT_NE(-1, child);
+    if (child == 0)
+    {
+        // The interface creates the channel, then dies without closing it
+        chesspp::SharedChannel channel;
+        char const created = channel.create(name, 4096) ? 1 : 0;
+        (void)write(ready[1], &created, 1);
+        pause();
+        _exit(0);
+    }
+    close(ready[1]);
+
+    char created = 0;
+    EXPECT_EQ(1, read(ready[0], &created, 1));
+    close(ready[0]);
+    chesspp::SharedChannel engine;
+    bool const opened = created != 0 and engine.open(name);
+    shm_unlink(name.c_str());
+    kill(child, SIGKILL);
+    int status = 0;
+    EXPECT_EQ(child, waitpid(child, &status, 0));
+
+    ASSERT_TRUE(opened);
+    EXPECT_TRUE(reads_to_end(engine.to_engine()));
+}
@@ -0,0 +1,70 @@
+#include <csignal>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "uci/io/line_reader.hpp"
+#include "uci/io/subprocess.hpp"
+
+TEST(Subprocess, spawn_test_pipes)
+{
+    chesspp::Subprocess process;
+    ASSERT_TRUE(process.spawn("tr a-z A-Z"));
+    EXPECT_FALSE(process.spawn("cat"));
+
+    std::string const text = "isready\nuci\n";
+    EXPECT_EQ(text.size(), write(process.input(), text.data(), text.size()));
+    process.close_input();
+
+    chesspp::LineReader reader(process.output());
+    std::string_view line;
+    ASSERT_TRUE(reader.next_line(line));
+    EXPECT_EQ("ISREADY", line);
+    ASSERT_TRUE(reader.next_line(line));
+    EXPECT_EQ("UCI", line);
+    EXPECT_FALSE(reader.next_line(line));
+
+    int const status = process.wait();
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+    EXPECT_EQ(-1, process.get_pid());
+}
+
+TEST(Subprocess, kill_test)
+{
+    chesspp::Subprocess process;
+    ASSERT_TRUE(process.spawn("sleep 60"));
+    process.kill();
+    EXPECT_EQ(-1, process.get_pid());
+    EXPECT_EQ(-1, process.input());
+    EXPECT_EQ(-1, process.output());
+}
+
+TEST(Subprocess, wait_test_unblocks_writer)
+{
+    // Fills the pipe and blocks, as nothing reads it
+    chesspp::Subprocess process;
+    ASSERT_TRUE(process.spawn("yes"));
+    int const status = process.wait();
+    EXPECT_FALSE(WIFEXITED(status) and WEXITSTATUS(status) == 0);
+    EXPECT_EQ(-1, process.get_pid());
+}
+
+TEST(Subprocess, terminate_test_keeps_pipes)
+{
+    chesspp::Subprocess process;
+    // Without exec, the shell's child would keep the pipe open
+    ASSERT_TRUE(process.spawn("exec sleep 60"));
+    process.terminate();
+    EXPECT_NE(-1, process.output());
+
+    chesspp::LineReader reader(process.output());
+    std::string_view line;
+    EXPECT_FALSE(reader.next_line(line));
+
+    int const status = process.wait();
+    ASSERT_TRUE(WIFSIGNALED(status));
+    EXPECT_EQ(SIGKILL, WTERMSIG(status));
+}
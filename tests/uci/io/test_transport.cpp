@@ -0,0 +1,87 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "uci/io/subprocess.hpp"
+#include "uci/io/transport.hpp"
+
+TEST(Transport, open_transport_test_stdio)
+{
+    char const *const argv[] = {"engine", "--threads", "4"};
+    std::unique_ptr<chesspp::Transport> const transport = chesspp::open_transport(3, argv);
+    ASSERT_NE(nullptr, transport);
+    EXPECT_NE(nullptr, dynamic_cast<chesspp::StdioTransport *>(transport.get()));
+    EXPECT_EQ(&chesspp::OutputWriter::standard(), &transport->output());
+}
+
+TEST(Transport, open_transport_test_bad_address)
+{
+    char const *const missing[] = {"engine", "--uci-shm=/chesspp-test-does-not-exist"};
+    EXPECT_EQ(nullptr, chesspp::open_transport(2, missing));
+    char const *const empty[] = {"engine", "--uci-shm"};
+    EXPECT_EQ(nullptr, chesspp::open_transport(2, empty));
+}
+
+TEST(Transport, open_transport_test_shared_memory)
+{
+    chesspp::SharedChannel channel;
+    ASSERT_TRUE(channel.create());
+    std::string const address = std::to_string(dup(std::stoi(channel.get_address())));
+    char const *const argv[] = {"engine", "--uci-shm", address.c_str()};
+    std::unique_ptr<chesspp::Transport> const engine = chesspp::open_transport(3, argv);
+    ASSERT_NE(nullptr, engine);
+    chesspp::SharedMemoryTransport interface(std::move(channel), chesspp::TransportSide::interface);
+
+    interface.output().write("isready", std::vector<std::string>());
+    interface.output().flush();
+    chesspp::LineReader engine_reader(engine->input());
+    std::string_view line;
+    ASSERT_TRUE(engine_reader.next_line(line));
+    EXPECT_EQ("isready", line);
+
+    engine->output().write("readyok", std::vector<std::string>());
+    chesspp::LineReader interface_reader(interface.input());
+    ASSERT_TRUE(interface_reader.next_line(line));
+    EXPECT_EQ("readyok", line);
+}
+
+TEST(Transport, shared_memory_test_engine_process)
+{
+    chesspp::SharedChannel channel;
+    ASSERT_TRUE(channel.create());
+    chesspp::Subprocess process;
+    ASSERT_TRUE(process.spawn(std::string(CHESSPP_STUB_ENGINE) + " --uci-shm=" + channel.get_address()));
+    chesspp::SharedMemoryTransport interface(std::move(channel), chesspp::TransportSide::interface);
+
+    chesspp::OutputWriter &output = interface.output();
+    output.write("uci", std::vector<std::string>());
+    output.write("position", std::vector<std::string>{"startpos", "moves", "e2e4"});
+    output.write("go", std::vector<std::string>{"depth", "1"});
+    output.write("quit", std::vector<std::string>());
+    output.flush();
+
+    // Nothing goes over the pipes, and the engine closes the channel when
+    // it exits
+    chesspp::LineReader reader(interface.input());
+    std::vector<std::string> lines;
+    std::string_view line;
+    while (reader.next_line(line))
+    {
+        lines.emplace_back(line);
+    }
+    std::vector<std::string> const expected = {
+        "id name Stub", "id author Chess++", "uciok",
+        "info depth 1 score cp 17 nodes 1 pv e2e4", "bestmove e2e4"};
+    EXPECT_EQ(expected, lines);
+
+    process.close_input();
+    chesspp::LineReader pipe_reader(process.output());
+    EXPECT_FALSE(pipe_reader.next_line(line));
+    int const status = process.wait();
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+}
@@ -0,0 +1,51 @@
+/**
+ * @file pipe_input.hpp
+ * @brief Feeds fixed text to an engine through a pipe
+ *
+ */
+
+#ifndef TESTS_UCI_PIPE_INPUT_H
+#define TESTS_UCI_PIPE_INPUT_H
+
+#include <string>
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+namespace test_support
+{
+/**
+ * @brief A pipe that has been filled with some text and closed for writing,
+ *        to use as the engine's input
+ *
+ */
+class PipeInput
+{
+private:
+    int fds[2];
+
+public:
+    explicit PipeInput(std::string const &text)
+    {
+        EXPECT_EQ(0, pipe(fds));
+        EXPECT_EQ(text.size(), write(fds[1], text.data(), text.size()));
+        close(fds[1]);
+    }
+
+    ~PipeInput()
+    {
+        close(fds[0]);
+    }
+
+    PipeInput(PipeInput const &) = delete;
+    PipeInput &operator=(PipeInput const &) = delete;
+
+    int fd() const
+    {
+        return fds[0];
+    }
+};
+} // namespace test_support
+
+#endif
@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include "uci/replay/latency.hpp"
+
+namespace
+{
+/**
+ * @brief Feeds a line to a matcher and adds any sample to a summary
+ *
+ */
+bool observe(
+    chesspp::ResponseMatcher &matcher,
+    chesspp::LatencySummary &summary,
+    uint64_t time,
+    chesspp::Direction direction,
+    std::string_view line)
+{
+    chesspp::LatencySample sample;
+    if (matcher.observe(time, direction, line, sample))
+    {
+        summary.add(sample);
+        return true;
+    }
+    return false;
+}
+
+constexpr chesspp::Direction in = chesspp::Direction::to_engine;
+constexpr chesspp::Direction out = chesspp::Direction::to_interface;
+} // namespace
+
+TEST(ResponseMatcher, observe_test_exchanges)
+{
+    chesspp::ResponseMatcher matcher;
+    chesspp::LatencySummary summary;
+
+    EXPECT_FALSE(observe(matcher, summary, 0, in, "uci"));
+    EXPECT_FALSE(observe(matcher, summary, 10, out, "id name Test"));
+    EXPECT_TRUE(observe(matcher, summary, 30, out, "uciok"));
+    EXPECT_FALSE(observe(matcher, summary, 40, in, "isready"));
+    EXPECT_TRUE(observe(matcher, summary, 45, out, "readyok"));
+    EXPECT_FALSE(observe(matcher, summary, 100, in, "go wtime 1000 btime 1000"));
+    EXPECT_FALSE(observe(matcher, summary, 150, out, "info depth 1"));
+    EXPECT_TRUE(observe(matcher, summary, 300, out, "bestmove e2e4"));
+
+    // An answer nobody asked for is not measured
+    EXPECT_FALSE(observe(matcher, summary, 310, out, "readyok"));
+
+    EXPECT_EQ(30, summary.percentile(chesspp::Exchange::uciok, 0.5));
+    EXPECT_EQ(5, summary.percentile(chesspp::Exchange::readyok, 0.5));
+    EXPECT_EQ(200, summary.percentile(chesspp::Exchange::bestmove, 0.5));
+    EXPECT_EQ(0, summary.count(chesspp::Exchange::stop));
+}
+
+TEST(ResponseMatcher, observe_test_unlimited_searches)
+{
+    chesspp::ResponseMatcher matcher;
+    chesspp::LatencySummary summary;
+
+    // Only the time after stop counts for an infinite search
+    observe(matcher, summary, 0, in, "go infinite");
+    observe(matcher, summary, 5000, in, "stop");
+    EXPECT_TRUE(observe(matcher, summary, 5020, out, "bestmove e2e4 ponder e7e5"));
+
+    // And only the time after ponderhit for a ponder search
+    observe(matcher, summary, 6000, in, "go ponder wtime 1000 btime 1000");
+    observe(matcher, summary, 9000, in, "ponderhit");
+    EXPECT_TRUE(observe(matcher, summary, 9400, out, "bestmove d2d4"));
+
+    // A ponder search that is stopped is measured as a stop
+    observe(matcher, summary, 10000, in, "go ponder");
+    observe(matcher, summary, 11000, in, "stop");
+    EXPECT_TRUE(observe(matcher, summary, 11004, out, "bestmove a2a3"));
+
+    EXPECT_EQ(2, summary.count(chesspp::Exchange::stop));
+    EXPECT_EQ(4, summary.percentile(chesspp::Exchange::stop, 0.0));
+    EXPECT_EQ(20, summary.percentile(chesspp::Exchange::stop, 1.0));
+    EXPECT_EQ(12, summary.mean(chesspp::Exchange::stop));
+    EXPECT_EQ(1, summary.count(chesspp::Exchange::bestmove));
+    EXPECT_EQ(400, summary.percentile(chesspp::Exchange::bestmove, 0.5));
+}
+
+TEST(ResponseMatcher, is_response_test)
+{
+    EXPECT_TRUE(chesspp::ResponseMatcher::is_response("bestmove e2e4"));
+    EXPECT_TRUE(chesspp::ResponseMatcher::is_response("  readyok"));
+    EXPECT_TRUE(chesspp::ResponseMatcher::is_response("uciok"));
+    EXPECT_FALSE(chesspp::ResponseMatcher::is_response("info string bestmove"));
+    EXPECT_FALSE(chesspp::ResponseMatcher::is_response("bestmoves"));
+    EXPECT_FALSE(chesspp::ResponseMatcher::is_response(""));
+}
@@ -0,0 +1,100 @@
+#include <string>
+
+#include "gtest/gtest.h"
+#include "uci/replay/log.hpp"
+#include "uci/replay/recorder.hpp"
+
+TEST(SessionLog, reader_test_round_trip)
+{
+    std::string log;
+    chesspp::session_log::append_header(log);
+    chesspp::session_log::append_entry(log, 0, chesspp::Direction::to_engine, "uci");
+    chesspp::session_log::append_entry(log, 1500, chesspp::Direction::to_interface, "uciok");
+    chesspp::session_log::append_entry(log, 3000000000, chesspp::Direction::to_engine, "");
+
+    chesspp::LogReader reader(log);
+    chesspp::LogRecord record;
+
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(0, record.time);
+    EXPECT_EQ(chesspp::Direction::to_engine, record.direction);
+    EXPECT_EQ("uci", record.line);
+
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(1500, record.time);
+    EXPECT_EQ(chesspp::Direction::to_interface, record.direction);
+    EXPECT_EQ("uciok", record.line);
+
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(3000001500, record.time);
+    EXPECT_EQ("", record.line);
+
+    EXPECT_FALSE(reader.next(record));
+    EXPECT_FALSE(reader.is_malformed());
+}
+
+TEST(SessionLog, reader_test_malformed)
+{
+    chesspp::LogRecord record;
+
+    chesspp::LogReader no_header("uci\n");
+    EXPECT_FALSE(no_header.next(record));
+    EXPECT_TRUE(no_header.is_malformed());
+
+    std::string log;
+    chesspp::session_log::append_header(log);
+    chesspp::session_log::append_entry(log, 10, chesspp::Direction::to_engine, "isready");
+    chesspp::session_log::append_entry(log, 10, chesspp::Direction::to_engine, "position startpos");
+    log.resize(log.size() - 3);
+
+    chesspp::LogReader truncated(log);
+    EXPECT_TRUE(truncated.next(record));
+    EXPECT_EQ("isready", record.line);
+    EXPECT_FALSE(truncated.next(record));
+    EXPECT_TRUE(truncated.is_malformed());
+}
+
+TEST(Recorder, record_test)
+{
+    chesspp::StringSink sink;
+    {
+        chesspp::Recorder recorder(sink);
+        recorder.record(chesspp::Direction::to_engine, "isready");
+        recorder.record(chesspp::Direction::to_interface, "readyok");
+        EXPECT_EQ(0, sink.writes);
+    }
+    EXPECT_EQ(1, sink.writes);
+
+    chesspp::LogReader reader(sink.data);
+    chesspp::LogRecord first;
+    chesspp::LogRecord second;
+    ASSERT_TRUE(reader.next(first));
+    ASSERT_TRUE(reader.next(second));
+    EXPECT_EQ("isready", first.line);
+    EXPECT_EQ(chesspp::Direction::to_interface, second.direction);
+    EXPECT_EQ("readyok", second.line);
+    EXPECT_LE(first.time, second.time);
+    EXPECT_FALSE(reader.next(first));
+}
+
+TEST(Recorder, record_test_flushes_when_full)
+{
+    chesspp::StringSink sink;
+    chesspp::Recorder recorder(sink, 64);
+    for (int i = 0; i < 10; i++)
+    {
+        recorder.record(chesspp::Direction::to_interface, "info depth 1 nodes 20");
+    }
+    EXPECT_GT(sink.writes, 0);
+    recorder.flush();
+
+    chesspp::LogReader reader(sink.data);
+    chesspp::LogRecord record;
+    int count = 0;
+    while (reader.next(record))
+    {
+        count++;
+    }
+    EXPECT_EQ(10, count);
+    EXPECT_FALSE(reader.is_malformed());
+}
@@ -0,0 +1,141 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "allocation_count.hpp"
+#include "gtest/gtest.h"
+#include "uci/arena.hpp"
+#include "uci/command/grammar.hpp"
+
+/*******************************************************************************
+ *                          Allocation counting
+*******************************************************************************/
+
+namespace
+{
+/**
+ * @brief The number of times operator new has been called by this program
+ *
+ */
+std::atomic<size_t> allocations(0);
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    allocations++;
+    if (void *memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+#if CHESSPP_HAS_EXCEPTIONS
+    throw std::bad_alloc();
+#else
+    std::abort();
+#endif
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+size_t test_support::allocation_count()
+{
+    return allocations;
+}
+
+/*******************************************************************************
+ *                               Test LineArena
+*******************************************************************************/
+
+TEST(LineArena, tokenise_test_copies_line)
+{
+    chesspp::LineArena arena;
+    std::string input = "debug on";
+    chesspp::TokenSpan tokens = arena.tokenise(input);
+    input = "xxxxx xx";
+
+    EXPECT_EQ("debug", tokens[0]);
+    EXPECT_EQ("on", tokens[1]);
+    EXPECT_EQ(2, tokens.size());
+}
+
+TEST(LineArena, parse_arguments_test_position)
+{
+    chesspp::LineArena arena;
+    chesspp::TokenSpan tokens = arena.tokenise("position startpos moves e2e4 e7e5");
+    std::vector<chesspp::ArgumentView> const &arguments = arena.parse_arguments(
+        chesspp::StaticCommand<chesspp::grammar::position>(), tokens.subspan(1));
+
+    EXPECT_EQ("startpos", arguments[0].value);
+    EXPECT_EQ("moves", arguments[1].value);
+    EXPECT_EQ("e7e5", arguments[1].parameters[1]);
+    EXPECT_EQ(2, arguments.size());
+}
+
+TEST(LineArena, try_parse_arguments_test_offset_in_line)
+{
+    chesspp::LineArena arena;
+    chesspp::TokenSpan const tokens = arena.tokenise("go  wtime 10 btime");
+    chesspp::ParseResult<std::vector<chesspp::ArgumentView>> const result =
+        arena.try_parse_arguments(chesspp::StaticCommand<chesspp::grammar::go>(), tokens.subspan(1));
+    EXPECT_FALSE(result);
+    EXPECT_EQ(chesspp::ParseErrorCode::unparsable_arguments, result.error().code);
+    EXPECT_EQ(13, result.error().offset);
+
+    chesspp::TokenSpan const empty = arena.tokenise("debug ");
+    EXPECT_EQ(6, arena.try_parse_arguments(chesspp::grammar::debug.to_command(), empty.subspan(1))
+                     .error()
+                     .offset);
+}
+
+TEST(LineArena, parse_arguments_test_no_allocations_in_steady_state)
+{
+    std::string longest_line = "position startpos moves";
+    for (int i = 0; i < 200; i++)
+    {
+        longest_line += (i % 2 == 0) ? " e2e4" : " e7e5";
+    }
+    std::vector<std::string> const lines = {
+        "position startpos moves e2e4 e7e5 g1f3",
+        "go wtime 300000 btime 300000 winc 2000 binc 2000",
+        longest_line,
+        "position fen rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1 moves e7e5",
+        "go infinite searchmoves e2e4 d2d4"};
+
+    chesspp::Command const position = chesspp::grammar::position.to_command();
+    chesspp::Command const go = chesspp::grammar::go.to_command();
+    chesspp::LineArena arena;
+
+    // Let the arena grow to fit the longest line and the most arguments
+    for (std::string const &line : lines)
+    {
+        chesspp::TokenSpan const tokens = arena.tokenise(line);
+        arena.parse_arguments((tokens[0] == "go") ? go : position, tokens.subspan(1));
+        arena.reset();
+    }
+
+    size_t const before = allocations;
+    size_t num_arguments = 0;
+    for (int repeat = 0; repeat < 100; repeat++)
+    {
+        for (std::string const &line : lines)
+        {
+            chesspp::TokenSpan const tokens = arena.tokenise(line);
+            chesspp::Command const &command = (tokens[0] == "go") ? go : position;
+            num_arguments += arena.parse_arguments(command, tokens.subspan(1)).size();
+            arena.reset();
+        }
+    }
+    size_t const after = allocations;
+
+    EXPECT_EQ(0, after - before);
+    EXPECT_EQ(100 * (2 + 4 + 2 + 2 + 2), num_arguments);
+}
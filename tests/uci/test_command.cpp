@@ -1,5 +1,8 @@
+#include "allocation_count.hpp"
 #include "gtest/gtest.h"
 #include "uci/command/command.hpp"
+#include "uci/command/grammar.hpp"
+#include "uci/parser.hpp"
 
 
 /*******************************************************************************
@@ -142,7 +145,9 @@ TEST(Command, parse_arguments_test_bad_param_number)
         "value1",
         "value6", "param0", "param1"};
 
+#if CHESSPP_HAS_EXCEPTIONS
     EXPECT_THROW(test_command.parse_arguments(args), chesspp::ArgumentParseException);
+#endif
 }
 
 TEST(Command, parse_arguments_test_bad_argument_name)
@@ -160,7 +165,9 @@ TEST(Command, parse_arguments_test_bad_argument_name)
         "bad-value",
         "value6", "param0", "param1", "param2"};
 
+#if CHESSPP_HAS_EXCEPTIONS
     EXPECT_THROW(test_command.parse_arguments(args), chesspp::ArgumentParseException);
+#endif
 }
 
 TEST(Command, parse_arguments_test_missing_required)
@@ -178,5 +185,323 @@ TEST(Command, parse_arguments_test_missing_required)
         "value1",
         "value6", "param0", "param1", "param2"};
 
+#if CHESSPP_HAS_EXCEPTIONS
     EXPECT_THROW(test_command.parse_arguments(args), chesspp::MissingArgumentException);
+#endif
+}
+
+/*******************************************************************************
+ *                  Test parse_arguments( ... ) with string views
+*******************************************************************************/
+
+TEST(Command, parse_arguments_view_test_multiple_arguments)
+{
+    std::vector<chesspp::ArgumentDefinition> accpeted_arguments = {
+        chesspp::ArgumentDefinition({"value1", "value2"}, 0),
+        chesspp::ArgumentDefinition({"value3", "value4", "value5"}, -1, true),
+        chesspp::ArgumentDefinition({"value6"}, 3),
+        chesspp::ArgumentDefinition({"value7", "value8", "value9"}, 0),
+        };
+
+    chesspp::Command const test_command("test_command", accpeted_arguments);
+    std::vector<std::string_view> tokens = {
+        "value6", "param0", "param1", "param2",
+        "value5", "param00", "param01",
+        "value7"};
+    std::vector<chesspp::ArgumentView> arguments;
+    test_command.parse_arguments(tokens, arguments);
+
+    EXPECT_EQ("value6", arguments[0].value);
+    EXPECT_EQ(3, arguments[0].parameters.size());
+    EXPECT_EQ("param0", arguments[0].parameters[0]);
+    EXPECT_EQ("param2", arguments[0].parameters[2]);
+
+    EXPECT_EQ("value5", arguments[1].value);
+    EXPECT_EQ(2, arguments[1].parameters.size());
+    EXPECT_EQ("param00", arguments[1].parameters[0]);
+    EXPECT_EQ("param01", arguments[1].parameters[1]);
+
+    EXPECT_EQ("value7", arguments[2].value);
+    EXPECT_TRUE(arguments[2].parameters.empty());
+
+    EXPECT_EQ(3, arguments.size());
+}
+
+TEST(Command, parse_arguments_view_test_parameters_refer_to_tokens)
+{
+    std::vector<chesspp::ArgumentDefinition> accpeted_arguments = {
+        chesspp::ArgumentDefinition({"startpos"}, 0),
+        chesspp::ArgumentDefinition({"moves"}, -1)};
+
+    chesspp::Command const test_command("position", accpeted_arguments);
+    std::vector<std::string_view> tokens = {"startpos", "moves", "e2e4", "e7e5"};
+    std::vector<chesspp::ArgumentView> arguments;
+    test_command.parse_arguments(tokens, arguments);
+
+    EXPECT_EQ(tokens.data() + 2, arguments[1].parameters.begin());
+    EXPECT_EQ(tokens.data() + 4, arguments[1].parameters.end());
+}
+
+TEST(Command, parse_arguments_view_test_bad_argument_name)
+{
+    std::vector<chesspp::ArgumentDefinition> accpeted_arguments = {
+        chesspp::ArgumentDefinition({"value1", "value2"}, 0),
+        chesspp::ArgumentDefinition({"value6"}, 3)};
+
+    chesspp::Command const test_command("test_command", accpeted_arguments);
+    std::vector<std::string_view> tokens = {
+        "bad-value",
+        "value6", "param0", "param1", "param2"};
+    std::vector<chesspp::ArgumentView> arguments;
+
+#if CHESSPP_HAS_EXCEPTIONS
+    EXPECT_THROW(test_command.parse_arguments(tokens, arguments), chesspp::ArgumentParseException);
+#endif
+}
+
+TEST(Command, parse_arguments_view_test_missing_required)
+{
+    std::vector<chesspp::ArgumentDefinition> accpeted_arguments = {
+        chesspp::ArgumentDefinition({"value1", "value2"}, 0, true),
+        chesspp::ArgumentDefinition({"value6"}, 3)};
+
+    chesspp::Command const test_command("test_command", accpeted_arguments);
+    std::vector<std::string_view> tokens = {"value6", "param0", "param1", "param2"};
+    std::vector<chesspp::ArgumentView> arguments;
+
+#if CHESSPP_HAS_EXCEPTIONS
+    EXPECT_THROW(test_command.parse_arguments(tokens, arguments), chesspp::MissingArgumentException);
+#endif
+}
+
+/*******************************************************************************
+ *                      Test the argument definition index
+*******************************************************************************/
+
+TEST(Command, parse_arguments_test_duplicate_value_uses_first_definition)
+{
+    std::vector<chesspp::ArgumentDefinition> accpeted_arguments = {
+        chesspp::ArgumentDefinition({"value1", "shared"}, 1, true),
+        chesspp::ArgumentDefinition({"shared", "value2"}, 0)};
+
+    chesspp::Command const test_command("test_command", accpeted_arguments);
+    std::vector<std::string> args = {"shared", "param0"};
+    std::vector<chesspp::Argument> arguments = test_command.parse_arguments(args);
+    EXPECT_EQ("shared", arguments[0].value);
+    EXPECT_EQ("param0", arguments[0].parameters[0]);
+    EXPECT_EQ(1, arguments.size());
+}
+
+TEST(Command, parse_arguments_test_many_definitions)
+{
+    // Required arguments beyond the first few definitions are still checked.
+    std::vector<chesspp::ArgumentDefinition> accpeted_arguments;
+    for (int i = 0; i < 64; i++)
+    {
+        accpeted_arguments.push_back(
+            chesspp::ArgumentDefinition({"value" + std::to_string(i)}, 0, i == 63));
+    }
+
+    chesspp::Command const test_command("test_command", accpeted_arguments);
+    std::vector<std::string> good_args = {"value5", "value63"};
+    EXPECT_EQ(2, test_command.parse_arguments(good_args).size());
+
+    std::vector<std::string> bad_args = {"value5", "value62"};
+#if CHESSPP_HAS_EXCEPTIONS
+    EXPECT_THROW(test_command.parse_arguments(bad_args), chesspp::MissingArgumentException);
+#endif
+}
+
+TEST(Command, construct_test_too_many_definitions)
+{
+    std::vector<chesspp::ArgumentDefinition> accpeted_arguments;
+    for (int i = 0; i < 65; i++)
+    {
+        accpeted_arguments.push_back(
+            chesspp::ArgumentDefinition({"value" + std::to_string(i)}, 0));
+    }
+
+#if CHESSPP_HAS_EXCEPTIONS
+    EXPECT_THROW(
+        chesspp::Command("test_command", accpeted_arguments),
+        chesspp::TooManyArgumentDefinitionsException);
+#endif
+}
+
+TEST(Command, parse_arguments_test_copied_command)
+{
+    std::vector<chesspp::ArgumentDefinition> accpeted_arguments = {
+        chesspp::ArgumentDefinition({"on", "off"}, 0, true)};
+
+    std::vector<chesspp::Command> commands;
+    {
+        chesspp::Command const original("debug", accpeted_arguments);
+        commands.push_back(original);
+    }
+
+    std::vector<std::string> args = {"off"};
+    EXPECT_EQ("off", commands[0].parse_arguments(args)[0].value);
+}
+
+TEST(Command, parse_arguments_test_any_value_argument)
+{
+    std::vector<chesspp::ArgumentDefinition> accpeted_arguments = {
+        chesspp::ArgumentDefinition({}, 0, true),
+        chesspp::ArgumentDefinition({"ponder"}, 1)};
+
+    chesspp::Command const test_command("bestmove", accpeted_arguments);
+    std::vector<std::string> args = {"e2e4", "ponder", "e7e5"};
+    std::vector<chesspp::Argument> arguments = test_command.parse_arguments(args);
+    EXPECT_EQ("e2e4", arguments[0].value);
+    EXPECT_EQ("ponder", arguments[1].value);
+    EXPECT_EQ("e7e5", arguments[1].parameters[0]);
+    EXPECT_EQ(2, arguments.size());
+
+    // Only the leading token can take any value
+    std::vector<std::string> bad_args = {"e2e4", "e7e5"};
+#if CHESSPP_HAS_EXCEPTIONS
+    EXPECT_THROW(test_command.parse_arguments(bad_args), chesspp::ArgumentParseException);
+#endif
+}
+
+/*******************************************************************************
+ *                  Test try_parse_arguments( ... ) without exceptions
+*******************************************************************************/
+
+TEST(Command, try_parse_arguments_test_success)
+{
+    chesspp::Command const test_command("debug", {chesspp::ArgumentDefinition({"on", "off"}, 0, true)});
+    std::vector<std::string_view> tokens = {"on"};
+    std::vector<chesspp::ArgumentView> arguments;
+
+    chesspp::ParseResult<std::vector<chesspp::ArgumentView>> const result =
+        test_command.try_parse_arguments(tokens, arguments);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(&arguments, &result.value());
+    EXPECT_EQ("on", result->at(0).value);
+    EXPECT_EQ(chesspp::ParseErrorCode::none, result.error().code);
+}
+
+TEST(Command, try_parse_arguments_test_error_offsets)
+{
+    std::vector<chesspp::ArgumentDefinition> accpeted_arguments = {
+        chesspp::ArgumentDefinition({"value1", "value2"}, 0, true),
+        chesspp::ArgumentDefinition({"value6"}, 3)};
+    chesspp::Command const test_command("test_command", accpeted_arguments);
+    std::vector<chesspp::ArgumentView> arguments;
+
+    // The tokens refer into one line, so offsets are positions in it
+    std::string_view const bad_name = "bad-value value1";
+    std::vector<std::string_view> tokens = {bad_name.substr(0, 9), bad_name.substr(10)};
+    chesspp::ParseResult<std::vector<chesspp::ArgumentView>> result =
+        test_command.try_parse_arguments(tokens, arguments);
+    EXPECT_FALSE(result);
+    EXPECT_EQ(chesspp::ParseErrorCode::unparsable_arguments, result.error().code);
+    EXPECT_EQ(0, result.error().offset);
+
+    // The last of the tokens that belong to no argument, not the first
+    std::string_view const two_bad = "bad value value1";
+    std::vector<std::string_view> two_bad_tokens;
+    chesspp::Parser::tokenise(two_bad, two_bad_tokens);
+    result = test_command.try_parse_arguments(two_bad_tokens, arguments);
+    EXPECT_EQ(chesspp::ParseErrorCode::unparsable_arguments, result.error().code);
+    EXPECT_EQ(two_bad.find("value"), result.error().offset);
+
+    std::string_view const extra_parameter = "value1 value6 a b c d";
+    std::vector<std::string_view> extra_tokens;
+    chesspp::Parser::tokenise(extra_parameter, extra_tokens);
+    result = test_command.try_parse_arguments(extra_tokens, arguments);
+    EXPECT_EQ(chesspp::ParseErrorCode::unparsable_arguments, result.error().code);
+    EXPECT_EQ(extra_parameter.find("d"), result.error().offset);
+
+    std::string_view const missing = "value6 a b c";
+    std::vector<std::string_view> missing_tokens;
+    chesspp::Parser::tokenise(missing, missing_tokens);
+    result = test_command.try_parse_arguments(missing_tokens, arguments);
+    EXPECT_EQ(chesspp::ParseErrorCode::missing_argument, result.error().code);
+    EXPECT_EQ(missing.size(), result.error().offset);
+}
+
+TEST(Command, try_parse_arguments_test_static_command)
+{
+    std::vector<std::string_view> tokens;
+    std::vector<chesspp::ArgumentView> arguments;
+
+    chesspp::Parser::tokenise("joho on", tokens);
+    chesspp::ParseResult<std::vector<chesspp::ArgumentView>> result =
+        chesspp::StaticCommand<chesspp::grammar::debug>::try_parse_arguments(tokens, arguments);
+    EXPECT_EQ(chesspp::ParseErrorCode::unparsable_arguments, result.error().code);
+    EXPECT_EQ(0, result.error().offset);
+
+    chesspp::Parser::tokenise("ponder e7e5", tokens);
+    result = chesspp::StaticCommand<chesspp::grammar::bestmove>::try_parse_arguments(tokens, arguments);
+    EXPECT_EQ(chesspp::ParseErrorCode::missing_argument, result.error().code);
+    EXPECT_EQ(11, result.error().offset);
+
+    chesspp::Parser::tokenise("wtime 10 btime", tokens);
+    result = chesspp::StaticCommand<chesspp::grammar::go>::try_parse_arguments(tokens, arguments);
+    EXPECT_EQ(chesspp::ParseErrorCode::unparsable_arguments, result.error().code);
+    EXPECT_EQ(9, result.error().offset);
+}
+
+/*******************************************************************************
+ *                                Test run( ... )
+*******************************************************************************/
+
+TEST(Command, run_test_callback_with_captured_state)
+{
+    chesspp::Command test_command("debug", {chesspp::ArgumentDefinition({"on", "off"}, 0, true)});
+    EXPECT_FALSE(test_command.has_callback());
+
+    bool debug = false;
+    test_command.attach_callback([&debug](chesspp::ArgumentSpan arguments) {
+        debug = arguments[0].value == "on";
+    });
+    ASSERT_TRUE(test_command.has_callback());
+
+    std::vector<std::string_view> tokens = {"on"};
+    std::vector<chesspp::ArgumentView> arguments;
+    test_command.run(test_command.parse_arguments(tokens, arguments));
+    EXPECT_TRUE(debug);
+}
+
+TEST(Command, run_test_function_pointer_gets_copies)
+{
+    chesspp::Command test_command("debug", {chesspp::ArgumentDefinition({"on", "off"}, 0, true)});
+    static std::string received;
+    test_command.attach_callback(+[](std::vector<chesspp::Argument> arguments) {
+        received = arguments[0].value;
+    });
+
+    std::vector<std::string_view> tokens = {"off"};
+    std::vector<chesspp::ArgumentView> arguments;
+    test_command.run(test_command.parse_arguments(tokens, arguments));
+    EXPECT_EQ("off", received);
+
+    test_command.attach_callback(static_cast<void (*)(std::vector<chesspp::Argument>)>(nullptr));
+    EXPECT_FALSE(test_command.has_callback());
+}
+
+TEST(Command, run_test_no_allocations)
+{
+    chesspp::Command test_command("position", {
+        chesspp::ArgumentDefinition({"startpos"}, 0),
+        chesspp::ArgumentDefinition({"moves"}, -1)});
+
+    size_t num_moves = 0;
+    test_command.attach_callback([&num_moves](chesspp::ArgumentSpan arguments) {
+        num_moves = arguments[1].parameters.size();
+    });
+
+    std::vector<std::string_view> const tokens = {"startpos", "moves", "e2e4", "e7e5", "g1f3"};
+    std::vector<chesspp::ArgumentView> arguments;
+    test_command.parse_arguments(tokens, arguments);
+
+    size_t const before = test_support::allocation_count();
+    for (int i = 0; i < 100; i++)
+    {
+        test_command.run(arguments);
+    }
+    EXPECT_EQ(before, test_support::allocation_count());
+    EXPECT_EQ(3, num_moves);
 }
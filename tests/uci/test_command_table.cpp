@@ -0,0 +1,139 @@
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "uci/command/command_table.hpp"
+#include "uci/command/grammar.hpp"
+
+/*******************************************************************************
+ *                          Test the perfect hash
+*******************************************************************************/
+
+namespace
+{
+/**
+ * @brief Checks at compile time that every standard name has its own slot
+ *
+ */
+constexpr bool standard_slots_are_unique()
+{
+    bool used[chesspp::standard_hash::num_slots] = {};
+    for (std::string_view const name : chesspp::standard_hash::names)
+    {
+        size_t const slot = chesspp::standard_hash::slot(name);
+        if (used[slot])
+        {
+            return false;
+        }
+        used[slot] = true;
+    }
+    return true;
+}
+} // namespace
+
+static_assert(standard_slots_are_unique());
+static_assert(std::size(chesspp::standard_hash::names) == 19);
+static_assert(chesspp::standard_hash::is_standard("ponderhit"));
+static_assert(not chesspp::standard_hash::is_standard("ponder"));
+static_assert(not chesspp::standard_hash::is_standard(""));
+
+/*******************************************************************************
+ *                          Test the command table
+*******************************************************************************/
+
+TEST(CommandTable, find_test_standard)
+{
+    chesspp::CommandTable table;
+    table.add(chesspp::grammar::go.to_command());
+    table.add(chesspp::grammar::stop.to_command());
+
+    ASSERT_NE(nullptr, table.find("go"));
+    EXPECT_EQ("go", table.find("go")->get_name());
+    EXPECT_EQ("stop", table.find("stop")->get_name());
+    EXPECT_EQ(nullptr, table.find("quit"));
+    EXPECT_EQ(nullptr, table.find("g"));
+    EXPECT_EQ(nullptr, table.find(""));
+    EXPECT_EQ(2, table.size());
+}
+
+TEST(CommandTable, find_test_name_sharing_a_slot)
+{
+    // "gx" has the same length and first character as "go" but is not a
+    // standard command, so it must not be mistaken for it
+    chesspp::CommandTable table;
+    table.add(chesspp::grammar::go.to_command());
+    EXPECT_EQ(nullptr, table.find("gx"));
+    EXPECT_EQ(nullptr, table.find("gooo"));
+}
+
+TEST(CommandTable, find_test_custom)
+{
+    chesspp::CommandTable table;
+    table.add(chesspp::grammar::go.to_command());
+    table.add(chesspp::Command("perft", {chesspp::ArgumentDefinition({}, 0)}));
+
+    ASSERT_NE(nullptr, table.find("perft"));
+    EXPECT_EQ("perft", table.find("perft")->get_name());
+    EXPECT_EQ("go", table.find("go")->get_name());
+    EXPECT_EQ(nullptr, table.find("perf"));
+}
+
+TEST(CommandTable, add_test_duplicate)
+{
+    chesspp::CommandTable table;
+    EXPECT_NE(nullptr, table.add(chesspp::grammar::go.to_command()));
+    EXPECT_EQ(nullptr, table.add(chesspp::grammar::go.to_command()));
+    EXPECT_NE(nullptr, table.add(chesspp::Command("perft", {})));
+    EXPECT_EQ(nullptr, table.add(chesspp::Command("perft", {})));
+    EXPECT_EQ(2, table.size());
+}
+
+TEST(CommandTable, add_test_many_custom)
+{
+    // Enough commands to grow the overflow table several times. Pointers
+    // handed out before a grow must stay valid.
+    chesspp::CommandTable table;
+    chesspp::Command *go = table.add(chesspp::grammar::go.to_command());
+    chesspp::Command *first = table.add(chesspp::Command("custom0", {}));
+
+    for (int i = 1; i < 1000; i++)
+    {
+        ASSERT_NE(nullptr, table.add(chesspp::Command("custom" + std::to_string(i), {})));
+    }
+
+    for (int i = 0; i < 1000; i++)
+    {
+        std::string const name = "custom" + std::to_string(i);
+        ASSERT_NE(nullptr, table.find(name));
+        EXPECT_EQ(name, table.find(name)->get_name());
+    }
+    EXPECT_EQ(go, table.find("go"));
+    EXPECT_EQ(first, table.find("custom0"));
+    EXPECT_EQ(nullptr, table.find("custom1000"));
+    EXPECT_EQ(1001, table.size());
+}
+
+static_assert(not std::is_copy_constructible_v<chesspp::CommandTable>);
+static_assert(not std::is_copy_assignable_v<chesspp::CommandTable>);
+
+TEST(CommandTable, move_test_keeps_commands)
+{
+    chesspp::CommandTable table;
+    chesspp::Command *go = table.add(chesspp::grammar::go.to_command());
+    chesspp::Command *perft = table.add(chesspp::Command("perft", {}));
+
+    chesspp::CommandTable moved(std::move(table));
+    EXPECT_EQ(go, moved.find("go"));
+    EXPECT_EQ(perft, moved.find("perft"));
+
+    chesspp::CommandTable assigned;
+    assigned.add(chesspp::grammar::stop.to_command());
+    assigned = std::move(moved);
+    EXPECT_EQ(go, assigned.find("go"));
+    EXPECT_EQ(perft, assigned.find("perft"));
+    EXPECT_EQ(nullptr, assigned.find("stop"));
+    EXPECT_EQ(2, assigned.size());
+}
@@ -1,7 +1,11 @@
+#include <atomic>
+#include <chrono>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "pipe_input.hpp"
 #include "uci/engine.hpp"
 
 // TEST(Engine, Tokenise_test_generic) {
@@ -11,4 +15,443 @@
 //     EXPECT_EQ("is", tokens[1]);
 //     EXPECT_EQ("a", tokens[2]);
 //     EXPECT_EQ("test", tokens[3]);
-// }
\ No newline at end of file
+// }
+namespace
+{
+using test_support::PipeInput;
+
+/**
+ * @brief The engine under test, so that callbacks can poll it
+ *
+ */
+chesspp::Engine *engine_under_test = nullptr;
+
+/**
+ * @brief The names of the commands the callbacks were run for, in order
+ *
+ */
+std::vector<std::string> received;
+
+/**
+ * @brief The arguments of the last `position` command
+ *
+ */
+std::vector<chesspp::Argument> position_arguments;
+
+void record_debug(std::vector<chesspp::Argument> arguments)
+{
+    received.push_back("debug " + arguments[0].value);
+}
+
+void record_isready(std::vector<chesspp::Argument>)
+{
+    received.push_back("isready");
+}
+
+void record_position(std::vector<chesspp::Argument> arguments)
+{
+    received.push_back("position");
+    position_arguments = arguments;
+}
+
+/**
+ * @brief The position deltas received, as "reset:move,move" or "+move,move"
+ *
+ */
+std::vector<std::string> position_deltas;
+
+void record_position_delta(chesspp::PositionDelta const &delta)
+{
+    std::string text = delta.reset ? "reset:" : "+";
+    for (std::string_view const move : delta.moves)
+    {
+        text += std::string(move) + ",";
+    }
+    position_deltas.push_back(text);
+}
+
+/**
+ * @brief The limits of the last `go` received by record_go
+ *
+ */
+chesspp::SearchLimits go_limits;
+
+void record_go(chesspp::SearchLimits const &limits)
+{
+    received.push_back("go");
+    go_limits = limits;
+}
+
+void search_until_stopped(std::vector<chesspp::Argument>)
+{
+    // Emulate a search that only ends when told to
+    while (not engine_under_test->stop_requested())
+    {
+        std::this_thread::yield();
+    }
+    received.push_back("go");
+}
+
+void record_stop(std::vector<chesspp::Argument>)
+{
+    received.push_back("stop");
+}
+
+void record_quit(std::vector<chesspp::Argument>)
+{
+    received.push_back("quit");
+}
+
+/**
+ * @brief Records when it was first written to
+ *
+ */
+struct FirstWriteSink : chesspp::OutputSink
+{
+    std::atomic<bool> written{false};
+    std::chrono::steady_clock::time_point at;
+
+    void write(std::string_view) override
+    {
+        if (not written.load())
+        {
+            at = std::chrono::steady_clock::now();
+            written.store(true);
+        }
+    }
+};
+} // namespace
+
+TEST(Engine, start_test_runs_callbacks_in_order)
+{
+    PipeInput input(
+        "isready\n"
+        "   debug     on  \n"
+        "joho debug off\n"
+        "debug joho on\n"
+        "nonsense\n"
+        "position startpos moves e2e4 e7e5\n");
+    chesspp::Engine engine(input.fd());
+    engine.register_command("debug", record_debug);
+    engine.register_command("isready", record_isready);
+    engine.register_command("position", record_position);
+    received.clear();
+
+    engine.start();
+
+    std::vector<std::string> const expected = {"isready", "debug on", "debug off", "position"};
+    EXPECT_EQ(expected, received);
+    EXPECT_EQ("startpos", position_arguments[0].value);
+    EXPECT_EQ("moves", position_arguments[1].value);
+    EXPECT_EQ("e7e5", position_arguments[1].parameters[1]);
+}
+
+TEST(Engine, start_test_position_callback_gets_new_moves)
+{
+    PipeInput input(
+        "position startpos moves e2e4\n"
+        "position startpos moves e2e4 e7e5 g1f3\n"
+        "position startpos moves e2e4 e7e5 g1f3\n"
+        "ucinewgame\n"
+        "position startpos moves e2e4 e7e5 g1f3 b8c6\n"
+        "position startpos moves d2d4\n");
+    chesspp::Engine engine(input.fd());
+    engine.register_position_callback(record_position_delta);
+    position_deltas.clear();
+
+    engine.start();
+
+    std::vector<std::string> const expected = {
+        "reset:e2e4,", "+e7e5,g1f3,", "+", "reset:e2e4,e7e5,g1f3,b8c6,", "reset:d2d4,"};
+    EXPECT_EQ(expected, position_deltas);
+}
+
+TEST(Engine, start_test_go_callback_gets_search_limits)
+{
+    PipeInput input(
+        "go wtime 1x00\n"
+        "go wtime 60000 btime 59000 searchmoves e2e4 d2d4\n");
+    chesspp::Engine engine(input.fd());
+    engine.register_go_callback(record_go);
+    received.clear();
+
+    engine.start();
+
+    // The malformed go is ignored
+    EXPECT_EQ(std::vector<std::string>{"go"}, received);
+    EXPECT_EQ(60000, go_limits.wtime);
+    EXPECT_EQ(59000, go_limits.btime);
+    EXPECT_EQ(2, go_limits.searchmoves.size());
+}
+
+TEST(Engine, start_test_callbacks_with_captured_state)
+{
+    PipeInput input("isready\nposition startpos moves e2e4 e7e5\ngo depth 3\nisready\n");
+    chesspp::Engine engine(input.fd());
+
+    int ready = 0;
+    std::vector<std::string> moves;
+    int64_t depth = 0;
+    engine.register_command("isready", [&ready](chesspp::ArgumentSpan) { ready++; });
+    engine.register_command("position", [&moves](chesspp::ArgumentSpan arguments) {
+        for (std::string_view const move : arguments[1].parameters)
+        {
+            moves.emplace_back(move);
+        }
+    });
+    engine.register_go_callback([&depth](chesspp::SearchLimits const &limits) { depth = limits.depth; });
+
+    engine.start();
+
+    EXPECT_EQ(2, ready);
+    EXPECT_EQ((std::vector<std::string>{"e2e4", "e7e5"}), moves);
+    EXPECT_EQ(3, depth);
+}
+
+TEST(Engine, register_command_test_unknown_command)
+{
+    PipeInput input("");
+    chesspp::Engine engine(input.fd());
+    EXPECT_FALSE(engine.register_command("joho", record_isready));
+    EXPECT_TRUE(engine.register_command("isready", record_isready));
+}
+
+TEST(Engine, add_command_test_custom_command)
+{
+    PipeInput input("perft 5\nisready\nperft\n");
+    chesspp::Engine engine(input.fd());
+
+    std::vector<std::string> depths;
+    EXPECT_TRUE(engine.add_command(chesspp::Command("perft", {chesspp::ArgumentDefinition({}, 0, true)})));
+    EXPECT_FALSE(engine.add_command(chesspp::Command("isready", {})));
+    engine.register_command("perft", [&depths](chesspp::ArgumentSpan arguments) {
+        depths.emplace_back(arguments[0].value);
+    });
+
+    engine.start();
+
+    // The perft without a depth is missing its required argument
+    EXPECT_EQ(std::vector<std::string>{"5"}, depths);
+}
+
+TEST(Engine, start_test_stop_reaches_search)
+{
+    PipeInput input("go infinite\nstop\nquit\nisready\n");
+    chesspp::Engine engine(input.fd());
+    engine.register_command("isready", record_isready);
+    engine.register_command("go", search_until_stopped);
+    engine.register_command("stop", record_stop);
+    engine.register_command("quit", record_quit);
+    engine_under_test = &engine;
+    received.clear();
+
+    engine.start();
+
+    // Nothing after quit is read
+    std::vector<std::string> const expected = {"go", "stop", "quit"};
+    EXPECT_EQ(expected, received);
+    EXPECT_TRUE(engine.quit_requested());
+}
+
+TEST(Engine, start_test_stop_reaches_search_when_queue_is_full)
+{
+    // Send more commands than fit in the queue while the search is running
+    std::string lines = "go infinite\n";
+    for (int i = 0; i < 200; i++)
+    {
+        lines += "isready\n";
+    }
+    lines += "stop\n";
+
+    PipeInput input(lines);
+    chesspp::Engine engine(input.fd());
+    engine.register_command("isready", record_isready);
+    engine.register_command("go", search_until_stopped);
+    engine.register_command("stop", record_stop);
+    engine_under_test = &engine;
+    received.clear();
+
+    engine.start();
+
+    EXPECT_EQ(202, received.size());
+    EXPECT_EQ("go", received.front());
+    EXPECT_EQ("stop", received.back());
+}
+
+TEST(Engine, start_test_go_clears_stop)
+{
+    PipeInput input("stop\nponderhit\ngo\n");
+    chesspp::Engine engine(input.fd());
+    engine.start();
+
+    EXPECT_FALSE(engine.stop_requested());
+    EXPECT_FALSE(engine.ponderhit_received());
+}
+
+TEST(Engine, start_test_stop_survives_next_go)
+{
+    // Read in one go, so the second `go` is read while the first search runs
+    PipeInput input("go infinite\nponderhit\nstop\ngo depth 1\nquit\n");
+    chesspp::Engine engine(input.fd());
+    std::vector<bool> stopped;
+    std::vector<bool> ponderhits;
+    engine.register_command("go", [&engine, &stopped, &ponderhits](chesspp::ArgumentSpan) {
+        auto const give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (stopped.empty() and not engine.stop_requested() and
+               std::chrono::steady_clock::now() < give_up)
+        {
+            std::this_thread::yield();
+        }
+        stopped.push_back(engine.stop_requested());
+        ponderhits.push_back(engine.ponderhit_received());
+    });
+
+    engine.start();
+
+    EXPECT_EQ(std::vector<bool>({true, false}), stopped);
+    EXPECT_EQ(std::vector<bool>({true, false}), ponderhits);
+    EXPECT_EQ(2, engine.get_running_search());
+}
+
+TEST(Engine, start_test_stop_reaches_earlier_searches)
+{
+    // Both stops are read before the first search polls
+    PipeInput input("go infinite\nstop\ngo infinite\nstop\nquit\n");
+    chesspp::Engine engine(input.fd());
+    std::vector<bool> stopped;
+    engine.register_command("go", [&engine, &stopped](chesspp::ArgumentSpan) {
+        auto const give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (not engine.stop_requested() and std::chrono::steady_clock::now() < give_up)
+        {
+            std::this_thread::yield();
+        }
+        stopped.push_back(engine.stop_requested());
+    });
+
+    engine.start();
+
+    EXPECT_EQ(std::vector<bool>({true, true}), stopped);
+}
+
+TEST(Engine, start_test_output_flushed_during_long_callback)
+{
+    PipeInput input("go infinite\nquit\n");
+    FirstWriteSink sink;
+    chesspp::OutputWriter output(sink, 4096, std::chrono::milliseconds(10));
+    chesspp::Engine engine(input.fd(), output);
+    std::chrono::steady_clock::time_point sent;
+    engine.register_command("go", [&engine, &sink, &sent](chesspp::ArgumentSpan) {
+        sent = std::chrono::steady_clock::now();
+        engine.get_output().write("info", std::vector<std::string>{"depth", "1"});
+
+        // A long search that writes nothing else
+        auto const give_up = sent + std::chrono::milliseconds(500);
+        while (not sink.written.load() and std::chrono::steady_clock::now() < give_up)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    engine.start();
+
+    ASSERT_TRUE(sink.written.load());
+    EXPECT_LT(sink.at - sent, std::chrono::milliseconds(250));
+}
+
+TEST(Engine, start_test_records_session)
+{
+    PipeInput input(
+        "isready\n"
+        "nonsense\n"
+        "quit\n");
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink, 4096, std::chrono::hours(1));
+    chesspp::Engine engine(input.fd(), output);
+    chesspp::StringSink log;
+    chesspp::Recorder recorder(log);
+    engine.set_recorder(&recorder);
+    engine.register_command("isready", [&output](chesspp::ArgumentSpan) {
+        output.write("readyok", std::vector<std::string>());
+    });
+
+    engine.start();
+
+    // Everything is flushed by the time start() returns. The reader thread
+    // runs ahead of the callbacks, so only the order within each direction
+    // is fixed.
+    chesspp::LogReader reader(log.data);
+    chesspp::LogRecord record;
+    std::vector<std::string> received_lines;
+    std::vector<std::string> sent_lines;
+    while (reader.next(record))
+    {
+        (record.direction == chesspp::Direction::to_engine ? received_lines : sent_lines)
+            .emplace_back(record.line);
+    }
+    std::vector<std::string> const expected_received = {"isready", "nonsense", "quit"};
+    std::vector<std::string> const expected_sent = {"readyok"};
+    EXPECT_EQ(expected_received, received_lines);
+    EXPECT_EQ(expected_sent, sent_lines);
+    EXPECT_FALSE(reader.is_malformed());
+    EXPECT_EQ("readyok\n", sink.data);
+}
+
+TEST(Engine, start_test_announces_and_sets_options)
+{
+    PipeInput input(
+        "uci\n"
+        "setoption name hash value 64\n"
+        "setoption name Hash value 1000000\n"
+        "quit\n");
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink, 4096, std::chrono::hours(1));
+    chesspp::Engine engine(input.fd(), output);
+    chesspp::SpinOption *hash = engine.get_options().add_spin("Hash", 16, 1, 1024);
+    engine.get_options().add_check("Ponder", false);
+    engine.register_command("uci", [&engine, &output](chesspp::ArgumentSpan) {
+        output.write("id", std::vector<std::string>{"name", "Test"});
+        output.write("id", std::vector<std::string>{"author", "Chess++"});
+        engine.announce_options();
+        output.write("uciok", std::vector<std::string>());
+    });
+    int64_t hash_seen = 0;
+    engine.register_command("setoption", [&hash_seen, hash](chesspp::ArgumentSpan) {
+        hash_seen = hash->get();
+    });
+
+    engine.start();
+
+    EXPECT_EQ("id name Test\n"
+              "id author Chess++\n"
+              "option name Hash type spin default 16 min 1 max 1024\n"
+              "option name Ponder type check default false\n"
+              "uciok\n",
+              sink.data);
+    EXPECT_EQ(64, hash->get());
+    EXPECT_EQ(64, hash_seen);
+}
+
+TEST(Engine, start_test_announces_options_after_uci_callback)
+{
+    // Twice, to check each `uci` gets its own announcement
+    PipeInput input(
+        "uci\n"
+        "uci\n"
+        "quit\n");
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink, 4096, std::chrono::hours(1));
+    chesspp::Engine engine(input.fd(), output);
+    engine.get_options().add_check("Ponder", false);
+    engine.register_command("uci", [&output](chesspp::ArgumentSpan) {
+        output.write("id", std::vector<std::string>{"name", "Test"});
+    });
+
+    engine.start();
+    output.flush();
+
+    EXPECT_EQ("id name Test\n"
+              "option name Ponder type check default false\n"
+              "id name Test\n"
+              "option name Ponder type check default false\n",
+              sink.data);
+}
@@ -0,0 +1,121 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "uci/command/grammar.hpp"
+#include "uci/parser.hpp"
+
+/*******************************************************************************
+ *                          Test the grammar tables
+*******************************************************************************/
+
+static_assert(chesspp::StaticCommand<chesspp::grammar::go>::find_argument("wtime").index == 2);
+static_assert(chesspp::StaticCommand<chesspp::grammar::go>::find_argument("wtime").num_parameters == 1);
+static_assert(chesspp::StaticCommand<chesspp::grammar::go>::find_argument("e2e4").index == -1);
+static_assert(chesspp::StaticCommand<chesspp::grammar::debug>::required_arguments == 1);
+static_assert(chesspp::StaticCommand<chesspp::grammar::info>::name == "info");
+static_assert(not chesspp::make_grammar("bad", {{{"x"}, 0}, {{"y", "x"}, 0}}).is_valid());
+
+TEST(Grammar, parse_arguments_test_go)
+{
+    std::vector<std::string_view> tokens;
+    chesspp::Parser::tokenise("wtime 300000 btime 299000 winc 2000 binc 2000 infinite", tokens);
+    std::vector<chesspp::ArgumentView> arguments;
+    chesspp::StaticCommand<chesspp::grammar::go>::parse_arguments(tokens, arguments);
+
+    EXPECT_EQ("wtime", arguments[0].value);
+    EXPECT_EQ("300000", arguments[0].parameters[0]);
+    EXPECT_EQ("binc", arguments[3].value);
+    EXPECT_EQ("2000", arguments[3].parameters[0]);
+    EXPECT_EQ("infinite", arguments[4].value);
+    EXPECT_TRUE(arguments[4].parameters.empty());
+    EXPECT_EQ(5, arguments.size());
+}
+
+TEST(Grammar, parse_arguments_test_position)
+{
+    std::vector<std::string_view> tokens;
+    chesspp::Parser::tokenise("startpos moves e2e4 e7e5 g1f3", tokens);
+    std::vector<chesspp::ArgumentView> arguments;
+    chesspp::StaticCommand<chesspp::grammar::position>::parse_arguments(tokens, arguments);
+
+    EXPECT_EQ("startpos", arguments[0].value);
+    EXPECT_EQ("moves", arguments[1].value);
+    EXPECT_EQ(3, arguments[1].parameters.size());
+    EXPECT_EQ("g1f3", arguments[1].parameters[2]);
+    EXPECT_EQ(2, arguments.size());
+}
+
+TEST(Grammar, parse_arguments_test_bestmove)
+{
+    std::vector<std::string_view> tokens;
+    std::vector<chesspp::ArgumentView> arguments;
+
+    chesspp::Parser::tokenise("e2e4 ponder e7e5", tokens);
+    chesspp::StaticCommand<chesspp::grammar::bestmove>::parse_arguments(tokens, arguments);
+    EXPECT_EQ("e2e4", arguments[0].value);
+    EXPECT_EQ("ponder", arguments[1].value);
+    EXPECT_EQ("e7e5", arguments[1].parameters[0]);
+    EXPECT_EQ(2, arguments.size());
+
+    chesspp::Parser::tokenise("0000", tokens);
+    chesspp::StaticCommand<chesspp::grammar::bestmove>::parse_arguments(tokens, arguments);
+    EXPECT_EQ("0000", arguments[0].value);
+    EXPECT_EQ(1, arguments.size());
+
+    chesspp::Parser::tokenise("ponder e7e5", tokens);
+#if CHESSPP_HAS_EXCEPTIONS
+    EXPECT_THROW(
+        chesspp::StaticCommand<chesspp::grammar::bestmove>::parse_arguments(tokens, arguments),
+        chesspp::MissingArgumentException);
+#endif
+}
+
+TEST(Grammar, parse_arguments_test_errors)
+{
+    std::vector<std::string_view> tokens;
+    std::vector<chesspp::ArgumentView> arguments;
+
+    chesspp::Parser::tokenise("joho on", tokens);
+#if CHESSPP_HAS_EXCEPTIONS
+    EXPECT_THROW(
+        chesspp::StaticCommand<chesspp::grammar::debug>::parse_arguments(tokens, arguments),
+        chesspp::ArgumentParseException);
+#endif
+
+    chesspp::Parser::tokenise("value 3", tokens);
+#if CHESSPP_HAS_EXCEPTIONS
+    EXPECT_THROW(
+        chesspp::StaticCommand<chesspp::grammar::setoption>::parse_arguments(tokens, arguments),
+        chesspp::MissingArgumentException);
+#endif
+}
+
+TEST(Grammar, to_command_test_matches_static_command)
+{
+    std::vector<std::string> const lines = {
+        "depth 12 seldepth 20 score cp 35 nodes 123456 nps 100000 pv e2e4 e7e5 g1f3",
+        "score mate -3 lowerbound time 1242",
+        "currmove e2e4 currmovenumber 1",
+        "string hello world"};
+
+    chesspp::Command const command = chesspp::StaticCommand<chesspp::grammar::info>::to_command();
+    std::vector<std::string_view> tokens;
+    std::vector<chesspp::ArgumentView> expected;
+    std::vector<chesspp::ArgumentView> arguments;
+    for (std::string const &line : lines)
+    {
+        chesspp::Parser::tokenise(line, tokens);
+        command.parse_arguments(tokens, expected);
+        chesspp::StaticCommand<chesspp::grammar::info>::parse_arguments(tokens, arguments);
+
+        ASSERT_EQ(expected.size(), arguments.size()) << line;
+        for (size_t i = 0; i < arguments.size(); i++)
+        {
+            EXPECT_EQ(expected[i].value, arguments[i].value);
+            EXPECT_EQ(expected[i].parameters.begin(), arguments[i].parameters.begin());
+            EXPECT_EQ(expected[i].parameters.size(), arguments[i].parameters.size());
+        }
+    }
+}
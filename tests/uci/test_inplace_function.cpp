@@ -0,0 +1,117 @@
+#include <array>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "chesspp/inplace_function.hpp"
+
+namespace
+{
+/**
+ * @brief Counts how many copies of it are alive
+ *
+ */
+struct Counted
+{
+    static int alive;
+
+    int value;
+
+    explicit Counted(int value) : value(value)
+    {
+        alive++;
+    }
+
+    Counted(Counted const &other) : value(other.value)
+    {
+        alive++;
+    }
+
+    ~Counted()
+    {
+        alive--;
+    }
+
+    int operator()(int x) const
+    {
+        return value + x;
+    }
+};
+
+int Counted::alive = 0;
+
+int twice(int x)
+{
+    return 2 * x;
+}
+} // namespace
+
+TEST(InplaceFunction, call_test_function_pointer)
+{
+    chesspp::InplaceFunction<int(int)> function = twice;
+    ASSERT_TRUE(function);
+    EXPECT_EQ(42, function(21));
+
+    int (*null_function)(int) = nullptr;
+    EXPECT_FALSE(chesspp::InplaceFunction<int(int)>(null_function));
+    EXPECT_FALSE(chesspp::InplaceFunction<int(int)>());
+    EXPECT_FALSE(chesspp::InplaceFunction<int(int)>(nullptr));
+}
+
+TEST(InplaceFunction, call_test_captured_state)
+{
+    int calls = 0;
+    std::string last;
+    chesspp::InplaceFunction<void(std::string const &)> function =
+        [&calls, &last](std::string const &text) {
+            calls++;
+            last = text;
+        };
+
+    function("e2e4");
+    function("e7e5");
+    EXPECT_EQ(2, calls);
+    EXPECT_EQ("e7e5", last);
+
+    // A mutable lambda keeps its state between calls
+    chesspp::InplaceFunction<int()> counter = [count = 0]() mutable { return ++count; };
+    counter();
+    EXPECT_EQ(2, counter());
+}
+
+TEST(InplaceFunction, copy_test_lifetimes)
+{
+    {
+        chesspp::InplaceFunction<int(int)> function = Counted(10);
+        EXPECT_EQ(1, Counted::alive);
+
+        chesspp::InplaceFunction<int(int)> copy = function;
+        EXPECT_EQ(2, Counted::alive);
+        EXPECT_EQ(15, copy(5));
+
+        chesspp::InplaceFunction<int(int)> moved = std::move(function);
+        EXPECT_EQ(2, Counted::alive);
+        EXPECT_FALSE(function);
+        EXPECT_EQ(11, moved(1));
+
+        copy = twice;
+        EXPECT_EQ(1, Counted::alive);
+        EXPECT_EQ(8, copy(4));
+
+        moved.reset();
+        EXPECT_EQ(0, Counted::alive);
+        EXPECT_FALSE(moved);
+
+        copy = Counted(1);
+        EXPECT_EQ(1, Counted::alive);
+    }
+    EXPECT_EQ(0, Counted::alive);
+}
+
+TEST(InplaceFunction, construct_test_capacity)
+{
+    std::array<char, 64> big = {};
+    chesspp::InplaceFunction<size_t(), 64> function = [big]() { return big.size(); };
+    EXPECT_EQ(64, function());
+    EXPECT_EQ(64 + 2 * sizeof(void *), sizeof(function));
+}
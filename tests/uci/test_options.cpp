@@ -0,0 +1,184 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "uci/command/grammar.hpp"
+#include "uci/options.hpp"
+#include "uci/parser.hpp"
+
+namespace
+{
+/**
+ * @brief Parses the arguments of a `setoption` line and hands them to the
+ *        registry
+ *
+ */
+class SetOption
+{
+private:
+    chesspp::Command command = chesspp::grammar::setoption.to_command();
+    std::vector<std::string_view> tokens;
+    std::vector<chesspp::ArgumentView> arguments;
+
+public:
+    bool operator()(chesspp::OptionRegistry &registry, std::string_view line)
+    {
+        chesspp::Parser::tokenise(line, tokens);
+        if (not command.try_parse_arguments(tokens, arguments))
+        {
+            return false;
+        }
+        return registry.set(arguments);
+    }
+};
+
+std::string announce(chesspp::OptionRegistry const &registry)
+{
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink, 4096, std::chrono::hours(1));
+    registry.announce(output);
+    output.flush();
+    return sink.data;
+}
+} // namespace
+
+TEST(OptionRegistry, announce_test_every_type)
+{
+    chesspp::OptionRegistry registry;
+    registry.add_spin("Hash", 16, 1, 33554432);
+    registry.add_check("Ponder", false);
+    registry.add_combo("Style", "Normal", {"Solid", "Normal", "Risky"});
+    registry.add_button("Clear Hash", [] {});
+    registry.add_string("SyzygyPath", "");
+    registry.add_string("Book File", "book.bin");
+
+    EXPECT_EQ(6, registry.size());
+    EXPECT_EQ("option name Hash type spin default 16 min 1 max 33554432\n"
+              "option name Ponder type check default false\n"
+              "option name Style type combo default Normal var Solid var Normal var Risky\n"
+              "option name Clear Hash type button\n"
+              "option name SyzygyPath type string default <empty>\n"
+              "option name Book File type string default book.bin\n",
+              announce(registry));
+}
+
+TEST(OptionRegistry, add_test_refuses_bad_declarations)
+{
+    chesspp::OptionRegistry registry;
+    EXPECT_NE(nullptr, registry.add_spin("Hash", 16, 1, 1024));
+    EXPECT_EQ(nullptr, registry.add_check("hash", true));
+    EXPECT_EQ(nullptr, registry.add_spin("Threads", 0, 1, 512));
+    EXPECT_EQ(nullptr, registry.add_combo("Style", "Wild", {"Solid", "Risky"}));
+    EXPECT_EQ(1, registry.size());
+}
+
+TEST(OptionRegistry, set_test_spin)
+{
+    chesspp::OptionRegistry registry;
+    int changes = 0;
+    chesspp::SpinOption *hash = registry.add_spin("Hash", 16, 1, 1024, [&changes] { changes++; });
+    SetOption set;
+
+    EXPECT_TRUE(set(registry, "name Hash value 256"));
+    EXPECT_EQ(256, hash->get());
+    EXPECT_EQ(1, changes);
+
+    // Out of range, not a number, or not one token
+    EXPECT_FALSE(set(registry, "name Hash value 0"));
+    EXPECT_FALSE(set(registry, "name Hash value 2048"));
+    EXPECT_FALSE(set(registry, "name Hash value 12MB"));
+    EXPECT_FALSE(set(registry, "name Hash value 1 2"));
+    EXPECT_FALSE(set(registry, "name Hash"));
+    EXPECT_EQ(256, hash->get());
+    EXPECT_EQ(1, changes);
+}
+
+TEST(OptionRegistry, set_test_check_and_combo)
+{
+    chesspp::OptionRegistry registry;
+    chesspp::CheckOption *ponder = registry.add_check("Ponder", false);
+    chesspp::ComboOption *style = registry.add_combo("Style", "Normal", {"Solid", "Normal", "Risky"});
+    SetOption set;
+
+    EXPECT_TRUE(set(registry, "name Ponder value TRUE"));
+    EXPECT_TRUE(ponder->get());
+    EXPECT_FALSE(set(registry, "name Ponder value yes"));
+    EXPECT_TRUE(ponder->get());
+
+    EXPECT_TRUE(set(registry, "name Style value risky"));
+    EXPECT_EQ(2, style->get_index());
+    EXPECT_EQ("Risky", style->get());
+    EXPECT_FALSE(set(registry, "name Style value Wild"));
+    EXPECT_EQ("Risky", style->get());
+}
+
+TEST(OptionRegistry, set_test_names_ignore_case_and_match_every_word)
+{
+    chesspp::OptionRegistry registry;
+    int presses = 0;
+    registry.add_button("Clear Hash", [&presses] { presses++; });
+    registry.add_spin("Clear", 0, 0, 10);
+    SetOption set;
+
+    EXPECT_TRUE(set(registry, "name clear   HASH"));
+    EXPECT_EQ(1, presses);
+    EXPECT_FALSE(set(registry, "name Clear Hash value 1"));
+    EXPECT_FALSE(set(registry, "name Clear Hash Table"));
+    EXPECT_FALSE(set(registry, "name Hash"));
+    EXPECT_EQ(1, presses);
+
+    EXPECT_EQ(registry.find(" clear  hash "), registry.find("Clear Hash"));
+    EXPECT_NE(registry.find("Clear"), registry.find("Clear Hash"));
+    EXPECT_EQ(nullptr, registry.find(""));
+}
+
+TEST(OptionRegistry, set_test_string_keeps_old_values)
+{
+    chesspp::OptionRegistry registry;
+    chesspp::StringOption *path = registry.add_string("SyzygyPath", "");
+    SetOption set;
+
+    EXPECT_EQ("", path->get());
+    EXPECT_TRUE(set(registry, "name SyzygyPath value /tables/3-4-5  and 6"));
+    std::string_view const first = path->get();
+    EXPECT_EQ("/tables/3-4-5  and 6", first);
+
+    // A reader's view stays valid after the value changes
+    EXPECT_TRUE(set(registry, "name SyzygyPath value <empty>"));
+    EXPECT_EQ("", path->get());
+    EXPECT_EQ("/tables/3-4-5  and 6", first);
+}
+
+TEST(OptionRegistry, get_test_concurrent_readers)
+{
+    chesspp::OptionRegistry registry;
+    chesspp::SpinOption *threads = registry.add_spin("Threads", 1, 1, 1000);
+    chesspp::StringOption *path = registry.add_string("Path", "start");
+    std::atomic<bool> done{false};
+
+    std::thread reader([&] {
+        while (not done.load())
+        {
+            int64_t const value = threads->get();
+            EXPECT_TRUE(value >= 1 and value <= 1000);
+            std::string_view const text = path->get();
+            EXPECT_TRUE(text == "start" or text.substr(0, 4) == "path");
+        }
+    });
+
+    SetOption set;
+    for (int i = 1; i <= 1000; i++)
+    {
+        std::string const number = std::to_string(i);
+        EXPECT_TRUE(set(registry, "name Threads value " + number));
+        EXPECT_TRUE(set(registry, "name Path value path" + number));
+    }
+    done.store(true);
+    reader.join();
+
+    EXPECT_EQ(1000, threads->get());
+    EXPECT_EQ("path1000", path->get());
+}
@@ -58,4 +58,155 @@ TEST(Parser, tokenise_test_trailing_and_leading_white_space) {
     EXPECT_EQ("is", tokens[1]);
     EXPECT_EQ("a", tokens[2]);
     EXPECT_EQ("test", tokens[3]);
-}
\ No newline at end of file
+}
+
+/*******************************************************************************
+ *                   Test tokenise( ... ) with string views
+*******************************************************************************/
+
+TEST(Parser, tokenise_view_test_generic) {
+    std::string const input = " \t This   is a\ttest \t\t";
+    std::vector<std::string_view> tokens;
+    chesspp::Parser::tokenise(input, tokens);
+    EXPECT_EQ("This", tokens[0]);
+    EXPECT_EQ("is", tokens[1]);
+    EXPECT_EQ("a", tokens[2]);
+    EXPECT_EQ("test", tokens[3]);
+    EXPECT_EQ(4, tokens.size());
+}
+
+TEST(Parser, tokenise_view_test_points_into_input) {
+    std::string const input = "position startpos moves e2e4";
+    std::vector<std::string_view> tokens;
+    chesspp::Parser::tokenise(input, tokens);
+    EXPECT_EQ(input.data(), tokens[0].data());
+    EXPECT_EQ(input.data() + 24, tokens[3].data());
+}
+
+TEST(Parser, tokenise_view_test_reuses_storage) {
+    std::vector<std::string_view> tokens;
+    chesspp::Parser::tokenise("go wtime 1000 btime 1000 winc 10 binc 10", tokens);
+    std::string_view const *storage = tokens.data();
+
+    chesspp::Parser::tokenise("isready", tokens);
+    EXPECT_EQ("isready", tokens[0]);
+    EXPECT_EQ(1, tokens.size());
+    EXPECT_EQ(storage, tokens.data());
+}
+
+TEST(Parser, tokenise_view_test_empty) {
+    std::vector<std::string_view> tokens = {"stale"};
+    chesspp::Parser::tokenise(" \t\n ", tokens);
+    EXPECT_TRUE(tokens.empty());
+}
+
+
+/*******************************************************************************
+ *                 Test tokenise( ... ) with each tokeniser path
+*******************************************************************************/
+
+namespace
+{
+std::vector<chesspp::TokeniserPath> supported_paths()
+{
+    std::vector<chesspp::TokeniserPath> paths;
+    for (chesspp::TokeniserPath path : {chesspp::TokeniserPath::scalar,
+                                        chesspp::TokeniserPath::sse2,
+                                        chesspp::TokeniserPath::avx2})
+    {
+        if (chesspp::Parser::supports_tokeniser_path(path))
+        {
+            paths.push_back(path);
+        }
+    }
+    return paths;
+}
+} // namespace
+
+TEST(Parser, tokenise_path_test_white_space) {
+    std::vector<std::string> const inputs = {
+        "This is a test",
+        "This\tis a test",
+        "This   is  a test",
+        "This \t \t\t is \ta test",
+        "This is a test \t\t ",
+        " \t \t  This is a test",
+        " \t This is a test \t\t",
+        "This\nis\va\ftest\r\n"};
+
+    std::vector<std::string_view> tokens;
+    for (chesspp::TokeniserPath path : supported_paths())
+    {
+        for (std::string const &input : inputs)
+        {
+            chesspp::Parser::tokenise(input, tokens, path);
+            ASSERT_EQ(4, tokens.size()) << input;
+            EXPECT_EQ("This", tokens[0]);
+            EXPECT_EQ("is", tokens[1]);
+            EXPECT_EQ("a", tokens[2]);
+            EXPECT_EQ("test", tokens[3]);
+        }
+    }
+}
+
+TEST(Parser, tokenise_path_test_block_boundaries) {
+    // Tokens that start, end or span the 16 and 32 byte block boundaries the
+    // vectorised paths work with.
+    std::vector<std::string> inputs;
+    for (size_t length = 0; length < 70; length++)
+    {
+        std::string input(length, 'x');
+        for (size_t i = 0; i < length; i += 3 + i % 5)
+        {
+            input[i] = (i % 2) ? ' ' : '\t';
+        }
+        inputs.push_back(input);
+        inputs.push_back(" " + input);
+        inputs.push_back(input + "\n");
+    }
+
+    std::vector<std::string_view> expected;
+    std::vector<std::string_view> tokens;
+    for (std::string const &input : inputs)
+    {
+        chesspp::Parser::tokenise(input, expected, chesspp::TokeniserPath::scalar);
+        for (chesspp::TokeniserPath path : supported_paths())
+        {
+            chesspp::Parser::tokenise(input, tokens, path);
+            EXPECT_EQ(expected, tokens) << "\"" << input << "\"";
+        }
+    }
+}
+
+TEST(Parser, tokenise_path_test_long_move_list) {
+    std::string input = "position startpos moves";
+    for (int i = 0; i < 300; i++)
+    {
+        input += (i % 7 == 0) ? "  \t" : " ";
+        input += (i % 2 == 0) ? "e2e4" : "e7e8q";
+    }
+
+    std::vector<std::string_view> tokens;
+    for (chesspp::TokeniserPath path : supported_paths())
+    {
+        chesspp::Parser::tokenise(input, tokens, path);
+        ASSERT_EQ(303, tokens.size());
+        EXPECT_EQ("position", tokens[0]);
+        EXPECT_EQ("moves", tokens[2]);
+        EXPECT_EQ("e2e4", tokens[3]);
+        EXPECT_EQ("e7e8q", tokens[302]);
+    }
+}
+
+TEST(Parser, tokenise_path_test_non_ascii) {
+    // Bytes above 0x7f must not be mistaken for whitespace
+    std::string const input = "setoption name \xc3\xa9l\xc3\xa8ve value \xa0\x89";
+    std::vector<std::string_view> tokens;
+    for (chesspp::TokeniserPath path : supported_paths())
+    {
+        chesspp::Parser::tokenise(input, tokens, path);
+        ASSERT_EQ(5, tokens.size());
+        EXPECT_EQ("\xc3\xa9l\xc3\xa8ve", tokens[2]);
+        EXPECT_EQ("\xa0\x89", tokens[4]);
+    }
+}
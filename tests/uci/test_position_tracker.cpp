@@ -0,0 +1,124 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "uci/command/grammar.hpp"
+#include "uci/parser.hpp"
+#include "uci/position_tracker.hpp"
+
+namespace
+{
+/**
+ * @brief Parses the arguments of a position command and feeds them to a
+ *        tracker
+ *
+ */
+class TrackedPosition
+{
+private:
+    std::string line;
+    std::vector<std::string_view> tokens;
+    std::vector<chesspp::ArgumentView> arguments;
+
+public:
+    chesspp::PositionDelta update(chesspp::PositionTracker &tracker, std::string const &text)
+    {
+        line = text;
+        chesspp::Parser::tokenise(line, tokens);
+        chesspp::StaticCommand<chesspp::grammar::position>::parse_arguments(tokens, arguments);
+        return tracker.update(arguments);
+    }
+};
+
+std::vector<std::string> to_strings(chesspp::TokenSpan tokens)
+{
+    return std::vector<std::string>(tokens.begin(), tokens.end());
+}
+} // namespace
+
+TEST(PositionTracker, update_test_appended_moves)
+{
+    chesspp::PositionTracker tracker;
+    TrackedPosition position;
+
+    chesspp::PositionDelta delta = position.update(tracker, "startpos moves e2e4");
+    EXPECT_TRUE(delta.reset);
+    EXPECT_TRUE(delta.fen.empty());
+    EXPECT_EQ(std::vector<std::string>{"e2e4"}, to_strings(delta.moves));
+
+    delta = position.update(tracker, "startpos moves e2e4 e7e5 g1f3");
+    EXPECT_FALSE(delta.reset);
+    EXPECT_EQ((std::vector<std::string>{"e7e5", "g1f3"}), to_strings(delta.moves));
+
+    // Different whitespace is still the same game
+    delta = position.update(tracker, "startpos  moves e2e4\te7e5   g1f3 b8c6");
+    EXPECT_FALSE(delta.reset);
+    EXPECT_EQ(std::vector<std::string>{"b8c6"}, to_strings(delta.moves));
+
+    // Nothing new
+    delta = position.update(tracker, "startpos moves e2e4 e7e5 g1f3 b8c6");
+    EXPECT_FALSE(delta.reset);
+    EXPECT_TRUE(delta.moves.empty());
+}
+
+TEST(PositionTracker, update_test_first_moves_of_game)
+{
+    chesspp::PositionTracker tracker;
+    TrackedPosition position;
+
+    EXPECT_TRUE(position.update(tracker, "startpos").reset);
+
+    chesspp::PositionDelta const delta = position.update(tracker, "startpos moves d2d4");
+    EXPECT_FALSE(delta.reset);
+    EXPECT_EQ(std::vector<std::string>{"d2d4"}, to_strings(delta.moves));
+}
+
+TEST(PositionTracker, update_test_diverging_history_resets)
+{
+    chesspp::PositionTracker tracker;
+    TrackedPosition position;
+
+    position.update(tracker, "startpos moves e2e4 e7e5");
+
+    // Takeback
+    chesspp::PositionDelta delta = position.update(tracker, "startpos moves e2e4");
+    EXPECT_TRUE(delta.reset);
+    EXPECT_EQ(std::vector<std::string>{"e2e4"}, to_strings(delta.moves));
+
+    // Different move
+    delta = position.update(tracker, "startpos moves d2d4 d7d5");
+    EXPECT_TRUE(delta.reset);
+    EXPECT_EQ((std::vector<std::string>{"d2d4", "d7d5"}), to_strings(delta.moves));
+
+    // Longer move that shares a prefix
+    position.update(tracker, "startpos moves e7e8");
+    delta = position.update(tracker, "startpos moves e7e8q");
+    EXPECT_TRUE(delta.reset);
+}
+
+TEST(PositionTracker, update_test_new_fen_resets)
+{
+    chesspp::PositionTracker tracker;
+    TrackedPosition position;
+
+    position.update(tracker, "startpos moves e2e4");
+
+    std::string const fen = "fen rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1";
+    chesspp::PositionDelta delta = position.update(tracker, fen + " moves e7e5");
+    EXPECT_TRUE(delta.reset);
+    EXPECT_EQ(6, delta.fen.size());
+    EXPECT_EQ("b", delta.fen[1]);
+    EXPECT_EQ(std::vector<std::string>{"e7e5"}, to_strings(delta.moves));
+
+    delta = position.update(tracker, fen + " moves e7e5 g1f3");
+    EXPECT_FALSE(delta.reset);
+    EXPECT_EQ(std::vector<std::string>{"g1f3"}, to_strings(delta.moves));
+
+    delta = position.update(tracker, "fen 8/8/8/8/8/8/8/K6k w - - 0 1 moves e7e5 g1f3");
+    EXPECT_TRUE(delta.reset);
+
+    tracker.reset();
+    delta = position.update(tracker, "fen 8/8/8/8/8/8/8/K6k w - - 0 1 moves e7e5 g1f3");
+    EXPECT_TRUE(delta.reset);
+}
@@ -0,0 +1,196 @@
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "pipe_input.hpp"
+#include "uci/search_controller.hpp"
+
+namespace
+{
+using test_support::PipeInput;
+
+/**
+ * @brief A search that only ends when told to
+ *
+ */
+void search_until_stopped(chesspp::SearchController &controller)
+{
+    controller.start_search();
+    controller.report_pv("e2e4", "e7e5");
+    while (not controller.should_stop())
+    {
+        std::this_thread::yield();
+    }
+    EXPECT_TRUE(controller.bestmove("e2e4", "e7e5"));
+}
+
+/**
+ * @brief Waits for the watchdog to answer, for at most a few seconds
+ *
+ */
+void wait_for_fallback(chesspp::SearchController &controller)
+{
+    auto const give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (controller.get_fallbacks() == 0 and std::chrono::steady_clock::now() < give_up)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+} // namespace
+
+TEST(SearchController, bestmove_test_records_stop_latency)
+{
+    PipeInput input(
+        "ucinewgame\n"
+        "go infinite\n"
+        "stop\n"
+        "quit\n");
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink, 4096, std::chrono::hours(1));
+    chesspp::Engine engine(input.fd(), output);
+    chesspp::SearchController controller(engine);
+    engine.register_command("go", [&controller](chesspp::ArgumentSpan) {
+        search_until_stopped(controller);
+    });
+
+    engine.start();
+
+    EXPECT_EQ("bestmove e2e4 ponder e7e5\n", sink.data);
+    chesspp::HistogramSnapshot const latency = controller.get_game_latency();
+    EXPECT_EQ(1, latency.count);
+    EXPECT_GT(latency.max, 0);
+    EXPECT_LE(latency.percentile(0.99), latency.max);
+    EXPECT_EQ(1, controller.get_total_latency().count);
+    EXPECT_EQ(0, controller.get_fallbacks());
+}
+
+TEST(SearchController, ucinewgame_test_resets_game_latency)
+{
+    // Read in one go, so every command arrives while the first search runs
+    PipeInput input(
+        "go infinite\n"
+        "stop\n"
+        "ucinewgame\n"
+        "go infinite\n"
+        "stop\n"
+        "go infinite\n"
+        "stop\n"
+        "quit\n");
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink, 4096, std::chrono::hours(1));
+    chesspp::Engine engine(input.fd(), output);
+    chesspp::SearchController controller(engine);
+    engine.register_command("go", [&controller](chesspp::ArgumentSpan) {
+        search_until_stopped(controller);
+    });
+
+    engine.start();
+
+    EXPECT_EQ(2, controller.get_game_latency().count);
+    EXPECT_EQ(3, controller.get_total_latency().count);
+}
+
+TEST(SearchController, should_stop_test_stop_survives_next_go)
+{
+    // The second `go` is read while the first search runs
+    PipeInput input(
+        "go infinite\n"
+        "ponderhit\n"
+        "stop\n"
+        "go depth 1\n"
+        "quit\n");
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink, 4096, std::chrono::hours(1));
+    chesspp::Engine engine(input.fd(), output);
+    chesspp::SearchController controller(engine);
+    int searches = 0;
+    engine.register_command("go", [&controller, &searches](chesspp::ArgumentSpan) {
+        controller.start_search();
+        if (searches++ == 0)
+        {
+            auto const give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (not controller.should_stop() and std::chrono::steady_clock::now() < give_up)
+            {
+                std::this_thread::yield();
+            }
+            EXPECT_TRUE(controller.should_stop());
+            EXPECT_TRUE(controller.ponderhit_received());
+            EXPECT_TRUE(controller.bestmove("e2e4"));
+        }
+        else
+        {
+            EXPECT_FALSE(controller.should_stop());
+            EXPECT_FALSE(controller.ponderhit_received());
+            EXPECT_TRUE(controller.bestmove("d2d4"));
+        }
+    });
+
+    engine.start();
+
+    EXPECT_EQ("bestmove e2e4\nbestmove d2d4\n", sink.data);
+    EXPECT_EQ(1, controller.get_total_latency().count);
+}
+
+TEST(SearchController, fallback_test_answers_for_slow_search)
+{
+    PipeInput input(
+        "go infinite\n"
+        "stop\n"
+        "quit\n");
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink, 4096, std::chrono::hours(1));
+    chesspp::Engine engine(input.fd(), output);
+    chesspp::SearchController controller(engine, std::chrono::milliseconds(20));
+    engine.register_command("go", [&controller](chesspp::ArgumentSpan) {
+        controller.start_search();
+        controller.report_pv("g1f3", "d7d5");
+        controller.report_pv("d2d4", "d7d5");
+
+        // Too slow to notice the stop
+        wait_for_fallback(controller);
+        EXPECT_TRUE(controller.should_stop());
+        EXPECT_FALSE(controller.bestmove("c2c4"));
+    });
+
+    engine.start();
+
+    EXPECT_EQ("bestmove d2d4 ponder d7d5\n", sink.data);
+    EXPECT_EQ(1, controller.get_fallbacks());
+    EXPECT_GE(controller.get_total_latency().max, 20000000);
+}
+
+TEST(SearchController, set_deadline_test_answers_without_stop)
+{
+    PipeInput input(
+        "go wtime 1000 btime 1000\n"
+        "go wtime 1000 btime 1000\n"
+        "quit\n");
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink, 4096, std::chrono::hours(1));
+    chesspp::Engine engine(input.fd(), output);
+    chesspp::SearchController controller(engine, std::chrono::milliseconds(20));
+    int searches = 0;
+    engine.register_command("go", [&controller, &searches](chesspp::ArgumentSpan) {
+        controller.start_search();
+        EXPECT_FALSE(controller.should_stop());
+        if (searches++ == 0)
+        {
+            controller.report_pv("e2e4");
+            controller.set_deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(10));
+            wait_for_fallback(controller);
+            EXPECT_FALSE(controller.bestmove("d2d4"));
+        }
+        else
+        {
+            // The next search is not held up by the last one's deadline
+            EXPECT_TRUE(controller.bestmove("g1f3"));
+        }
+    });
+
+    engine.start();
+
+    EXPECT_EQ("bestmove e2e4\nbestmove g1f3\n", sink.data);
+    EXPECT_EQ(1, controller.get_fallbacks());
+    EXPECT_EQ(0, controller.get_total_latency().count);
+}
@@ -0,0 +1,135 @@
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "uci/command/grammar.hpp"
+#include "uci/parser.hpp"
+#include "uci/search_limits.hpp"
+
+static_assert(std::is_trivially_copyable_v<chesspp::SearchLimits>);
+
+namespace
+{
+/**
+ * @brief Parses and decodes the arguments of a go command
+ *
+ */
+class GoDecoder
+{
+private:
+    std::string line;
+    std::vector<std::string_view> tokens;
+    std::vector<chesspp::ArgumentView> arguments;
+
+public:
+    chesspp::DecodeResult decode(std::string const &text, chesspp::SearchLimits &limits)
+    {
+        line = text;
+        chesspp::Parser::tokenise(line, tokens);
+        chesspp::StaticCommand<chesspp::grammar::go>::parse_arguments(tokens, arguments);
+        return chesspp::decode_search_limits(arguments, limits);
+    }
+};
+} // namespace
+
+TEST(SearchLimits, decode_test_clock)
+{
+    GoDecoder decoder;
+    chesspp::SearchLimits limits;
+    ASSERT_TRUE(decoder.decode("wtime 300000 btime 299000 winc 2000 binc 2000 movestogo 40", limits));
+    EXPECT_EQ(300000, limits.wtime);
+    EXPECT_EQ(299000, limits.btime);
+    EXPECT_EQ(2000, limits.winc);
+    EXPECT_EQ(2000, limits.binc);
+    EXPECT_EQ(40, limits.movestogo);
+    EXPECT_FALSE(chesspp::SearchLimits::is_set(limits.depth));
+    EXPECT_FALSE(chesspp::SearchLimits::is_set(limits.movetime));
+    EXPECT_FALSE(limits.ponder);
+    EXPECT_FALSE(limits.infinite);
+    EXPECT_TRUE(limits.searchmoves.empty());
+}
+
+TEST(SearchLimits, decode_test_flags_and_limits)
+{
+    GoDecoder decoder;
+    chesspp::SearchLimits limits;
+    ASSERT_TRUE(decoder.decode("ponder depth 20 nodes 5000000000 mate 3 movetime 1000 infinite", limits));
+    EXPECT_TRUE(limits.ponder);
+    EXPECT_TRUE(limits.infinite);
+    EXPECT_EQ(20, limits.depth);
+    EXPECT_EQ(5000000000, limits.nodes);
+    EXPECT_EQ(3, limits.mate);
+    EXPECT_EQ(1000, limits.movetime);
+
+    // Negative times are passed on, some interfaces send them when the engine
+    // is out of time
+    ASSERT_TRUE(decoder.decode("wtime -50", limits));
+    EXPECT_EQ(-50, limits.wtime);
+    EXPECT_FALSE(limits.ponder);
+}
+
+TEST(SearchLimits, decode_test_searchmoves)
+{
+    GoDecoder decoder;
+    chesspp::SearchLimits limits;
+    ASSERT_TRUE(decoder.decode("searchmoves e2e4 d2d4 e7e8q wtime 1000", limits));
+    ASSERT_EQ(3, limits.searchmoves.size());
+    EXPECT_EQ("d2d4", limits.searchmoves.moves[1].to_uci());
+    EXPECT_EQ(chesspp::Promotion::queen, limits.searchmoves.moves[2].promotion());
+    EXPECT_EQ(1000, limits.wtime);
+}
+
+TEST(SearchLimits, decode_test_errors)
+{
+    GoDecoder decoder;
+    chesspp::SearchLimits limits;
+
+    chesspp::DecodeResult result = decoder.decode("wtime 12x", limits);
+    EXPECT_FALSE(result);
+    EXPECT_EQ(chesspp::DecodeError::malformed_number, result.error);
+    EXPECT_EQ("wtime", result.argument);
+
+    result = decoder.decode("depth 99999999999999999999", limits);
+    EXPECT_EQ(chesspp::DecodeError::malformed_number, result.error);
+
+    result = decoder.decode("btime 10 movetime +5", limits);
+    EXPECT_EQ(chesspp::DecodeError::malformed_number, result.error);
+    EXPECT_EQ("movetime", result.argument);
+
+    result = decoder.decode("searchmoves e2e4 e2", limits);
+    EXPECT_EQ(chesspp::DecodeError::malformed_move, result.error);
+    EXPECT_EQ("searchmoves", result.argument);
+}
+
+namespace
+{
+struct Custom
+{
+    int32_t level = 0;
+    bool fast = false;
+};
+
+constexpr auto custom_schema = chesspp::make_schema<Custom>({
+    chesspp::field<&Custom::level>("level"),
+    chesspp::field<&Custom::fast>("fast")});
+} // namespace
+
+TEST(ArgumentSchema, decode_test_custom_struct)
+{
+    std::vector<std::string_view> const level = {"7"};
+    std::vector<std::string_view> const too_big = {"3000000000"};
+    Custom custom;
+
+    ASSERT_TRUE(custom_schema.decode({{"level", level}, {"fast", {}}}, custom));
+    EXPECT_EQ(7, custom.level);
+    EXPECT_TRUE(custom.fast);
+
+    EXPECT_EQ(chesspp::DecodeError::malformed_number,
+              custom_schema.decode({{"level", too_big}}, custom).error);
+    EXPECT_EQ(chesspp::DecodeError::wrong_parameter_count,
+              custom_schema.decode({{"fast", level}}, custom).error);
+    EXPECT_EQ(chesspp::DecodeError::unknown_argument,
+              custom_schema.decode({{"slow", {}}}, custom).error);
+}
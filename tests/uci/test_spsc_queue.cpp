@@ -0,0 +1,57 @@
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "uci/spsc_queue.hpp"
+
+TEST(SpscQueue, test_full_and_empty)
+{
+    chesspp::SpscQueue<int, 2> queue;
+    EXPECT_EQ(nullptr, queue.front());
+
+    *queue.acquire() = 1;
+    queue.publish();
+    *queue.acquire() = 2;
+    queue.publish();
+    EXPECT_EQ(nullptr, queue.acquire());
+
+    EXPECT_EQ(1, *queue.front());
+    queue.release();
+    EXPECT_EQ(2, *queue.front());
+    queue.release();
+    EXPECT_EQ(nullptr, queue.front());
+}
+
+TEST(SpscQueue, test_two_threads_keep_order)
+{
+    constexpr int count = 100000;
+    chesspp::SpscQueue<int, 8> queue;
+
+    std::thread producer([&queue]() {
+        for (int i = 0; i < count; i++)
+        {
+            int *slot;
+            while ((slot = queue.acquire()) == nullptr)
+            {
+                std::this_thread::yield();
+            }
+            *slot = i;
+            queue.publish();
+        }
+    });
+
+    int expected = 0;
+    while (expected < count)
+    {
+        if (int *item = queue.front())
+        {
+            EXPECT_EQ(expected, *item);
+            queue.release();
+            expected++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
@@ -0,0 +1,224 @@
+#include <chrono>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "uci/time_manager.hpp"
+
+namespace
+{
+using Clock = chesspp::TimeManager::Clock;
+using std::chrono::milliseconds;
+
+/**
+ * @brief A clock that only moves when told to
+ *
+ */
+struct FakeClock
+{
+    Clock::time_point time = Clock::time_point(std::chrono::hours(1));
+
+    chesspp::TimeManager::ClockFunction function()
+    {
+        return [this]() { return time; };
+    }
+};
+
+chesspp::SearchLimits clock_limits(int64_t wtime, int64_t btime, int64_t winc = 0, int64_t binc = 0)
+{
+    chesspp::SearchLimits limits;
+    limits.wtime = wtime;
+    limits.btime = btime;
+    limits.winc = winc;
+    limits.binc = binc;
+    return limits;
+}
+} // namespace
+
+TEST(TimeManager, allocate_test_sudden_death)
+{
+    FakeClock clock;
+    chesspp::TimeManager manager(chesspp::TimeSettings(), clock.function());
+    chesspp::TimeBudget const budget = manager.allocate(clock_limits(60000, 1000), false);
+
+    // (60000 - 50) / 30 - 10, and 4 times that
+    ASSERT_TRUE(budget.is_limited());
+    EXPECT_EQ(clock.time, budget.start);
+    EXPECT_EQ(clock.time + milliseconds(1988), budget.soft);
+    EXPECT_EQ(clock.time + milliseconds(7952), budget.hard);
+}
+
+TEST(TimeManager, allocate_test_increment_for_black)
+{
+    FakeClock clock;
+    chesspp::TimeManager manager(chesspp::TimeSettings(), clock.function());
+    chesspp::TimeBudget const budget = manager.allocate(clock_limits(600000, 10000, 0, 1000), true);
+
+    // (10000 - 50 + 29 * 1000) / 30 - 10, with the hard limit capped at half
+    // of what is left
+    EXPECT_EQ(clock.time + milliseconds(1288), budget.soft);
+    EXPECT_EQ(clock.time + milliseconds(4970), budget.hard);
+}
+
+TEST(TimeManager, allocate_test_movestogo)
+{
+    FakeClock clock;
+    chesspp::TimeManager manager(chesspp::TimeSettings(), clock.function());
+    chesspp::SearchLimits limits = clock_limits(1000, 1000);
+    limits.movestogo = 1;
+    chesspp::TimeBudget budget = manager.allocate(limits, false);
+
+    // The last move before the time control may use everything but the margin
+    EXPECT_EQ(clock.time + milliseconds(940), budget.soft);
+    EXPECT_EQ(clock.time + milliseconds(940), budget.hard);
+
+    // More moves than the maximum are shared as the maximum
+    limits.wtime = 50550;
+    limits.movestogo = 1000;
+    budget = manager.allocate(limits, false);
+    EXPECT_EQ(clock.time + milliseconds(1000), budget.soft);
+}
+
+TEST(TimeManager, allocate_test_movetime)
+{
+    FakeClock clock;
+    chesspp::TimeManager manager(chesspp::TimeSettings(), clock.function());
+    chesspp::SearchLimits limits;
+    limits.movetime = 1000;
+    chesspp::TimeBudget budget = manager.allocate(limits, false);
+    EXPECT_EQ(clock.time + milliseconds(990), budget.soft);
+    EXPECT_EQ(clock.time + milliseconds(990), budget.hard);
+
+    // Caps the clock's budget
+    limits = clock_limits(60000, 60000);
+    limits.movetime = 3000;
+    budget = manager.allocate(limits, false);
+    EXPECT_EQ(clock.time + milliseconds(1988), budget.soft);
+    EXPECT_EQ(clock.time + milliseconds(2990), budget.hard);
+}
+
+TEST(TimeManager, allocate_test_out_of_time)
+{
+    FakeClock clock;
+    chesspp::TimeManager manager(chesspp::TimeSettings(), clock.function());
+    chesspp::TimeBudget const budget = manager.allocate(clock_limits(30, 30), false);
+    ASSERT_TRUE(budget.is_limited());
+    EXPECT_EQ(clock.time, budget.soft);
+    EXPECT_EQ(clock.time, budget.hard);
+    EXPECT_TRUE(manager.hard_limit_reached(budget));
+}
+
+TEST(TimeManager, allocate_test_unlimited)
+{
+    FakeClock clock;
+    chesspp::TimeManager manager(chesspp::TimeSettings(), clock.function());
+    chesspp::SearchLimits limits;
+    limits.depth = 20;
+    EXPECT_FALSE(manager.allocate(limits, false).is_limited());
+
+    limits = clock_limits(60000, 60000);
+    limits.infinite = true;
+    EXPECT_FALSE(manager.allocate(limits, false).is_limited());
+    EXPECT_FALSE(manager.ponderhit(limits, false).is_limited());
+
+    limits.infinite = false;
+    limits.ponder = true;
+    chesspp::TimeBudget budget = manager.allocate(limits, false);
+    EXPECT_FALSE(budget.is_limited());
+    EXPECT_FALSE(manager.should_stop(budget, chesspp::Iteration()));
+    EXPECT_FALSE(manager.hard_limit_reached(budget));
+
+    // The clock starts at ponderhit
+    clock.time += milliseconds(5000);
+    budget = manager.ponderhit(limits, false);
+    EXPECT_EQ(clock.time + milliseconds(1988), budget.soft);
+}
+
+TEST(TimeManager, should_stop_test_instability_extension)
+{
+    FakeClock clock;
+    chesspp::TimeManager manager(chesspp::TimeSettings(), clock.function());
+    manager.add_extension(chesspp::TimeManager::instability_extension(0.5));
+    chesspp::TimeBudget const budget = manager.allocate(clock_limits(60000, 60000), false);
+
+    chesspp::Iteration stable;
+    stable.depth = 12;
+    chesspp::Iteration unstable = stable;
+    unstable.best_move_changes = 2;
+    EXPECT_EQ(budget.soft, manager.soft_deadline(budget, stable));
+    EXPECT_EQ(budget.start + milliseconds(3976), manager.soft_deadline(budget, unstable));
+
+    clock.time += milliseconds(2000);
+    EXPECT_TRUE(manager.should_stop(budget, stable));
+    EXPECT_FALSE(manager.should_stop(budget, unstable));
+    EXPECT_FALSE(manager.hard_limit_reached(budget));
+
+    // Never past the hard limit
+    unstable.best_move_changes = 100;
+    EXPECT_EQ(budget.hard, manager.soft_deadline(budget, unstable));
+    clock.time = budget.hard;
+    EXPECT_TRUE(manager.should_stop(budget, unstable));
+    EXPECT_TRUE(manager.hard_limit_reached(budget));
+}
+
+TEST(TimeManager, extension_test_factors_multiply)
+{
+    chesspp::TimeManager manager;
+    EXPECT_EQ(1.0, manager.extension(chesspp::Iteration()));
+    manager.add_extension([](chesspp::Iteration const &iteration) {
+        return iteration.score_drop > 50 ? 1.5 : 1.0;
+    });
+    manager.add_extension(chesspp::TimeManager::instability_extension(1.0));
+    chesspp::Iteration iteration;
+    iteration.best_move_changes = 1;
+    iteration.score_drop = 80;
+    EXPECT_EQ(3.0, manager.extension(iteration));
+}
+
+TEST(TimeManager, measured_overhead_test)
+{
+    chesspp::StatsSnapshot stats;
+    EXPECT_EQ(milliseconds(0), chesspp::TimeManager::measured_overhead(stats));
+
+    stats.dispatch.counts[chesspp::histogram::bucket(1500000)] = 1;
+    stats.dispatch.count = 1;
+    stats.dispatch.sum = 1500000;
+    stats.dispatch.max = 1500000;
+    EXPECT_EQ(milliseconds(2), chesspp::TimeManager::measured_overhead(stats));
+
+    chesspp::TimeManager manager;
+    manager.set_overhead(chesspp::TimeManager::measured_overhead(stats));
+    EXPECT_EQ(milliseconds(2), manager.get_settings().overhead);
+}
+
+TEST(TimeManager, simulation_test_never_loses_on_time)
+{
+    FakeClock clock;
+    chesspp::TimeManager manager(chesspp::TimeSettings(), clock.function());
+    manager.add_extension(chesspp::TimeManager::instability_extension());
+    int64_t const overhead = manager.get_settings().overhead.count();
+    int64_t const safety_margin = manager.get_settings().safety_margin.count();
+    uint64_t random = 1;
+
+    // 10 seconds plus 0.1 per move, for a thousand games of 120 moves each
+    for (int game = 0; game < 1000; game++)
+    {
+        int64_t remaining = 10000;
+        for (int move = 0; move < 120; move++)
+        {
+            random = random * 6364136223846793005 + 1442695040888963407;
+            chesspp::Iteration iteration;
+            iteration.best_move_changes = (random >> 33) % 4;
+            int64_t const lost = static_cast<int64_t>((random >> 40) % (overhead + 1));
+
+            chesspp::TimeBudget const budget = manager.allocate(clock_limits(remaining, remaining, 100, 100), false);
+            ASSERT_TRUE(budget.is_limited());
+            clock.time = manager.soft_deadline(budget, iteration);
+            ASSERT_LE(clock.time, budget.hard);
+
+            remaining -= std::chrono::duration_cast<milliseconds>(clock.time - budget.start).count() + lost;
+            ASSERT_GE(remaining, safety_margin) << "game " << game << " move " << move;
+            remaining += 100;
+        }
+        EXPECT_LT(remaining, 10000);
+    }
+}
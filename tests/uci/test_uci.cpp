@@ -0,0 +1,105 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "chesspp/uci.hpp"
+#include "uci/io/output_writer.hpp"
+#include "uci/replay/log.hpp"
+
+namespace
+{
+/**
+ * @brief Makes a pipe holding `text` that is closed for writing
+ *
+ * @return int The read end
+ */
+int make_input(std::string const &text)
+{
+    int fds[2];
+    EXPECT_EQ(0, pipe(fds));
+    EXPECT_EQ(text.size(), write(fds[1], text.data(), text.size()));
+    close(fds[1]);
+    return fds[0];
+}
+} // namespace
+
+TEST(UCI, start_test_runs_registered_callbacks)
+{
+    int const fd = make_input("debug on\nisready\nquit\nisready\n");
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::UCI uci(fd, output);
+
+    std::string debug;
+    EXPECT_TRUE(uci.register_command("debug", [&debug](chesspp::ArgumentSpan arguments) {
+        debug = std::string(arguments[0].value);
+    }));
+    EXPECT_TRUE(uci.register_command("isready", [&uci](chesspp::ArgumentSpan) {
+        uci.issue_command("readyok", {});
+    }));
+    EXPECT_FALSE(uci.register_command("joho", [](chesspp::ArgumentSpan) {}));
+
+    EXPECT_FALSE(uci.start("interface"));
+    EXPECT_TRUE(uci.start("engine"));
+    close(fd);
+
+    EXPECT_EQ("on", debug);
+    EXPECT_EQ("readyok\n", sink.data);
+}
+
+TEST(UCI, issue_command_test_checks_grammar)
+{
+    int const fd = make_input("");
+    chesspp::StringSink sink;
+    chesspp::OutputWriter output(sink);
+    chesspp::UCI uci(fd, output);
+
+    EXPECT_TRUE(uci.issue_command("bestmove", {"e2e4", "ponder", "e7e5"}));
+    EXPECT_TRUE(uci.issue_command("debug", {"on"}));
+    EXPECT_FALSE(uci.issue_command("bestmove", {}));
+    EXPECT_FALSE(uci.issue_command("debug", {"maybe"}));
+    EXPECT_FALSE(uci.issue_command("joho", {}));
+    output.flush();
+    close(fd);
+
+    EXPECT_EQ("bestmove e2e4 ponder e7e5\ndebug on\n", sink.data);
+}
+
+TEST(UCI, record_to_test_writes_session_log)
+{
+    std::string const path = testing::TempDir() + "chesspp_session.log";
+    int const fd = make_input("isready\nquit\n");
+    {
+        chesspp::StringSink sink;
+        chesspp::OutputWriter output(sink);
+        chesspp::UCI uci(fd, output);
+        EXPECT_FALSE(uci.record_to("/nonexistent/directory/session.log"));
+        ASSERT_TRUE(uci.record_to(path));
+        uci.register_command("isready", [&uci](chesspp::ArgumentSpan) {
+            uci.issue_command("readyok", {});
+        });
+        EXPECT_TRUE(uci.start());
+    }
+    close(fd);
+
+    std::ifstream file(path, std::ios::binary);
+    std::string const log((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::remove(path.c_str());
+
+    chesspp::LogReader reader(log);
+    chesspp::LogRecord record;
+    int received = 0;
+    int sent = 0;
+    while (reader.next(record))
+    {
+        (record.direction == chesspp::Direction::to_engine ? received : sent)++;
+    }
+    EXPECT_FALSE(reader.is_malformed());
+    EXPECT_EQ(2, received);
+    EXPECT_EQ(1, sent);
+}
@@ -0,0 +1,197 @@
+/**
+ * @file main.cpp
+ * @brief chesspp-batch: analyses every position of an EPD or FEN file on a
+ *        pool of local engines
+ *
+ * Usage:
+ *
+ *     chesspp-batch [--engines <count>] [--depth <plies> | --go "<arguments>"]
+ *                   [--pipeline <searches>] [--output <file>]
+ *                   <positions> <engine>
+ *
+ * `<engine>` is a shell command, started `--engines` times (4 by default).
+ * Each position is searched with `go depth 10` unless `--depth` or `--go`
+ * say otherwise. A tab separated line is written for each position as soon
+ * as it is analysed (see chesspp::append_result), to stdout or to the output
+ * file, and positions per second and the utilisation of each engine are
+ * reported on stderr.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "uci/interface/batch.hpp"
+#include "uci/interface/epd.hpp"
+#include "uci/io/mapped_file.hpp"
+#include "uci/io/output_writer.hpp"
+#include "uci/parser.hpp"
+
+namespace
+{
+struct Options
+{
+    std::string positions_path;
+    std::string engine;
+    std::string output_path;
+    size_t engines = 4;
+    chesspp::BatchOptions batch;
+};
+
+void usage()
+{
+    std::fprintf(stderr,
+                 "usage: chesspp-batch [--engines <count>] [--depth <plies> | --go \"<arguments>\"]\n"
+                 "                     [--pipeline <searches>] [--output <file>]\n"
+                 "                     <positions> <engine>\n");
+}
+
+/**
+ * @brief Parses a positive whole number
+ *
+ */
+bool parse_count(char const *text, size_t &count)
+{
+    char *end = nullptr;
+    unsigned long const value = std::strtoul(text, &end, 10);
+    if (*text == '\0' or *end != '\0' or value == 0)
+    {
+        return false;
+    }
+    count = value;
+    return true;
+}
+
+bool parse_options(int argc, char **argv, Options &options)
+{
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view const argument = argv[i];
+        bool const has_value = i + 1 < argc;
+        if (argument == "--engines" and has_value)
+        {
+            if (not parse_count(argv[++i], options.engines))
+            {
+                return false;
+            }
+        }
+        else if (argument == "--pipeline" and has_value)
+        {
+            if (not parse_count(argv[++i], options.batch.pipeline_depth))
+            {
+                return false;
+            }
+        }
+        else if (argument == "--depth" and has_value)
+        {
+            size_t depth;
+            if (not parse_count(argv[++i], depth))
+            {
+                return false;
+            }
+            options.batch.go_arguments = {"depth", std::to_string(depth)};
+        }
+        else if (argument == "--go" and has_value)
+        {
+            options.batch.go_arguments = chesspp::Parser::tokenise(argv[++i]);
+        }
+        else if (argument == "--output" and has_value)
+        {
+            options.output_path = argv[++i];
+        }
+        else if (argument.substr(0, 2) == "--")
+        {
+            return false;
+        }
+        else
+        {
+            positional.emplace_back(argument);
+        }
+    }
+
+    if (positional.size() != 2)
+    {
+        return false;
+    }
+    options.positions_path = positional[0];
+    options.engine = positional[1];
+    options.batch.engines.assign(options.engines, options.engine);
+    return true;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (not parse_options(argc, argv, options))
+    {
+        usage();
+        return 2;
+    }
+
+    chesspp::MappedFile const file(options.positions_path);
+    if (not file.is_open())
+    {
+        std::fprintf(stderr, "chesspp-batch: could not read %s\n", options.positions_path.c_str());
+        return 1;
+    }
+
+    int output_fd = STDOUT_FILENO;
+    if (not options.output_path.empty())
+    {
+        output_fd = open(options.output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (output_fd == -1)
+        {
+            std::fprintf(stderr, "chesspp-batch: could not write %s\n", options.output_path.c_str());
+            return 1;
+        }
+    }
+    chesspp::FdSink sink(output_fd);
+
+    // Reused for every line. A write per result is cheap next to a search,
+    // and lets the results be followed while the batch runs.
+    std::string buffer;
+
+    chesspp::EpdReader positions(file.data());
+    chesspp::Batch batch(options.batch);
+    bool const finished = batch.run(positions, [&buffer, &sink](chesspp::BatchResult const &result) {
+        buffer.clear();
+        chesspp::append_result(buffer, result);
+        sink.write(buffer);
+    });
+    if (output_fd != STDOUT_FILENO)
+    {
+        close(output_fd);
+    }
+
+    chesspp::BatchReport const &report = batch.get_report();
+    std::fprintf(stderr, "%llu positions in %.3fs, %.1f positions/s\n",
+                 static_cast<unsigned long long>(report.positions), report.seconds,
+                 report.positions_per_second());
+    for (size_t i = 0; i < report.engines.size(); i++)
+    {
+        chesspp::EngineUsage const &usage = report.engines[i];
+        std::fprintf(stderr, "  engine %zu: %llu positions, %llu stolen, %.1f%% busy\n", i + 1,
+                     static_cast<unsigned long long>(usage.positions),
+                     static_cast<unsigned long long>(usage.stolen),
+                     100 * report.utilisation(i));
+    }
+    if (positions.get_malformed() != 0)
+    {
+        std::fprintf(stderr, "chesspp-batch: skipped %zu lines that are not positions\n",
+                     positions.get_malformed());
+    }
+    if (not finished)
+    {
+        std::fprintf(stderr, "chesspp-batch: %llu positions were not analysed\n",
+                     static_cast<unsigned long long>(report.unanalysed));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,432 @@
+/**
+ * @file main.cpp
+ * @brief chesspp-replay: plays a recorded session back against local engines
+ *        and compares how quickly they respond
+ *
+ * Usage:
+ *
+ *     chesspp-replay [--speed original|max|<factor>] [--timeout <seconds>]
+ *                    <log> <engine> [<engine>]
+ *
+ * The lines the interface sent are fed to each engine in turn, over pipes.
+ * With `original` they are sent with the recorded timing, with a factor the
+ * timing is scaled (2 plays twice as fast), and with `max` they are sent as
+ * fast as the engine answers. Whatever the speed, a line is never sent before
+ * the engine has given as many `uciok`/`readyok`/`bestmove` responses as it
+ * had in the recording, so the session stays causally the same.
+ *
+ * The latency of each exchange (eg. `isready` to `readyok`, `stop` to
+ * `bestmove`) is reported for the recording and for each engine, and the last
+ * engine is compared against the one before it, or against the recording.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "uci/io/line_reader.hpp"
+#include "uci/io/subprocess.hpp"
+#include "uci/replay/latency.hpp"
+#include "uci/replay/log.hpp"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct Options
+{
+    std::string log_path;
+    std::vector<std::string> engines;
+
+    /**
+     * @brief How much faster than recorded to play, 0 for as fast as possible
+     *
+     */
+    double speed = 1.0;
+
+    /**
+     * @brief How long to wait for a response before moving on
+     *
+     */
+    Clock::duration timeout = std::chrono::seconds(10);
+};
+
+void usage()
+{
+    std::fprintf(stderr,
+                 "usage: chesspp-replay [--speed original|max|<factor>] [--timeout <seconds>]\n"
+                 "                      <log> <engine> [<engine>]\n");
+}
+
+bool parse_options(int argc, char **argv, Options &options)
+{
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view const argument = argv[i];
+        if ((argument == "--speed" or argument == "--timeout") and i + 1 < argc)
+        {
+            std::string_view const value = argv[++i];
+            char *end = nullptr;
+            double const number = std::strtod(argv[i], &end);
+            if (argument == "--timeout")
+            {
+                if (*end != '\0' or number <= 0)
+                {
+                    return false;
+                }
+                options.timeout = std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>(number));
+            }
+            else if (value == "original")
+            {
+                options.speed = 1.0;
+            }
+            else if (value == "max")
+            {
+                options.speed = 0.0;
+            }
+            else if (*end == '\0' and number > 0)
+            {
+                options.speed = number;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        else if (argument.substr(0, 2) == "--")
+        {
+            return false;
+        }
+        else
+        {
+            positional.emplace_back(argument);
+        }
+    }
+
+    if (positional.size() < 2 or positional.size() > 3)
+    {
+        return false;
+    }
+    options.log_path = positional[0];
+    options.engines.assign(positional.begin() + 1, positional.end());
+    return true;
+}
+
+/**
+ * @brief A line the interface sent
+ *
+ */
+struct Request
+{
+    /**
+     * @brief When it was sent, in nanoseconds since the recording started
+     *
+     */
+    uint64_t time;
+
+    std::string_view line;
+
+    /**
+     * @brief The number of responses the engine had given before it
+     *
+     */
+    size_t responses_before;
+};
+
+/**
+ * @brief Plays the requests of a session to one engine and measures its
+ *        responses
+ *
+ */
+class Replay
+{
+private:
+    chesspp::Subprocess engine;
+
+    std::mutex mutex;
+    std::condition_variable responded;
+
+    /**
+     * @brief The number of responses received so far
+     *
+     */
+    size_t responses = 0;
+
+    /**
+     * @brief Set once the engine's output is closed
+     *
+     */
+    bool closed = false;
+
+    Clock::time_point start;
+    chesspp::ResponseMatcher matcher;
+    chesspp::LatencySummary summary;
+
+    /**
+     * @brief Follows a line in either direction. The caller holds `mutex`.
+     *
+     */
+    void observe(chesspp::Direction direction, std::string_view line, Clock::time_point time)
+    {
+        chesspp::LatencySample sample;
+        uint64_t const nanoseconds =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(time - start).count();
+        if (matcher.observe(nanoseconds, direction, line, sample))
+        {
+            summary.add(sample);
+        }
+    }
+
+    /**
+     * @brief The body of the thread that reads the engine's output
+     *
+     */
+    void read_output()
+    {
+        chesspp::LineReader reader(engine.output());
+        std::string_view line;
+        while (reader.next_line(line))
+        {
+            Clock::time_point const now = Clock::now();
+            std::lock_guard<std::mutex> lock(mutex);
+            observe(chesspp::Direction::to_interface, line, now);
+            if (chesspp::ResponseMatcher::is_response(line))
+            {
+                responses++;
+                responded.notify_all();
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        responded.notify_all();
+    }
+
+public:
+    /**
+     * @brief The number of times the engine did not respond in time
+     *
+     */
+    size_t timeouts = 0;
+
+    /**
+     * @brief Runs the engine and plays the requests to it
+     *
+     * @return false If the engine could not be started
+     */
+    bool run(std::string const &command, std::vector<Request> const &requests, Options const &options)
+    {
+        if (not engine.spawn(command))
+        {
+            return false;
+        }
+        start = Clock::now();
+        std::thread reader(&Replay::read_output, this);
+
+        std::string buffer;
+        for (Request const &request : requests)
+        {
+            if (options.speed > 0)
+            {
+                std::this_thread::sleep_until(
+                    start + std::chrono::duration_cast<Clock::duration>(
+                                std::chrono::nanoseconds(request.time) / options.speed));
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            if (not responded.wait_for(lock, options.timeout, [this, &request]() {
+                    return responses >= request.responses_before or closed;
+                }))
+            {
+                timeouts++;
+            }
+            if (closed)
+            {
+                break;
+            }
+            observe(chesspp::Direction::to_engine, request.line, Clock::now());
+            lock.unlock();
+
+            buffer.assign(request.line);
+            buffer.push_back('\n');
+            if (write(engine.input(), buffer.data(), buffer.size()) != static_cast<ssize_t>(buffer.size()))
+            {
+                break;
+            }
+        }
+
+        // Give the engine a chance to answer the last request and exit on its
+        // own, eg. after `quit`
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            responded.wait_for(lock, options.timeout, [this, &requests]() {
+                return closed or (not requests.empty() and responses >= requests.back().responses_before);
+            });
+        }
+        engine.close_input();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (not responded.wait_for(lock, options.timeout, [this]() { return closed; }))
+            {
+                lock.unlock();
+                // Only the signal, the reader is still using the pipe
+                engine.terminate();
+            }
+        }
+        reader.join();
+        engine.wait();
+        return true;
+    }
+
+    chesspp::LatencySummary const &get_summary() const
+    {
+        return summary;
+    }
+};
+
+double milliseconds(uint64_t nanoseconds)
+{
+    return static_cast<double>(nanoseconds) / 1e6;
+}
+
+void print_row(std::string const &label, chesspp::LatencySummary const &summary, chesspp::Exchange exchange)
+{
+    std::printf("  %-12s n=%-5zu mean %9.3fms  p50 %9.3fms  p90 %9.3fms  p99 %9.3fms  max %9.3fms\n",
+                label.c_str(), summary.count(exchange),
+                milliseconds(summary.mean(exchange)),
+                milliseconds(summary.percentile(exchange, 0.5)),
+                milliseconds(summary.percentile(exchange, 0.9)),
+                milliseconds(summary.percentile(exchange, 0.99)),
+                milliseconds(summary.percentile(exchange, 1.0)));
+}
+
+void print_difference(
+    std::string const &label,
+    chesspp::LatencySummary const &baseline,
+    chesspp::LatencySummary const &candidate,
+    chesspp::Exchange exchange)
+{
+    std::printf("  %-12s", label.c_str());
+    for (double const quantile : {0.5, 0.9, 0.99})
+    {
+        double const before = milliseconds(baseline.percentile(exchange, quantile));
+        double const after = milliseconds(candidate.percentile(exchange, quantile));
+        std::printf("  p%-2d %+9.3fms", static_cast<int>(quantile * 100), after - before);
+        if (before > 0)
+        {
+            std::printf(" (%+6.1f%%)", (after - before) / before * 100);
+        }
+    }
+    std::printf("\n");
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (not parse_options(argc, argv, options))
+    {
+        usage();
+        return 2;
+    }
+
+    // A dead engine must not take the replay down with it
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::ifstream file(options.log_path, std::ios::binary);
+    if (not file.is_open())
+    {
+        std::fprintf(stderr, "chesspp-replay: could not read %s\n", options.log_path.c_str());
+        return 1;
+    }
+    std::string const log((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // Split the recording into requests, and measure the recorded engine
+    chesspp::LogReader reader(log);
+    chesspp::LogRecord record;
+    chesspp::ResponseMatcher matcher;
+    chesspp::LatencySummary recorded;
+    std::vector<Request> requests;
+    size_t responses = 0;
+    while (reader.next(record))
+    {
+        chesspp::LatencySample sample;
+        if (matcher.observe(record.time, record.direction, record.line, sample))
+        {
+            recorded.add(sample);
+        }
+        if (record.direction == chesspp::Direction::to_engine)
+        {
+            requests.push_back(Request{record.time, record.line, responses});
+        }
+        else if (chesspp::ResponseMatcher::is_response(record.line))
+        {
+            responses++;
+        }
+    }
+    if (reader.is_malformed())
+    {
+        std::fprintf(stderr, "chesspp-replay: %s is not a complete session log, replaying what could be read\n",
+                     options.log_path.c_str());
+    }
+
+    std::vector<chesspp::LatencySummary> results;
+    for (size_t i = 0; i < options.engines.size(); i++)
+    {
+        Replay replay;
+        if (not replay.run(options.engines[i], requests, options))
+        {
+            std::fprintf(stderr, "chesspp-replay: could not start %s\n", options.engines[i].c_str());
+            return 1;
+        }
+        if (replay.timeouts != 0)
+        {
+            std::fprintf(stderr, "chesspp-replay: engine %zu did not respond in time %zu times\n",
+                         i + 1, replay.timeouts);
+        }
+        results.push_back(replay.get_summary());
+    }
+
+    std::printf("%zu requests replayed\n", requests.size());
+    for (size_t e = 0; e < chesspp::num_exchanges; e++)
+    {
+        chesspp::Exchange const exchange = static_cast<chesspp::Exchange>(e);
+        bool any = recorded.count(exchange) != 0;
+        for (chesspp::LatencySummary const &result : results)
+        {
+            any = any or result.count(exchange) != 0;
+        }
+        if (not any)
+        {
+            continue;
+        }
+
+        std::printf("%s\n", std::string(chesspp::exchange_name(exchange)).c_str());
+        print_row("recorded", recorded, exchange);
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            print_row("engine " + std::to_string(i + 1), results[i], exchange);
+        }
+        if (results.size() == 2)
+        {
+            print_difference("2 vs 1", results[0], results[1], exchange);
+        }
+        else
+        {
+            print_difference("1 vs rec.", recorded, results[0], exchange);
+        }
+    }
+    return 0;
+}